@@ -79,8 +79,10 @@ struct Span {
   unsigned      hw_sector_size = DEFAULT_HW_SECTOR_SIZE;
   unsigned      alignment      = 0;
   span_diskid_t disk_id;
-  int           forced_volume_num = -1;    ///< Force span in to specific volume.
-  bool          file_pathname     = false; // the pathname is a file
+  int           forced_volume_num     = -1;    ///< Force span in to specific volume.
+  int           agg_write_size        = 0;     ///< Aggregation write size of the stripes, 0 for the default.
+  int           agg_write_queue_depth = 0;     ///< Aggregation buffers per stripe, 0 for the default.
+  bool          file_pathname         = false; // the pathname is a file
   // v- used as a magic location for copy constructor.
   // we memcpy everything before this member and do explicit assignment for the rest.
   ats_scoped_str pathname;
@@ -166,6 +168,8 @@ struct Store {
   /// Additional configuration key values.
   static const char VOLUME_KEY[];
   static const char HASH_BASE_STRING_KEY[];
+  static const char AGG_WRITE_SIZE_KEY[];
+  static const char AGG_QUEUE_DEPTH_KEY[];
 };
 
 // store either free or in the cache, can be stolen for reconfiguration
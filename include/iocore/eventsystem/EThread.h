@@ -348,6 +348,13 @@ public:
   bool is_event_type(EventType et);
   void set_event_type(EventType et);
 
+  /// Work stealing thread group this thread belongs to, if any.
+  static constexpr EventType NO_STEAL_GROUP = -1;
+  EventType                  steal_group    = NO_STEAL_GROUP;
+
+  /// Take immediate events queued on another thread of @a steal_group, returns @c true if any were taken.
+  bool steal_events();
+
   // Private Interface
 
   void             execute() override;
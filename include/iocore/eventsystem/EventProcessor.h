@@ -294,6 +294,7 @@ public:
     int              _count            = 0;                       ///< # of threads of this type.
     std::atomic<int> _started          = 0;                       ///< # of started threads of this type.
     uint64_t         _next_round_robin = 0;                       ///< Index of thread to use for events assigned to this group.
+    bool             _work_stealing    = false; ///< Idle threads run immediate events queued on busy ones, set before spawning.
     Que(Event, link) _spawnQueue;                                 ///< Events to dispatch when thread is spawned.
     EThread              *_thread[MAX_THREADS_IN_EACH_TYPE] = {}; ///< The actual threads in this group.
     std::function<void()> _afterStartCallback               = nullptr;
@@ -320,6 +321,7 @@ public:
   \*------------------------------------------------------*/
 
   Event   *schedule(Event *e, EventType etype);
+  Event   *schedule_stealable(Event *e, EventType etype, EThread *curr_thread);
   EThread *assign_thread(EventType etype);
   EThread *assign_affinity_by_type(Continuation *cont, EventType etype);
 
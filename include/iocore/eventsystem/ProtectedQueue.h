@@ -36,6 +36,9 @@
 
 #include "tscore/ink_platform.h"
 #include "iocore/eventsystem/Event.h"
+
+#include <atomic>
+
 struct ProtectedQueue {
   void   enqueue(Event *e);
   void   signal();
@@ -45,10 +48,19 @@ struct ProtectedQueue {
   void   dequeue_external();       // Dequeue any external events.
   void   wait(ink_hrtime timeout); // Wait for @a timeout nanoseconds on a condition variable if there are no events.
 
+  // Immediate events of a work stealing thread group, which other threads of the group may take.
+  int    enqueue_stealable(Event *e); // Returns the number of queued events.
+  Event *dequeue_stealable();
+  int    steal(ProtectedQueue &victim, EThread *thief); // Move about half of the events of @a victim to this queue.
+
   InkAtomicList al;
   ink_mutex     lock;
   ink_cond      might_have_data;
   Que(Event, link) localQueue;
 
+  ink_mutex stealLock;
+  Que(Event, link) stealQueue;
+  std::atomic<int> stealCount = 0;
+
   ProtectedQueue();
 };
@@ -53,6 +53,10 @@ template <class CAlloc, typename... Args>
 typename CAlloc::Value_type *
 thread_alloc(CAlloc &a, ProxyAllocator &l, Args &&...args)
 {
+  // When empty, refill with a whole magazine of blocks freed by other threads.
+  if (!cmd_disable_pfreelist && !l.freelist) {
+    l.allocated = a.raw().alloc_void_bulk(&l.freelist);
+  }
   if (!cmd_disable_pfreelist && l.freelist) {
     void *v    = l.freelist;
     l.freelist = *reinterpret_cast<void **>(l.freelist);
@@ -312,6 +312,7 @@ HostDBInfo::invalidate()
 class HostDBRecord : public RefCountObj
 {
   friend struct HostDBContinuation;
+  friend struct HostDBSync;
   using self_type = HostDBRecord;
 
   /// Size of the IO buffer block owned by @a this.
@@ -506,6 +507,16 @@ public:
    */
   static self_type *unmarshall(char *buff, unsigned size);
 
+  /** Initialize an instance in place from a serialized buffer.
+   *
+   * @param buff Serialization data.
+   * @param size Size of @a buff.
+   * @return @a buff as an instance, or @c nullptr if the data is not a valid record.
+   *
+   * The instance does not own its memory, which must outlive it, and does not free it.
+   */
+  static self_type *restore(char *buff, unsigned size);
+
   /// Database version.
   static constexpr ts::VersionNumber Version{3, 0};
 
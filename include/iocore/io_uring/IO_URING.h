@@ -33,6 +33,7 @@ struct IOUringConfig {
   int attach_wq     = 0;
   int wq_bounded    = 0;
   int wq_unbounded  = 0;
+  int net_io        = 0;
 };
 
 class IOUringCompletionHandler
@@ -76,6 +77,7 @@ public:
 
   // assigns the global iouring config
   static void            set_config(const IOUringConfig &);
+  static bool            net_io_enabled();
   static IOUringContext *local_context();
   static void            set_main_queue(IOUringContext *);
   static int             get_main_queue_fd();
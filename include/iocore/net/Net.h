@@ -60,6 +60,9 @@ extern int net_accept_period;
 extern int net_retry_delay;
 extern int net_throttle_delay;
 
+// Requested size of a splice pipe in bytes, 0 for the kernel default.
+extern int net_splice_pipe_size;
+
 extern std::string_view net_ccp_in;
 extern std::string_view net_ccp_out;
 
@@ -278,6 +278,21 @@ public:
    */
   virtual void trapWriteBufferEmpty(int event = VC_EVENT_WRITE_READY);
 
+  /** Move the data read by @a read_vio straight to @a peer in the kernel, bypassing the VIO buffers.
+
+      The bytes still count towards @a read_vio and @a peer_write_vio and the usual events are sent
+      for both, only the buffers stay empty.  Anything already in the buffers is written first.  The
+      splice ends when either VIO is set up again or either connection is closed.  Data the read side
+      has already moved into the kernel is still written to @a peer after the read side ends.
+
+      @return @c true if the connections were spliced, @c false if they do not support it.
+  */
+  virtual bool
+  splice_to(VIO * /* read_vio ATS_UNUSED */, NetVConnection * /* peer ATS_UNUSED */, VIO * /* peer_write_vio ATS_UNUSED */)
+  {
+    return false;
+  }
+
   /** Returns local sockaddr storage. */
   sockaddr const   *get_local_addr();
   IpEndpoint const &get_local_endpoint();
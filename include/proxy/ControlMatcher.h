@@ -54,8 +54,9 @@
  *  Lookup Table Descriptions
  *  -------------------------
  *
- *   regex table - implemented as a linear list of regular expressions to
- *       match against
+ *   regex table - implemented as a RegexSet, which finds the regular
+ *       expressions whose required literal occurs in the URL in a single
+ *       pass and only runs those (and the ones without a literal)
  *
  *   host/domain table - The host domain table is logically implemented as
  *       tree, broken up at each partition in a hostname.  Three mechanism
@@ -213,6 +214,7 @@ public:
 
   void   AllocateSpace(int num_entries);
   Result NewEntry(matcher_line *line_info);
+  void   Finalize(); // Called once all entries are added, before matching.
 
   void Match(RequestData *rdata, MatchResult *result) const;
   void Print() const;
@@ -224,8 +226,10 @@ public:
   using super::num_el;
 
 protected:
-  pcre **re_array = nullptr; // array of compiled regexs
-  char **re_str   = nullptr; // array of uncompiled regex strings
+  void MatchString(const char *str, RequestData *rdata, MatchResult *result) const;
+
+  RegexSet re_set;           // all of the regexs, matched in one pass
+  char   **re_str = nullptr; // array of uncompiled regex strings
 };
 
 template <class Data, class MatchResult> class HostRegexMatcher : public RegexMatcher<Data, MatchResult>
@@ -253,6 +257,7 @@ public:
 
   void   AllocateSpace(int num_entries);
   Result NewEntry(matcher_line *line_info);
+  void   Finalize(); // Called once all entries are added, before matching.
 
   void Match(RequestData *rdata, MatchResult *result) const;
   void Print() const;
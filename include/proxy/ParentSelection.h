@@ -169,6 +169,7 @@ public:
   int                             max_unavailable_server_retries     = 1;
   int                             secondary_mode                     = 1;
   bool                            ignore_self_detect                 = false;
+  ATSConsistentHash::Algorithm    hash_algorithm                     = ATSConsistentHash::Algorithm::RING;
 };
 
 // If the parent was set by the external customer api,
@@ -893,6 +893,15 @@ void mime_field_name_value_set(HdrHeap *heap, MIMEHdrImpl *mh, MIMEField *field,
 void mime_field_value_append(HdrHeap *heap, MIMEHdrImpl *mh, MIMEField *field, const char *value, int length, bool prepend_comma,
                              const char separator);
 
+/** Vectorized scans over raw header text, used by the MIME and HTTP parsers.
+
+    Both return a pointer to the first matching character in [@a s, @a e), or @a e if there is none.
+    @c mime_scan_lf_or_nul matches LF and NUL, @c mime_scan_control matches the characters for
+    which @c ParseRules::is_control is true.
+ */
+const char *mime_scan_lf_or_nul(const char *s, const char *e);
+const char *mime_scan_control(const char *s, const char *e);
+
 void        mime_parser_init(MIMEParser *parser);
 void        mime_parser_clear(MIMEParser *parser);
 ParseResult mime_parser_parse(MIMEParser *parser, HdrHeap *heap, MIMEHdrImpl *mh, const char **real_s, const char *real_e,
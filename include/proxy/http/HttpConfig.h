@@ -229,6 +229,9 @@ struct HttpStatsBlock {
   Metrics::Counter::AtomicType *server_first_connect_time;
   Metrics::Counter::AtomicType *server_first_read_time;
   Metrics::Counter::AtomicType *server_read_header_done_time;
+  Metrics::Counter::AtomicType *server_session_pool_global_hits;
+  Metrics::Counter::AtomicType *server_session_pool_steal_hits;
+  Metrics::Counter::AtomicType *server_session_pool_thread_hits;
   Metrics::Counter::AtomicType *sm_finish_time;
   Metrics::Counter::AtomicType *sm_start_time;
   Metrics::Counter::AtomicType *tcp_client_refresh_count;
@@ -795,6 +798,8 @@ public:
   MgmtByte send_100_continue_response = 0;
   MgmtByte disallow_post_100_continue = 0;
 
+  MgmtByte tunnel_splice = 0;
+
   MgmtByte server_session_sharing_pool = TS_SERVER_SESSION_SHARING_POOL_THREAD;
 
   ConnectionTracker::GlobalConfig global_connection_tracker_config;
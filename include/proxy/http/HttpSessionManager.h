@@ -36,6 +36,8 @@
 #include "proxy/PoolableSession.h"
 #include "swoc/IntrusiveHashMap.h"
 
+#include <atomic>
+
 class ProxyTransaction;
 class HttpSM;
 
@@ -85,6 +87,13 @@ public:
   static bool match(PoolableSession *ss, sockaddr const *addr, CryptoHash const &host_hash,
                     TSServerSessionSharingMatchMask match_style);
 
+  /** Check, without the pool lock, if the pool may have a session for @a addr or @a host_hash.
+
+      This is used to skip the pools of other threads that can not have a match. A @c true result
+      still needs a search with @c acquireSession.
+   */
+  bool may_match(sockaddr const *addr, CryptoHash const &host_hash, TSServerSessionSharingMatchMask match_style) const;
+
   /** Get a session from the pool.
 
       The session is selected based on @a match_style equivalently to @a match. If found the session
@@ -105,6 +114,13 @@ public:
   // Note that each server session is stored in both pools.
   IPTable   m_ip_pool;
   FQDNTable m_fqdn_pool;
+
+private:
+  // Number of sessions in the pool per hash bucket of the address and of the host name, for @c may_match.
+  static constexpr int PROBE_BUCKETS = 64;
+
+  std::atomic<int> m_ip_probe[PROBE_BUCKETS]{};
+  std::atomic<int> m_fqdn_probe[PROBE_BUCKETS]{};
 };
 
 class HttpSessionManager
@@ -134,6 +150,9 @@ private:
   ServerSessionPool             *m_g_pool = nullptr;
   HSMresult_t                    _acquire_session(sockaddr const *ip, CryptoHash const &hostname_hash, HttpSM *sm,
                                                   TSServerSessionSharingMatchMask match_style, TSServerSessionSharingPoolType pool_type);
+  HSMresult_t                    _steal_session(sockaddr const *ip, CryptoHash const &hostname_hash, HttpSM *sm,
+                                                TSServerSessionSharingMatchMask match_style);
+  PoolableSession               *_migrate_session(PoolableSession *ssn, ServerSessionPool *pool, HttpSM *sm, EThread *ethread);
   TSServerSessionSharingPoolType m_pool_type = TS_SERVER_SESSION_SHARING_POOL_THREAD;
 };
 
@@ -46,8 +46,9 @@ class NextHopConsistentHash : public NextHopSelectionStrategy
   uint64_t getHashKey(uint64_t sm_id, const HttpRequestData &hrdata, ATSHash64 *h);
 
 public:
-  NHHashKeyType hash_key = NH_PATH_HASH_KEY;
-  NHHashUrlType hash_url = NH_HASH_URL_REQUEST;
+  NHHashKeyType                hash_key       = NH_PATH_HASH_KEY;
+  NHHashUrlType                hash_url       = NH_HASH_URL_REQUEST;
+  ATSConsistentHash::Algorithm hash_algorithm = ATSConsistentHash::Algorithm::RING;
 
   NextHopConsistentHash() = delete;
   NextHopConsistentHash(const std::string_view name, const NHPolicyType &policy, ts::Yaml::Map &n);
@@ -34,6 +34,7 @@
 #include "proxy/http/remap/RemapConfig.h"
 
 #include <memory>
+#include <vector>
 
 #define URL_REMAP_FILTER_NONE         0x00000000
 #define URL_REMAP_FILTER_REFERER      0x00000001 /* enable "referer" header validation */
@@ -154,6 +155,10 @@ public:
   struct MappingsStore {
     std::unique_ptr<URLTable> hash_lookup;
     RegexMappingList          regex_list;
+
+    // Literal prefilter over the host patterns of regex_list, index i is the i'th mapping in rank order.
+    RegexSet                    regex_index;
+    std::vector<RegexMapping *> regex_by_index;
     bool
     empty()
     {
@@ -171,6 +176,8 @@ public:
   {
     _destroyTable(store.hash_lookup);
     _destroyList(store.regex_list);
+    store.regex_index = RegexSet();
+    store.regex_by_index.clear();
   }
 
   bool InsertForwardMapping(mapping_type maptype, url_mapping *mapping, const char *src_host);
@@ -240,12 +247,13 @@ private:
                       UrlMappingContainer &mapping_container);
   url_mapping *_tableLookup(std::unique_ptr<URLTable> &h_table, URL *request_url, int request_port, char *request_host,
                             int request_host_len);
-  bool         _regexMappingLookup(RegexMappingList &regex_mappings, URL *request_url, int request_port, const char *request_host,
+  bool         _regexMappingLookup(MappingsStore &mappings, URL *request_url, int request_port, const char *request_host,
                                    int request_host_len, int rank_ceiling, UrlMappingContainer &mapping_container);
   int          _expandSubstitutions(size_t *matches_info, const RegexMapping *reg_map, const char *matched_string, char *dest_buf,
                                     int dest_buf_size);
   void         _destroyTable(std::unique_ptr<URLTable> &h_table);
   void         _destroyList(RegexMappingList &regexes);
+  void         _buildRegexIndex(MappingsStore &store);
   inline bool  _addToStore(MappingsStore &store, url_mapping *new_mapping, RegexMapping *reg_map, const char *src_host,
                            bool is_cur_mapping_regex, int &count);
 };
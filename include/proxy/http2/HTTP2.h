@@ -75,50 +75,57 @@ const uint32_t HTTP2_MAX_BUFFER_USAGE       = 524288;
 const uint32_t HTTP2_PRIORITY_DEFAULT_STREAM_DEPENDENCY = 0;
 const uint8_t  HTTP2_PRIORITY_DEFAULT_WEIGHT            = 15;
 
+// Values of proxy.config.http2.stream_priority_enabled
+enum Http2StreamPriorityScheme {
+  HTTP2_STREAM_PRIORITY_DISABLED = 0,
+  HTTP2_STREAM_PRIORITY_RFC7540  = 1, // [RFC 7540] 5.3 dependency tree
+  HTTP2_STREAM_PRIORITY_RFC9218  = 2, // [RFC 9218] urgency and incremental
+};
+
 // Statistics
 struct Http2StatsBlock {
-  Metrics::Gauge::AtomicType   *current_client_session_count;
-  Metrics::Gauge::AtomicType   *current_server_session_count;
-  Metrics::Gauge::AtomicType   *current_active_client_connection_count;
-  Metrics::Gauge::AtomicType   *current_active_server_connection_count;
-  Metrics::Gauge::AtomicType   *current_client_stream_count;
-  Metrics::Gauge::AtomicType   *current_server_stream_count;
-  Metrics::Counter::AtomicType *total_client_stream_count;
-  Metrics::Counter::AtomicType *total_server_stream_count;
-  Metrics::Counter::AtomicType *total_transactions_time;
-  Metrics::Counter::AtomicType *total_client_connection_count;
-  Metrics::Counter::AtomicType *total_server_connection_count;
-  Metrics::Counter::AtomicType *stream_errors_count;
-  Metrics::Counter::AtomicType *connection_errors_count;
-  Metrics::Counter::AtomicType *session_die_default;
-  Metrics::Counter::AtomicType *session_die_other;
-  Metrics::Counter::AtomicType *session_die_active;
-  Metrics::Counter::AtomicType *session_die_inactive;
-  Metrics::Counter::AtomicType *session_die_eos;
-  Metrics::Counter::AtomicType *session_die_error;
-  Metrics::Counter::AtomicType *session_die_high_error_rate;
-  Metrics::Counter::AtomicType *max_settings_per_frame_exceeded;
-  Metrics::Counter::AtomicType *max_settings_per_minute_exceeded;
-  Metrics::Counter::AtomicType *max_settings_frames_per_minute_exceeded;
-  Metrics::Counter::AtomicType *max_ping_frames_per_minute_exceeded;
-  Metrics::Counter::AtomicType *max_priority_frames_per_minute_exceeded;
-  Metrics::Counter::AtomicType *max_rst_stream_frames_per_minute_exceeded;
-  Metrics::Counter::AtomicType *max_continuation_frames_per_minute_exceeded;
-  Metrics::Counter::AtomicType *max_empty_frames_per_minute_exceeded;
-  Metrics::Counter::AtomicType *insufficient_avg_window_update;
-  Metrics::Counter::AtomicType *max_concurrent_streams_exceeded_in;
-  Metrics::Counter::AtomicType *max_concurrent_streams_exceeded_out;
-  Metrics::Counter::AtomicType *data_frames_in;
-  Metrics::Counter::AtomicType *headers_frames_in;
-  Metrics::Counter::AtomicType *priority_frames_in;
-  Metrics::Counter::AtomicType *rst_stream_frames_in;
-  Metrics::Counter::AtomicType *settings_frames_in;
-  Metrics::Counter::AtomicType *push_promise_frames_in;
-  Metrics::Counter::AtomicType *ping_frames_in;
-  Metrics::Counter::AtomicType *goaway_frames_in;
-  Metrics::Counter::AtomicType *window_update_frames_in;
-  Metrics::Counter::AtomicType *continuation_frames_in;
-  Metrics::Counter::AtomicType *unknown_frames_in;
+  Metrics::Gauge::AtomicType          *current_client_session_count;
+  Metrics::Gauge::AtomicType          *current_server_session_count;
+  Metrics::Gauge::AtomicType          *current_active_client_connection_count;
+  Metrics::Gauge::AtomicType          *current_active_server_connection_count;
+  Metrics::Gauge::AtomicType          *current_client_stream_count;
+  Metrics::Gauge::AtomicType          *current_server_stream_count;
+  Metrics::Counter::AtomicType        *total_client_stream_count;
+  Metrics::Counter::AtomicType        *total_server_stream_count;
+  Metrics::Counter::AtomicType        *total_transactions_time;
+  Metrics::Counter::AtomicType        *total_client_connection_count;
+  Metrics::Counter::AtomicType        *total_server_connection_count;
+  Metrics::Counter::AtomicType        *stream_errors_count;
+  Metrics::Counter::AtomicType        *connection_errors_count;
+  Metrics::Counter::AtomicType        *session_die_default;
+  Metrics::Counter::AtomicType        *session_die_other;
+  Metrics::Counter::AtomicType        *session_die_active;
+  Metrics::Counter::AtomicType        *session_die_inactive;
+  Metrics::Counter::AtomicType        *session_die_eos;
+  Metrics::Counter::AtomicType        *session_die_error;
+  Metrics::Counter::AtomicType        *session_die_high_error_rate;
+  Metrics::Counter::AtomicType        *max_settings_per_frame_exceeded;
+  Metrics::Counter::AtomicType        *max_settings_per_minute_exceeded;
+  Metrics::Counter::AtomicType        *max_settings_frames_per_minute_exceeded;
+  Metrics::Counter::AtomicType        *max_ping_frames_per_minute_exceeded;
+  Metrics::Counter::AtomicType        *max_priority_frames_per_minute_exceeded;
+  Metrics::Counter::AtomicType        *max_rst_stream_frames_per_minute_exceeded;
+  Metrics::Counter::AtomicType        *max_continuation_frames_per_minute_exceeded;
+  Metrics::Counter::AtomicType        *max_empty_frames_per_minute_exceeded;
+  Metrics::Counter::AtomicType        *insufficient_avg_window_update;
+  Metrics::Counter::AtomicType        *max_concurrent_streams_exceeded_in;
+  Metrics::Counter::AtomicType        *max_concurrent_streams_exceeded_out;
+  Metrics::ShardedCounter::AtomicType *data_frames_in;
+  Metrics::ShardedCounter::AtomicType *headers_frames_in;
+  Metrics::ShardedCounter::AtomicType *priority_frames_in;
+  Metrics::ShardedCounter::AtomicType *rst_stream_frames_in;
+  Metrics::ShardedCounter::AtomicType *settings_frames_in;
+  Metrics::ShardedCounter::AtomicType *push_promise_frames_in;
+  Metrics::ShardedCounter::AtomicType *ping_frames_in;
+  Metrics::ShardedCounter::AtomicType *goaway_frames_in;
+  Metrics::ShardedCounter::AtomicType *window_update_frames_in;
+  Metrics::ShardedCounter::AtomicType *continuation_frames_in;
+  Metrics::ShardedCounter::AtomicType *unknown_frames_in;
 };
 
 extern Http2StatsBlock http2_rsb;
@@ -179,7 +186,7 @@ enum Http2FrameType {
   HTTP2_FRAME_TYPE_MAX,
 };
 
-extern Metrics::Counter::AtomicType *http2_frame_metrics_in[HTTP2_FRAME_TYPE_MAX + 1];
+extern Metrics::ShardedCounter::AtomicType *http2_frame_metrics_in[HTTP2_FRAME_TYPE_MAX + 1];
 
 // [RFC 7540] 6.1. Data
 enum Http2FrameFlagsData {
@@ -440,6 +447,7 @@ public:
   static int64_t  write_buffer_block_size_index;
   static float    write_size_threshold;
   static uint32_t write_time_threshold;
+  static uint32_t write_reference_threshold;
   static uint32_t buffer_water_mark;
 
   static void init();
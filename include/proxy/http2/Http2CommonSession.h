@@ -80,6 +80,24 @@ class Http2CommonSession
 public:
   using SessionHandler = int (Http2CommonSession::*)(int, void *);
 
+  /** Holds back the flushes requested by xmit() and flush() while in scope.
+   *
+   * The outermost batch flushes once when it ends, so all the frames produced
+   * while handling an event reach the network with a single reenable.
+   */
+  class WriteBatch
+  {
+  public:
+    explicit WriteBatch(Http2CommonSession *ssn);
+    ~WriteBatch();
+
+    WriteBatch(const WriteBatch &)            = delete;
+    WriteBatch &operator=(const WriteBatch &) = delete;
+
+  private:
+    Http2CommonSession *_ssn;
+  };
+
   virtual ~Http2CommonSession() = default;
 
   /////////////////////
@@ -175,6 +193,8 @@ protected:
   int    _n_frame_read   = 0;
 
   uint32_t _pending_sending_data_size = 0;
+  int      _write_batch_depth         = 0;
+  bool     _write_batch_flush         = false;
 
   int64_t read_from_early_data      = 0;
   bool    cur_frame_from_early_data = false;
@@ -32,6 +32,7 @@
 #include "proxy/http2/HPACK.h"
 #include "proxy/http2/Http2Stream.h"
 #include "proxy/http2/Http2DependencyTree.h"
+#include "proxy/http2/Http2PriorityScheduler.h"
 #include "tscore/FrequencyCounter.h"
 
 class Http2CommonSession;
@@ -79,13 +80,14 @@ public:
   Http2ConnectionState(const Http2ConnectionState &)            = delete;
   Http2ConnectionState &operator=(const Http2ConnectionState &) = delete;
 
-  ProxyError               rx_error_code;
-  ProxyError               tx_error_code;
-  Http2CommonSession      *session            = nullptr;
-  HpackHandle             *local_hpack_handle = nullptr;
-  HpackHandle             *peer_hpack_handle  = nullptr;
-  DependencyTree          *dependency_tree    = nullptr;
-  ActivityCop<Http2Stream> _cop;
+  ProxyError                        rx_error_code;
+  ProxyError                        tx_error_code;
+  Http2CommonSession               *session            = nullptr;
+  HpackHandle                      *local_hpack_handle = nullptr;
+  HpackHandle                      *peer_hpack_handle  = nullptr;
+  DependencyTree                   *dependency_tree    = nullptr;
+  Http2PriorityScheduler::Scheduler priority_scheduler;
+  ActivityCop<Http2Stream>          _cop;
 
   /** The HTTP/2 settings configured by ATS and dictated to the peer via
    * SETTINGS frames. */
@@ -157,6 +159,7 @@ public:
   // HTTP/2 frame sender
   void                     schedule_stream_to_send_priority_frames(Http2Stream *stream);
   void                     send_data_frames_depends_on_priority();
+  void                     send_data_frames_depends_on_urgency();
   void                     schedule_stream_to_send_data_frames(Http2Stream *stream);
   void                     schedule_retransmit(ink_hrtime t);
   void                     cancel_retransmit();
@@ -391,6 +394,10 @@ private:
   static constexpr const int DATA_EVENT_BACKOFF_START = 10;
   static constexpr const int DATA_EVENT_BACKOFF_MAX   = 1000;
 
+  // Upper bound of the DATA frames sent by one HTTP2_SESSION_EVENT_PRIO event
+  // in the [RFC 9218] mode, so one busy connection doesn't hold the thread.
+  static constexpr const int MAX_DATA_FRAMES_PER_EVENT = 32;
+
   // NOTE: Id of stream which MUST receive CONTINUATION frame.
   //   - [RFC 7540] 6.2 HEADERS
   //     "A HEADERS frame without the END_HEADERS flag set MUST be followed by a
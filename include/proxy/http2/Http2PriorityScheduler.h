@@ -0,0 +1,194 @@
+/** @file
+
+  HTTP/2 scheduler for Extensible Priorities ([RFC 9218])
+
+  Streams with data to send are kept in one queue per urgency level. The most
+  urgent non-empty level is found from a bitmap, so picking, adding and
+  removing a stream is O(1) regardless of the number of streams.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#pragma once
+
+#include "tscore/List.h"
+#include "tscore/ink_assert.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+
+namespace Http2PriorityScheduler
+{
+// [RFC 9218] 4.1 Urgency
+constexpr uint8_t URGENCY_LEVELS  = 8;
+constexpr uint8_t DEFAULT_URGENCY = 3;
+
+class Node
+{
+public:
+  explicit Node(void *t = nullptr) : t(t) {}
+
+  Node(const Node &)            = delete;
+  Node &operator=(const Node &) = delete;
+
+  LINK(Node, link);
+
+  uint8_t urgency     = DEFAULT_URGENCY;
+  bool    incremental = false;
+  bool    active      = false;
+  void   *t           = nullptr;
+};
+
+/**
+ * Within an urgency level a non-incremental stream stays at the head of the
+ * queue until it is deactivated, so it is sent in one piece, while an
+ * incremental stream goes to the back after each frame and shares the
+ * bandwidth with the other incremental streams of its level ([RFC 9218] 4.2).
+ */
+class Scheduler
+{
+public:
+  Node    *top() const;
+  void     activate(Node *node);
+  void     deactivate(Node *node);
+  void     update(Node *node);
+  void     reprioritize(Node *node, uint8_t urgency, bool incremental);
+  uint32_t size() const;
+
+private:
+  Queue<Node> _queues[URGENCY_LEVELS];
+  uint8_t     _levels = 0; ///< Bit n is set if urgency level n has an active node.
+  uint32_t    _size   = 0;
+};
+
+inline Node *
+Scheduler::top() const
+{
+  if (_levels == 0) {
+    return nullptr;
+  }
+  return _queues[__builtin_ctz(_levels)].head;
+}
+
+inline void
+Scheduler::activate(Node *node)
+{
+  if (node->active) {
+    return;
+  }
+  ink_assert(node->urgency < URGENCY_LEVELS);
+  node->active = true;
+  _queues[node->urgency].enqueue(node);
+  _levels |= 1 << node->urgency;
+  ++_size;
+}
+
+inline void
+Scheduler::deactivate(Node *node)
+{
+  if (!node->active) {
+    return;
+  }
+  node->active = false;
+  _queues[node->urgency].remove(node);
+  if (_queues[node->urgency].empty()) {
+    _levels &= ~(1 << node->urgency);
+  }
+  --_size;
+}
+
+/**
+ * Called after a frame of @a node was sent.
+ */
+inline void
+Scheduler::update(Node *node)
+{
+  if (node->active && node->incremental) {
+    _queues[node->urgency].remove(node);
+    _queues[node->urgency].enqueue(node);
+  }
+}
+
+inline void
+Scheduler::reprioritize(Node *node, uint8_t urgency, bool incremental)
+{
+  bool const active = node->active;
+
+  deactivate(node);
+  node->urgency     = urgency < URGENCY_LEVELS ? urgency : DEFAULT_URGENCY;
+  node->incremental = incremental;
+  if (active) {
+    activate(node);
+  }
+}
+
+inline uint32_t
+Scheduler::size() const
+{
+  return _size;
+}
+
+/**
+ * Parse the value of a priority header field ([RFC 9218] 4, 5) into @a
+ * urgency and @a incremental. Members that are not understood are ignored,
+ * which leaves the corresponding output at its current value.
+ */
+inline void
+parse_priority_field(std::string_view value, uint8_t &urgency, bool &incremental)
+{
+  auto trim = [](std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) {
+      s.remove_prefix(1);
+    }
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) {
+      s.remove_suffix(1);
+    }
+    return s;
+  };
+
+  while (!value.empty()) {
+    std::string_view member = value.substr(0, value.find(','));
+    value.remove_prefix(std::min(value.size(), member.size() + 1));
+
+    // Parameters of a member are not used by any of the defined keys.
+    member = trim(member.substr(0, member.find(';')));
+
+    std::string_view key = member.substr(0, member.find('='));
+    std::string_view val;
+    if (key.size() < member.size()) {
+      val = trim(member.substr(key.size() + 1));
+    }
+    key = trim(key);
+
+    if (key == "u") {
+      if (val.size() == 1 && val[0] >= '0' && val[0] < '0' + URGENCY_LEVELS) {
+        urgency = val[0] - '0';
+      }
+    } else if (key == "i") {
+      if (val.empty() || val == "?1") {
+        incremental = true;
+      } else if (val == "?0") {
+        incremental = false;
+      }
+    }
+  }
+}
+
+} // namespace Http2PriorityScheduler
@@ -29,6 +29,7 @@
 #include "proxy/ProxyTransaction.h"
 #include "proxy/http2/Http2DebugNames.h"
 #include "proxy/http2/Http2DependencyTree.h"
+#include "proxy/http2/Http2PriorityScheduler.h"
 #include "tscore/History.h"
 #include "proxy/Milestones.h"
 
@@ -171,6 +172,7 @@ public:
   MIOBuffer       *read_vio_writer() const;
   int64_t          read_vio_read_avail();
   bool             is_read_enabled() const;
+  void             set_priority_from_headers();
 
   //////////////////
   // Variables
@@ -184,9 +186,10 @@ public:
   bool parsing_header_done       = false;
   bool is_first_transaction_flag = false;
 
-  HTTPHdr                    _send_header;
-  IOBufferReader            *_send_reader  = nullptr;
-  Http2DependencyTree::Node *priority_node = nullptr;
+  HTTPHdr                      _send_header;
+  IOBufferReader              *_send_reader  = nullptr;
+  Http2DependencyTree::Node   *priority_node = nullptr;
+  Http2PriorityScheduler::Node scheduler_node{this};
 
   Http2ConnectionState &get_connection_state();
 
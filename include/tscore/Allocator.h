@@ -40,14 +40,71 @@
 #pragma once
 
 #include <cstdlib>
+#include <mutex>
 #include <utility>
 #include "tscore/ink_queue.h"
+#include "tscore/ink_thread.h"
 #include "tscore/ink_resource.h"
 #include "tsutil/Metrics.h"
 #include <execinfo.h>
 
 #define RND16(_x) (((_x) + 15) & ~15)
 
+/** Global depot of magazines for an allocator.
+
+  A magazine is a chain of free blocks, linked through their first word like the
+  free list. Thread local free lists hand over and take whole magazines, so a
+  block allocated on one thread and freed on another costs a share of one depot
+  operation instead of a compare and swap on the global free list. The depot is
+  bounded, when it is full magazines go back to the free list.
+*/
+class MagazineDepot
+{
+public:
+  static constexpr int    CAPACITY     = 32; ///< Magazines held before falling back to the free list.
+  static constexpr size_t MIN_MAGAZINE = 16; ///< Shorter chains are not worth a depot slot.
+
+  /// Store the @a count blocks from @a head to @a tail, returns @c false if the depot is full.
+  bool
+  push(void *head, void *tail, size_t count)
+  {
+    if (count < MIN_MAGAZINE) {
+      return false;
+    }
+    *static_cast<void **>(tail) = nullptr;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_n == CAPACITY) {
+      return false;
+    }
+    _magazines[_n++] = {head, count};
+    return true;
+  }
+
+  /// Take a magazine, @a head is set to its first block.  Returns the number of blocks or 0 if the depot is empty.
+  size_t
+  pop(void **head)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_n == 0) {
+      return 0;
+    }
+    Magazine &m = _magazines[--_n];
+    *head       = m.head;
+    return m.count;
+  }
+
+private:
+  struct Magazine {
+    void  *head;
+    size_t count;
+  };
+
+  std::mutex _mutex;
+  int        _n = 0;
+  Magazine   _magazines[CAPACITY];
+};
+
 /** Allocator for fixed size memory blocks. */
 class FreelistAllocator
 {
@@ -83,7 +140,21 @@ public:
   void
   free_void_bulk(void *head, void *tail, size_t num_item)
   {
-    ink_freelist_free_bulk(this->fl, head, tail, num_item);
+    if (!local_depot().push(head, tail, num_item)) {
+      ink_freelist_free_bulk(this->fl, head, tail, num_item);
+    }
+  }
+
+  /**
+    Allocate a magazine of blocks freed in bulk, to refill a thread local free list.
+
+    @param head set to the first block, the blocks are linked through their first word.
+    @return the number of blocks, 0 if there is no magazine.
+  */
+  size_t
+  alloc_void_bulk(void **head)
+  {
+    return local_depot().pop(head);
   }
 
   FreelistAllocator() { fl = nullptr; }
@@ -122,7 +193,18 @@ public:
   }
 
 protected:
-  InkFreeList *fl;
+  /// Depots kept apart, so magazines freed on a NUMA node are reused on that node.
+  static constexpr int DEPOT_NODES = 4;
+
+  MagazineDepot &
+  local_depot()
+  {
+    int node = ink_numa_node();
+    return depot[node < 0 ? 0 : node % DEPOT_NODES];
+  }
+
+  InkFreeList  *fl;
+  MagazineDepot depot[DEPOT_NODES];
 };
 
 class MallocAllocator
@@ -177,6 +259,13 @@ public:
     }
   }
 
+  /// There are no magazines, blocks are always freed to malloc.
+  size_t
+  alloc_void_bulk(void ** /* head ATS_UNUSED */)
+  {
+    return 0;
+  }
+
   MallocAllocator() {}
 
   /**
@@ -248,6 +337,15 @@ public:
     WrappedAllocator::free_void_bulk(head, tail, num_item);
   }
 
+  size_t
+  alloc_void_bulk(void **head)
+  {
+    size_t num_item = WrappedAllocator::alloc_void_bulk(head);
+    inuse_metric->increment(num_item);
+    alloc_metric->increment(num_item);
+    return num_item;
+  }
+
   MeteredAllocator() {}
 
   MeteredAllocator(const char *name, unsigned int element_size, unsigned int chunk_size = 128, unsigned int alignment = 8,
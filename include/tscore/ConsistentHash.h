@@ -23,9 +23,11 @@
 
 #include <atomic>
 #include "tscore/Hash.h"
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
-#include <map>
+#include <mutex>
+#include <vector>
 
 /*
   Helper class to be extended to make ring nodes.
@@ -38,16 +40,28 @@ struct ATSConsistentHashNode {
 
 std::ostream &operator<<(std::ostream &os, ATSConsistentHashNode &thing);
 
-using ATSConsistentHashIter = std::map<uint64_t, ATSConsistentHashNode *>::iterator;
+/// Position of a lookup, successive lookups with the same iterator walk the nodes from there.
+using ATSConsistentHashIter = size_t;
 
 /*
   TSConsistentHash requires a TSHash64 object
 
   Caller is responsible for freeing ring node memory.
+
+  With the RING algorithm every node is hashed to roundf(replicas * weight) points, kept as a sorted
+  array that lookups binary search.  With the MAGLEV algorithm the nodes fill a lookup table
+  (Eisenbud et al., "Maglev: A Fast and Reliable Software Network Load Balancer") in proportion to
+  their weight, and a lookup is a single index into the table.  The table has 64 slots per replica
+  whatever the number of nodes, and is built on the first lookup after the last insert.
  */
 
 struct ATSConsistentHash {
-  ATSConsistentHash(int r = 1024, ATSHash64 *h = nullptr);
+  enum class Algorithm {
+    RING,
+    MAGLEV,
+  };
+
+  ATSConsistentHash(int r = 1024, ATSHash64 *h = nullptr, Algorithm a = Algorithm::RING);
   void                   insert(ATSConsistentHashNode *node, float weight = 1.0, ATSHash64 *h = nullptr);
   ATSConsistentHashNode *lookup(const char *url = nullptr, ATSConsistentHashIter *i = nullptr, bool *w = nullptr,
                                 ATSHash64 *h = nullptr);
@@ -57,7 +71,33 @@ struct ATSConsistentHash {
   ~ATSConsistentHash();
 
 private:
-  int                                         replicas;
-  ATSHash64                                  *hash;
-  std::map<uint64_t, ATSConsistentHashNode *> NodeMap;
+  struct MaglevMember {
+    ATSConsistentHashNode *node;
+    float                  weight;
+    uint64_t               offset_hash;
+    uint64_t               skip_hash;
+  };
+
+  size_t start_index(uint64_t hashval);
+  void   build_maglev_table();
+
+  int        replicas;
+  ATSHash64 *hash;
+  Algorithm  algorithm;
+
+  // RING, the points of the ring sorted by hash value and the node of each.
+  std::vector<uint64_t>                ring_hashes;
+  std::vector<ATSConsistentHashNode *> ring_nodes;
+
+  // MAGLEV
+  std::vector<MaglevMember>            maglev_members;
+  std::vector<ATSConsistentHashNode *> maglev_table;
+  std::atomic<bool>                    maglev_ready{false};
+  std::mutex                           maglev_mutex;
+
+  std::vector<ATSConsistentHashNode *> &
+  slots()
+  {
+    return algorithm == Algorithm::MAGLEV ? maglev_table : ring_nodes;
+  }
 };
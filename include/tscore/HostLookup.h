@@ -30,24 +30,18 @@
 
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <string_view>
 #include <functional>
-#include <unordered_map>
 
 // HostLookup constants
 constexpr int HOST_TABLE_DEPTH = 3; // Controls the max number of levels in the logical tree
-constexpr int HOST_ARRAY_MAX   = 8; // Sets the fixed array size
+constexpr int HOST_ARRAY_MAX   = 8; // Nodes with up to this many children match '!' labels as a negation
 
-class CharIndex;
-class HostArray;
-
-// The data in the HostMatcher tree is pointers to HostBranches. No duplicates keys permitted in the tree.  To handle
-// multiple data items bound the same key, the HostBranch has the lead_indexs array which stores pointers (in the form
-// of array indexes) to HostLeaf structs
-//
-// There is HostLeaf struct for each data item put into the table
+// There is HostLeaf struct for each data item put into the table.  The nodes of the search trie refer to them by
+// index, as more than one data item can be bound to the same key.
 //
 struct HostLeaf {
   /// Type of leaf.
@@ -74,48 +68,25 @@ struct HostLeaf {
   }
 };
 
-struct HostBranch {
-  /// Branch type.
-  enum Type {
-    HOST_TERMINAL,
-    HOST_HASH,
-    HOST_INDEX,
-    HOST_ARRAY,
-  };
-
-  using HostTable = std::unordered_map<std::string_view, HostBranch *>;
-
-  using LeafIndices = std::vector<int>;
-
-  /// Type of data in this branch.
-  union Level {
-    std::nullptr_t _nil;   ///< HOST_TERMINAL
-    HostTable     *_table; ///< HOST_HASH
-    CharIndex     *_index; ///< HOST_INDEX
-    HostArray     *_array; ///< HOST_ARRAY
-    void          *_ptr;   ///< As generic pointer.
-  };
-
-  ~HostBranch();
-  int         level_idx{0};        // what level in the tree.  the root is level 0
-  Type        type{HOST_TERMINAL}; // tells what kind of data structure is next_level is
-  Level       next_level{nullptr}; // opaque pointer to lookup structure
-  LeafIndices leaf_indices;        // HostLeaf indices.
-  std::string key;
-};
-
 //
 //  End Host Lookup Helper types
 //
 
 struct HostLookupState {
-  HostBranch      *cur{nullptr};
+  int              node{-1}; ///< Index of the current trie node.
   int              table_level{0};
   int              array_index{0};
   std::string_view hostname;      ///< Original host name.
   std::string_view hostname_stub; ///< Remaining host name to search.
 };
 
+/** Host and domain name matcher.
+
+    Entries are added with @c NewEntry and then @c Finalize builds a read only trie over the reversed labels of
+    the names, at most @c HOST_TABLE_DEPTH deep.  The trie is a flat array of nodes, each of which refers to a
+    contiguous sorted run of edges and a contiguous run of leaf indices, and the labels of all the edges are
+    interned in a single string.  Matching does not allocate.
+ */
 class HostLookup
 {
 public:
@@ -125,10 +96,12 @@ public:
   HostLookup(std::string_view name);
   void NewEntry(std::string_view match_data, bool domain_record, void *opaque_data_in);
   void AllocateSpace(int num_entries);
+  /// Build the search trie, this must be called after the last @c NewEntry and before matching.
+  void Finalize();
   bool Match(std::string_view host);
   bool Match(std::string_view host, void **opaque_ptr);
-  bool MatchFirst(std::string_view host, HostLookupState *s, void **opaque_ptr);
-  bool MatchNext(HostLookupState *s, void **opaque_ptr);
+  bool MatchFirst(std::string_view host, HostLookupState *s, void **opaque_ptr) const;
+  bool MatchNext(HostLookupState *s, void **opaque_ptr) const;
 
   void Print(PrintFunc const &f) const;
   void Print() const;
@@ -140,18 +113,35 @@ public:
   }
 
 private:
-  using HostTable   = HostBranch::HostTable;
-  using LeafIndices = HostBranch::LeafIndices;
+  struct Node {
+    uint32_t edge_begin{0}; // first edge to the next level
+    uint32_t edge_count{0};
+    uint32_t leaf_begin{0}; // first index in leaf_indices
+    uint32_t leaf_count{0};
+  };
 
-  void        TableInsert(std::string_view match_data, int index, bool domain_record);
-  HostBranch *TableNewLevel(HostBranch *from, std::string_view level_data);
-  HostBranch *InsertBranch(HostBranch *insert_in, std::string_view level_data);
-  HostBranch *FindNextLevel(HostBranch *from, std::string_view level_data, bool bNotProcess = false);
-  bool        MatchArray(HostLookupState *s, void **opaque_ptr, LeafIndices &array, bool host_done);
+  struct Edge {
+    uint32_t key_offset; // label, in keys
+    uint32_t key_len;
+    uint32_t node;    // node at the next level
+    bool     negated; // label was given as '!label'
+  };
+
+  int  FindNextLevel(int from, std::string_view level_data) const;
+  bool MatchArray(HostLookupState *s, void **opaque_ptr, bool host_done) const;
+
+  std::string_view
+  EdgeKey(Edge const &e) const
+  {
+    return {keys.data() + e.key_offset, e.key_len};
+  }
 
-  void PrintHostBranch(const HostBranch *hb, PrintFunc const &f) const;
+  void PrintNode(int node, PrintFunc const &f) const;
 
-  HostBranch  root;         // The top of the search tree
-  LeafArray   leaf_array;   // array of all leaves in tree
-  std::string matcher_name; // Used for Debug/Warning/Error messages
+  std::vector<Node> nodes;        // nodes[0] is the root, empty until Finalize
+  std::vector<Edge> edges;        // edges of each node, sorted by label
+  std::vector<int>  leaf_indices; // HostLeaf indices of each node
+  std::string       keys;         // interned labels
+  LeafArray         leaf_array;   // array of all leaves in tree
+  std::string       matcher_name; // Used for Debug/Warning/Error messages
 };
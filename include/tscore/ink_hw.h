@@ -31,3 +31,6 @@ hwloc_topology_t ink_get_topology();
 #endif
 
 int ink_number_of_processors();
+
+/// NUMA node (operating system index) of the device holding the file @a fd, -1 if it is not known.
+int ink_fd_numa_node(int fd);
@@ -275,6 +275,10 @@ ink_set_thread_name(const char *name ATS_UNUSED)
 #endif
 }
 
+/// NUMA node (operating system index) the calling thread is bound to, -1 if it is not bound to one.
+int  ink_numa_node();
+void ink_set_numa_node(int node);
+
 static inline void
 ink_get_thread_name(char *name, size_t len)
 {
@@ -36,6 +36,7 @@
 #include "swoc/MemSpan.h"
 
 #include "tsutil/Assert.h"
+#include "tsutil/DenseThreadId.h"
 
 namespace ts
 {
@@ -525,6 +526,96 @@ public:
 
   }; // class Counter
 
+  /**
+   * Counters that are sharded per thread, to avoid cache line contention between cores.
+   *
+   * Every thread (as identified by DenseThreadId) increments its own slot, and the slots are
+   * only summed up when the value is read. The sum is published into the regular metric of the
+   * same name by sync(), which is called periodically along with the derived metrics, and when
+   * the metrics are dumped. The API mirrors Counter, such that a hot counter can be switched over
+   * by changing its type and the namespace of the increment() calls.
+   */
+  class ShardedCounter
+  {
+  public:
+    using self_type = ShardedCounter;
+
+    // Number of counters that share a row of slots. All counters of a row are owned by the same
+    // thread, so this only has to make the rows a multiple of the cache line size.
+    static constexpr size_t SHARD_WIDTH = 64;
+
+    class AtomicType
+    {
+      friend class ShardedCounter;
+
+    public:
+      AtomicType() = default;
+
+      int64_t
+      load() const
+      {
+        int64_t sum = 0;
+
+        for (size_t row = 0; row < _rows; ++row) {
+          sum += _base[row * SHARD_WIDTH].load(MEMORY_ORDER);
+        }
+
+        return sum;
+      }
+
+      void
+      increment(int64_t val)
+      {
+        // Different threads can share a slot if there are more threads than rows, hence the atomic add.
+        _base[(DenseThreadId::self() % _rows) * SHARD_WIDTH].fetch_add(val, MEMORY_ORDER);
+      }
+
+    protected:
+      std::atomic<int64_t> *_base      = nullptr; // The slot for this counter in the first row
+      size_t                _rows      = 0;
+      Metrics::AtomicType  *_published = nullptr; // The regular metric that sync() publishes into
+    };
+
+    static AtomicType *lookup(const IdType id);
+    static IdType      create(const std::string_view name);
+
+    static AtomicType *
+    createPtr(const std::string_view name)
+    {
+      return lookup(create(name));
+    }
+
+    static AtomicType *
+    createPtr(const std::string_view prefix, const std::string_view name)
+    {
+      std::string tmpname = std::string(prefix) + std::string(name);
+
+      return lookup(create(tmpname));
+    }
+
+    static void
+    increment(AtomicType *metric, uint64_t val = 1)
+    {
+      debug_assert(metric);
+      metric->increment(val);
+    }
+
+    static int64_t
+    load(const AtomicType *metric)
+    {
+      debug_assert(metric);
+      return metric->load();
+    }
+
+    /**
+     * Publish the current sums of all sharded counters.
+     *
+     * This static function should be called periodically, and before the metrics are read through the iterator.
+     */
+    static void sync();
+
+  }; // class ShardedCounter
+
   /**
    * Derive metrics by summing a set of other metrics.
    *
@@ -27,6 +27,9 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
 
 /// @brief Match flags for regular expression evaluation.
 ///
@@ -196,3 +199,136 @@ private:
 
   std::vector<Pattern> _patterns;
 };
+
+/** A set of regular expressions that reports every matching pattern in one pass over the subject.
+ *
+ * Where possible a literal that every match of a pattern must contain is extracted from the pattern, and the literals of
+ * all the patterns are searched for together with a single Aho-Corasick automaton. A pattern is evaluated with PCRE2 only
+ * if its literal occurs in the subject or if it has no literal, and a pattern that is nothing but a literal is not
+ * evaluated at all.
+ */
+class RegexSet
+{
+public:
+  RegexSet() = default;
+
+  /** Compile @a pattern and add it as the next pattern of the set.
+   *
+   * @return @c true if compiled successfully, @a false otherwise (and the set is not changed).
+   *
+   * All patterns must be added before @c finalize is called.
+   */
+  bool add(std::string_view pattern, std::string &error, int &erroffset, unsigned flags = 0);
+
+  /** Add @a pattern as the next pattern of the set for use with @c candidates only.
+   *
+   * The pattern is not compiled, only its literal is extracted. This is for callers that keep their own compiled
+   * copy of each pattern and want the prefilter without paying for a second compile.
+   */
+  void add_prefilter(std::string_view pattern, unsigned flags = 0);
+
+  /// Remove the pattern added last, for callers that fail to set up what goes with it.
+  void pop_back();
+
+  /// Build the literal automaton, after which the set can be matched.
+  void finalize();
+
+  /** Call @a f with the index of each pattern that matches @a subject, in order of index.
+   *
+   * It is safe to call this method concurrently on the same instance of @a this.
+   */
+  template <typename F> void match(std::string_view subject, F &&f) const;
+
+  /** Call @a f with the index of each pattern that may match @a subject, in order of index, until @a f returns @c true.
+   *
+   * A pattern is a candidate if its literal occurs in @a subject or if it has no literal. The caller evaluates the
+   * candidate itself, so this also works for patterns added with @c add_prefilter.
+   *
+   * @return The index for which @a f returned @c true, or -1 if there was none.
+   */
+  template <typename F> int32_t candidates(std::string_view subject, F &&f) const;
+
+  /// @return The number of patterns.
+  int32_t
+  size() const
+  {
+    return _patterns.size();
+  }
+
+  /// @return The number of patterns that are prefiltered by a literal.
+  int32_t literal_count() const;
+
+private:
+  struct Pattern {
+    Regex       _re;
+    std::string _literal;      ///< Required literal, empty if there is none.
+    bool        _pure = false; ///< The pattern matches exactly the subjects containing @a _literal.
+  };
+
+  /// Extract the literal of @a p from @a pattern.
+  static void _set_literal(Pattern &p, std::string_view pattern, unsigned flags);
+  /// Set the bit of each pattern whose literal occurs in @a subject.
+  void _scan(std::string_view subject, uint64_t *hits) const;
+  /// Check pattern @a idx after @a _scan.
+  bool _matches(int32_t idx, std::string_view subject, const uint64_t *hits) const;
+
+  std::vector<Pattern> _patterns;
+
+  // Automaton over byte classes, the bytes that occur in no literal share class 0.
+  uint8_t              _byte_class[256] = {};
+  int32_t              _nclasses        = 1;
+  std::vector<int32_t> _next;    ///< Transition table, node * _nclasses + class.
+  std::vector<int32_t> _output;  ///< Per node, index into @a _outputs of its pattern list or -1.
+  std::vector<int32_t> _suffix;  ///< Per node, the nearest node reached by failure links that has output, or -1.
+  std::vector<int32_t> _outputs; ///< Pattern lists, each terminated by -1.
+};
+
+template <typename F>
+void
+RegexSet::match(std::string_view subject, F &&f) const
+{
+  uint64_t              local[8];
+  std::vector<uint64_t> heap;
+  size_t                words = (_patterns.size() + 63) / 64;
+  uint64_t             *hits  = local;
+
+  if (words > std::size(local)) {
+    heap.resize(words);
+    hits = heap.data();
+  }
+  std::fill(hits, hits + words, 0);
+
+  this->_scan(subject, hits);
+  for (int32_t i = 0, n = _patterns.size(); i < n; ++i) {
+    if (this->_matches(i, subject, hits)) {
+      f(i);
+    }
+  }
+}
+
+template <typename F>
+int32_t
+RegexSet::candidates(std::string_view subject, F &&f) const
+{
+  uint64_t              local[8];
+  std::vector<uint64_t> heap;
+  size_t                words = (_patterns.size() + 63) / 64;
+  uint64_t             *hits  = local;
+
+  if (words > std::size(local)) {
+    heap.resize(words);
+    hits = heap.data();
+  }
+  std::fill(hits, hits + words, 0);
+
+  this->_scan(subject, hits);
+  for (int32_t i = 0, n = _patterns.size(); i < n; ++i) {
+    if (!_patterns[i]._literal.empty() && !(hits[i / 64] & (uint64_t{1} << (i % 64)))) {
+      continue;
+    }
+    if (f(i)) {
+      return i;
+    }
+  }
+  return -1;
+}
@@ -33,9 +33,7 @@
 #include "records/RecDefs.h"
 #include "tscore/TSSystemState.h"
 #include "tscore/ink_atomic.h"
-#if TS_USE_HWLOC
 #include "tscore/ink_hw.h"
-#endif
 
 #if TS_USE_LINUX_IO_URING
 #include "iocore/io_uring/IO_URING.h"
@@ -77,6 +75,9 @@ int thread_is_created = 0;
 RecInt cache_config_threads_per_disk = 12;
 RecInt api_config_threads_per_disk   = 12;
 
+// Bind the threads of each disk to the NUMA node of the disk.
+static RecInt aio_numa = 0;
+
 Continuation *aio_err_callback = nullptr;
 
 /* internal definitions */
@@ -195,6 +196,7 @@ ink_aio_init(ts::ModuleVersion v, [[maybe_unused]] AIOBackend backend)
   ink_mutex_init(&insert_mutex);
 
   REC_ReadConfigInteger(cache_config_threads_per_disk, "proxy.config.cache.threads_per_disk");
+  REC_ReadConfigInteger(aio_numa, "proxy.config.exec_thread.numa");
 
 #if TS_USE_LINUX_IO_URING
   // If the caller specified auto backend, check for config to force a backend
@@ -251,6 +253,7 @@ ink_aio_init(ts::ModuleVersion v, [[maybe_unused]] AIOBackend backend)
 struct AIOThreadInfo : public Continuation {
   AIO_Reqs *req;
   int       sleep_wait;
+  int       numa_node;
   void     *aio_thread_main(AIOThreadInfo *thr_info);
 
   int
@@ -258,21 +261,27 @@ struct AIOThreadInfo : public Continuation {
   {
     (void)event;
     (void)e;
-#if TS_USE_HWLOC
-#if HWLOC_API_VERSION >= 0x20000
-    hwloc_set_membind(ink_get_topology(), hwloc_topology_get_topology_nodeset(ink_get_topology()), HWLOC_MEMBIND_INTERLEAVE,
-                      HWLOC_MEMBIND_THREAD | HWLOC_MEMBIND_BYNODESET);
-#else
+#if TS_USE_HWLOC && HWLOC_API_VERSION >= 0x20000
+    // In NUMA mode the threads of a disk run on, and take their memory from, the node of the disk.
+    if (hwloc_obj_t node = numa_node >= 0 ? hwloc_get_numanode_obj_by_os_index(ink_get_topology(), numa_node) : nullptr; node) {
+      hwloc_set_cpubind(ink_get_topology(), node->cpuset, HWLOC_CPUBIND_THREAD);
+      hwloc_set_membind(ink_get_topology(), node->nodeset, HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_THREAD | HWLOC_MEMBIND_BYNODESET);
+      ink_set_numa_node(numa_node);
+    } else {
+      hwloc_set_membind(ink_get_topology(), hwloc_topology_get_topology_nodeset(ink_get_topology()), HWLOC_MEMBIND_INTERLEAVE,
+                        HWLOC_MEMBIND_THREAD | HWLOC_MEMBIND_BYNODESET);
+    }
+#elif TS_USE_HWLOC
     hwloc_set_membind_nodeset(ink_get_topology(), hwloc_topology_get_topology_nodeset(ink_get_topology()), HWLOC_MEMBIND_INTERLEAVE,
                               HWLOC_MEMBIND_THREAD);
-#endif
 #endif
     aio_thread_main(this);
     delete this;
     return EVENT_DONE;
   }
 
-  AIOThreadInfo(AIO_Reqs *thr_req, int sleep) : Continuation(new_ProxyMutex()), req(thr_req), sleep_wait(sleep)
+  AIOThreadInfo(AIO_Reqs *thr_req, int sleep, int node = -1)
+    : Continuation(new_ProxyMutex()), req(thr_req), sleep_wait(sleep), numa_node(node)
   {
     SET_HANDLER(&AIOThreadInfo::start);
   }
@@ -316,13 +325,14 @@ aio_init_fildes(int fildes, int fromAPI = 0)
   /* create the main thread */
   AIOThreadInfo *thr_info;
   size_t         stacksize;
+  int            numa_node = (aio_numa && fildes >= 0) ? ink_fd_numa_node(fildes) : -1;
 
   REC_ReadConfigInteger(stacksize, "proxy.config.thread.default.stacksize");
   for (i = 0; i < thread_num; i++) {
     if (i == (thread_num - 1)) {
-      thr_info = new AIOThreadInfo(request, 1);
+      thr_info = new AIOThreadInfo(request, 1, numa_node);
     } else {
-      thr_info = new AIOThreadInfo(request, 0);
+      thr_info = new AIOThreadInfo(request, 0, numa_node);
     }
     snprintf(thr_name, MAX_THREAD_NAME_LENGTH, "[ET_AIO %d:%d]", i, fildes);
     ink_assert(eventProcessor.spawn_thread(thr_info, thr_name, stacksize));
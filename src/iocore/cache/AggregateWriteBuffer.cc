@@ -27,6 +27,87 @@
 
 #include <cstring>
 
+char *
+AggregateWriteBuffer::allocate_block()
+{
+  char *block = static_cast<char *>(ats_memalign(ats_pagesize(), AGG_SIZE));
+  memset(block, 0, AGG_SIZE);
+  return block;
+}
+
+AggregateWriteBuffer::~AggregateWriteBuffer()
+{
+  // Blocks of writes still in flight belong to the AIO until it completes,
+  // which can only happen at shutdown.
+  ats_free(this->_buffer);
+  for (char *block : this->_free_blocks) {
+    ats_free(block);
+  }
+}
+
+void
+AggregateWriteBuffer::set_depth(int depth)
+{
+  ink_assert(depth >= 1 && this->_in_flight.empty());
+  while (static_cast<int>(this->_free_blocks.size()) + 1 < depth) {
+    this->_free_blocks.push_back(allocate_block());
+  }
+  while (static_cast<int>(this->_free_blocks.size()) + 1 > depth) {
+    ats_free(this->_free_blocks.back());
+    this->_free_blocks.pop_back();
+  }
+}
+
+void
+AggregateWriteBuffer::set_size(int size)
+{
+  ink_assert(size > 0 && size <= AGG_SIZE);
+  this->_size = size;
+}
+
+AggregateWriteBuffer::Write const &
+AggregateWriteBuffer::start_write(off_t offset)
+{
+  ink_assert(this->_buffer != nullptr);
+  this->_in_flight.push_back({this->_buffer, offset, this->_buffer_pos});
+  this->_bytes_in_flight += this->_buffer_pos;
+  this->_buffer_pos       = 0;
+  if (this->_free_blocks.empty()) {
+    this->_buffer = nullptr;
+  } else {
+    this->_buffer = this->_free_blocks.back();
+    this->_free_blocks.pop_back();
+  }
+  return this->_in_flight.back();
+}
+
+void
+AggregateWriteBuffer::finish_write()
+{
+  ink_assert(!this->_in_flight.empty());
+  Write const &w          = this->_in_flight.front();
+  this->_bytes_in_flight -= w.len;
+  if (this->_buffer == nullptr) {
+    this->_buffer = w.buffer;
+  } else {
+    this->_free_blocks.push_back(w.buffer);
+  }
+  this->_in_flight.pop_front();
+}
+
+bool
+AggregateWriteBuffer::copy_from_write(char *dest, off_t offset, size_t nbytes) const
+{
+  for (auto const &w : this->_in_flight) {
+    if (offset >= w.offset && offset < w.offset + w.len) {
+      ink_assert(offset + static_cast<off_t>(nbytes) <= w.offset + w.len);
+      memcpy(dest, w.buffer + (offset - w.offset), nbytes);
+      return true;
+    }
+  }
+  return false;
+}
+
 void
 AggregateWriteBuffer::add(Doc const *doc, int approx_size)
 {
@@ -47,6 +128,15 @@ AggregateWriteBuffer::emplace(int approx_size)
 bool
 AggregateWriteBuffer::flush(int fd, off_t write_pos) const
 {
+  for (auto const &w : this->_in_flight) {
+    if (pwrite(fd, w.buffer, w.len, w.offset) != w.len) {
+      ink_assert(!"flushing agg buffer failed");
+      return false;
+    }
+  }
+  if (this->_buffer_pos == 0) {
+    return true;
+  }
   int r = pwrite(fd, this->_buffer, this->_buffer_pos, write_pos);
   if (r != this->_buffer_pos) {
     ink_assert(!"flushing agg buffer failed");
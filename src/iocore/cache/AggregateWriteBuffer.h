@@ -31,22 +31,35 @@
 #include "tscore/List.h"
 
 #include <cstring>
+#include <deque>
+#include <vector>
 
-#define AGG_SIZE       (4 * 1024 * 1024) // 4MB
-#define AGG_HIGH_WATER (AGG_SIZE / 2)    // 2MB
+#define AGG_SIZE (4 * 1024 * 1024) // 4MB
 
 struct CacheVC;
 
+/**
+ * The aggregation buffers of a stripe.
+ *
+ * Documents are copied into the buffer being filled until it is handed over
+ * to a disk write with start_write. Aggregation then continues in the next
+ * free buffer of the ring while the write is in flight, so a ring of depth N
+ * allows N writes in flight. With a depth of 1 nothing can be aggregated until
+ * the write finishes. Writes are finished in the order they were started.
+ */
 class AggregateWriteBuffer
 {
 public:
-  AggregateWriteBuffer()
-  {
-    this->_buffer = static_cast<char *>(ats_memalign(ats_pagesize(), AGG_SIZE));
-    memset(this->_buffer, 0, AGG_SIZE);
-  }
+  /// A buffer handed over to a disk write.
+  struct Write {
+    char *buffer;
+    off_t offset; ///< Disk offset of the write.
+    int   len;
+  };
+
+  AggregateWriteBuffer() { this->_buffer = allocate_block(); }
 
-  ~AggregateWriteBuffer() { ats_free(this->_buffer); }
+  ~AggregateWriteBuffer();
 
   AggregateWriteBuffer(AggregateWriteBuffer const &)            = delete;
   AggregateWriteBuffer &operator=(AggregateWriteBuffer const &) = delete;
@@ -55,6 +68,71 @@ public:
   AggregateWriteBuffer(AggregateWriteBuffer &&other)            = delete;
   AggregateWriteBuffer &operator=(AggregateWriteBuffer &&other) = delete;
 
+  /**
+   * Set the number of buffers in the ring.
+   *
+   * This may only be called while no write is in flight.
+   *
+   * @param depth The number of buffers, at least 1.
+   */
+  void set_depth(int depth);
+
+  /**
+   * Set the size at which the buffer is considered full.
+   *
+   * All buffers have room for AGG_SIZE bytes so that a document of the
+   * maximum fragment size always fits into an empty buffer, a smaller
+   * size only limits how much is aggregated into a single write.
+   *
+   * @param size The target write size, at most AGG_SIZE.
+   */
+  void set_size(int size);
+  int  get_size() const;
+
+  /**
+   * Check whether there is a buffer to aggregate into.
+   *
+   * @return Returns false if all buffers of the ring are in flight.
+   */
+  bool can_aggregate() const;
+
+  /**
+   * Hand the buffer over to a disk write.
+   *
+   * The data remains available to copy_from_write until the write is
+   * finished. The buffer position is reset and aggregation continues in
+   * the next free buffer, if any.
+   *
+   * @param offset The disk offset the buffer is written to.
+   * @return Returns the write, valid until it is finished.
+   */
+  Write const &start_write(off_t offset);
+
+  /**
+   * Release the buffer of the oldest write in flight for reuse.
+   */
+  void finish_write();
+
+  /**
+   * The oldest and the newest write in flight.
+   *
+   * There must be at least one write in flight.
+   */
+  Write const &get_oldest_write() const;
+  Write const &get_newest_write() const;
+  int          get_writes_in_flight() const;
+  int          get_bytes_in_flight() const;
+
+  /**
+   * Copy part of a write in flight.
+   *
+   * @param dest: The destination buffer.
+   * @param offset: Disk offset to begin copying at.
+   * @param nbytes: Number of bytes to copy.
+   * @return Returns true if the range was found in a write in flight.
+   */
+  bool copy_from_write(char *dest, off_t offset, size_t nbytes) const;
+
   /**
    * Check whether the internal buffer is empty.
    *
@@ -114,7 +192,8 @@ public:
    *
    * Flushing the buffer only writes the buffer to disk; it does not
    * modify the contents of the buffer. To reset the buffer, call
-   * reset_buffer_pos().
+   * reset_buffer_pos(). Writes still in flight are written again at their
+   * own offsets first, as their completion can not be waited for.
    *
    * @param fd File descriptor to write to.
    * @param write_pos The offset at which to write the buffer data.
@@ -142,12 +221,54 @@ public:
   void                                     add_bytes_pending_aggregation(int size);
 
 private:
+  static char *allocate_block();
+
   Queue<CacheVC, Continuation::Link_link> _pending_writers;
   char                                   *_buffer                    = nullptr;
   int                                     _bytes_pending_aggregation = 0;
   int                                     _buffer_pos                = 0;
+  int                                     _size                      = AGG_SIZE;
+  int                                     _bytes_in_flight           = 0;
+  std::vector<char *>                     _free_blocks;
+  std::deque<Write>                       _in_flight;
 };
 
+inline int
+AggregateWriteBuffer::get_size() const
+{
+  return this->_size;
+}
+
+inline bool
+AggregateWriteBuffer::can_aggregate() const
+{
+  return this->_buffer != nullptr;
+}
+
+inline AggregateWriteBuffer::Write const &
+AggregateWriteBuffer::get_oldest_write() const
+{
+  return this->_in_flight.front();
+}
+
+inline AggregateWriteBuffer::Write const &
+AggregateWriteBuffer::get_newest_write() const
+{
+  return this->_in_flight.back();
+}
+
+inline int
+AggregateWriteBuffer::get_writes_in_flight() const
+{
+  return static_cast<int>(this->_in_flight.size());
+}
+
+inline int
+AggregateWriteBuffer::get_bytes_in_flight() const
+{
+  return this->_bytes_in_flight;
+}
+
 inline Queue<CacheVC, Continuation::Link_link> &
 AggregateWriteBuffer::get_pending_writers()
 {
@@ -58,6 +58,7 @@ int64_t cache_config_ram_cache_size                = AUTO_SIZE_RAM_CACHE;
 int     cache_config_ram_cache_algorithm           = 1;
 int     cache_config_ram_cache_compress            = 0;
 int     cache_config_ram_cache_compress_percent    = 90;
+int     cache_config_ram_cache_compress_threads    = 0;
 int     cache_config_ram_cache_use_seen_filter     = 1;
 int     cache_config_http_max_alts                 = 3;
 int     cache_config_log_alternate_eviction        = 0;
@@ -75,6 +76,9 @@ int     cache_config_hit_evacuate_size_limit       = 0;
 int     cache_config_force_sector_size             = 0;
 int     cache_config_target_fragment_size          = DEFAULT_TARGET_FRAGMENT_SIZE;
 int     cache_config_agg_write_backlog             = AGG_SIZE * 2;
+int     cache_config_agg_write_queue_depth         = 1;
+int     cache_config_agg_write_size                = AGG_SIZE;
+int     cache_config_stripe_early_online           = 0;
 int     cache_config_enable_checksum               = 0;
 int     cache_config_alt_rewrite_max_size          = 4096;
 int     cache_config_read_while_writer             = 0;
@@ -176,7 +180,15 @@ Cache::vol_initialized(bool result)
     ink_atomic_increment(&total_good_nvol, 1);
   }
   if (total_nvol == ink_atomic_increment(&total_initialized_vol, 1) + 1) {
-    open_done();
+    if (!cache_config_stripe_early_online) {
+      open_done();
+    } else {
+      // The cache is open already, the stripes came online one by one.
+      if (total_good_nvol == 0) {
+        Warning("no cache stripe could be brought online");
+      }
+      cacheProcessor.stripesInitialized();
+    }
   }
 }
 
@@ -220,7 +232,8 @@ Cache::open_done()
   Action *register_ShowCache(Continuation * c, HTTPHdr * h);
   Action *register_ShowCacheInternal(Continuation * c, HTTPHdr * h);
 
-  if (total_good_nvol == 0) {
+  // With early online stripes the cache opens before any stripe is initialized.
+  if (total_good_nvol == 0 && !cache_config_stripe_early_online) {
     ready = CACHE_INIT_FAILED;
     cacheProcessor.cacheInitialized();
     return 0;
@@ -277,6 +290,15 @@ Cache::open(bool clear, bool /* fix ATS_UNUSED */)
             cp->stripes[vol_no]->cache     = this;
             cp->stripes[vol_no]->cache_vol = cp;
 
+            char stripe_stat_prefix[256];
+            snprintf(stripe_stat_prefix, sizeof(stripe_stat_prefix), "proxy.process.cache.volume_%d.stripe_%d", cp->vol_number,
+                     vol_no);
+            cp->stripes[vol_no]->register_init_stats(stripe_stat_prefix);
+
+            if (cache_config_stripe_early_online) {
+              gstripes[gnstripes++] = cp->stripes[vol_no];
+            }
+
             bool vol_clear = clear || d->cleared || q->new_block;
             cp->stripes[vol_no]->init(vol_clear);
             vol_no++;
@@ -291,6 +313,12 @@ Cache::open(bool clear, bool /* fix ATS_UNUSED */)
     return open_done();
   }
   cache_read_done = 1;
+  // Open the cache now, the stripes are used as they come online and until
+  // then every operation on them misses.
+  if (cache_config_stripe_early_online) {
+    Note("cache opened with %d stripes still initializing", total_nvol - total_initialized_vol);
+    return open_done();
+  }
   return 0;
 }
 
@@ -309,7 +337,12 @@ Cache::lookup(Continuation *cont, const CacheKey *key, CacheFragType type, const
   }
 
   StripeSM *stripe = key_to_stripe(key, hostname, host_len);
-  CacheVC  *c      = new_CacheVC(cont);
+  if (!stripe->is_ready()) {
+    cont->handleEvent(CACHE_EVENT_LOOKUP_FAILED, nullptr);
+    return ACTION_RESULT_DONE;
+  }
+
+  CacheVC *c = new_CacheVC(cont);
   SET_CONTINUATION_HANDLER(c, &CacheVC::openReadStartHead);
   c->vio.op  = VIO::READ;
   c->op_type = static_cast<int>(CacheOpType::Lookup);
@@ -342,6 +375,13 @@ Cache::open_read(Continuation *cont, const CacheKey *key, CacheFragType type, co
   ProxyMutex   *mutex = cont->mutex.get();
   OpenDirEntry *od    = nullptr;
   CacheVC      *c     = nullptr;
+
+  if (!stripe->is_ready()) {
+    cont->handleEvent(CACHE_EVENT_OPEN_READ_FAILED, reinterpret_cast<void *>(-ECACHE_NOT_READY));
+    return ACTION_RESULT_DONE;
+  }
+
+  dir_prefetch(key, stripe);
   {
     CACHE_TRY_LOCK(lock, stripe->mutex, mutex->thread_holding);
     if (!lock.is_locked() || (od = stripe->open_read(key)) || dir_probe(key, stripe, &result, &last_collision)) {
@@ -360,6 +400,7 @@ Cache::open_read(Continuation *cont, const CacheKey *key, CacheFragType type, co
       goto Lmiss;
     }
     if (!lock.is_locked()) {
+      c->stripe_lock_missed();
       CONT_SCHED_LOCK_RETRY(c);
       return &c->_action;
     }
@@ -407,13 +448,18 @@ Cache::open_write(Continuation *cont, const CacheKey *key, CacheFragType frag_ty
 
   ink_assert(caches[frag_type] == this);
 
+  StripeSM *stripe = key_to_stripe(key, hostname, host_len);
+  if (!stripe->is_ready()) {
+    cont->handleEvent(CACHE_EVENT_OPEN_WRITE_FAILED, reinterpret_cast<void *>(-ECACHE_NOT_READY));
+    return ACTION_RESULT_DONE;
+  }
+
   intptr_t res = 0;
   CacheVC *c   = new_CacheVC(cont);
   SCOPED_MUTEX_LOCK(lock, c->mutex, this_ethread());
-  c->vio.op        = VIO::WRITE;
-  c->op_type       = static_cast<int>(CacheOpType::Write);
-  c->stripe        = key_to_stripe(key, hostname, host_len);
-  StripeSM *stripe = c->stripe;
+  c->vio.op  = VIO::WRITE;
+  c->op_type = static_cast<int>(CacheOpType::Write);
+  c->stripe  = stripe;
   ts::Metrics::Gauge::increment(cache_rsb.status[c->op_type].active);
   ts::Metrics::Gauge::increment(stripe->cache_vol->vol_rsb.status[c->op_type].active);
   c->first_key = c->key = *key;
@@ -473,6 +519,14 @@ Cache::remove(Continuation *cont, const CacheKey *key, CacheFragType type, const
     return ACTION_RESULT_DONE;
   }
 
+  StripeSM *stripe = key_to_stripe(key, hostname, host_len);
+  if (!stripe->is_ready()) {
+    if (cont) {
+      cont->handleEvent(CACHE_EVENT_REMOVE_FAILED, nullptr);
+    }
+    return ACTION_RESULT_DONE;
+  }
+
   Ptr<ProxyMutex> mutex;
   if (!cont) {
     cont = new_CacheRemoveCont();
@@ -480,7 +534,6 @@ Cache::remove(Continuation *cont, const CacheKey *key, CacheFragType type, const
 
   CACHE_TRY_LOCK(lock, cont->mutex, this_ethread());
   ink_assert(lock.is_locked());
-  StripeSM *stripe = key_to_stripe(key, hostname, host_len);
   // coverity[var_decl]
   Dir result;
   dir_clear(&result); // initialized here, set result empty so we can recognize missed lock
@@ -546,6 +599,12 @@ Cache::open_read(Continuation *cont, const CacheKey *key, CacheHTTPHdr *request,
   OpenDirEntry *od    = nullptr;
   CacheVC      *c     = nullptr;
 
+  if (!stripe->is_ready()) {
+    cont->handleEvent(CACHE_EVENT_OPEN_READ_FAILED, reinterpret_cast<void *>(-ECACHE_NOT_READY));
+    return ACTION_RESULT_DONE;
+  }
+
+  dir_prefetch(key, stripe);
   {
     CACHE_TRY_LOCK(lock, stripe->mutex, mutex->thread_holding);
     if (!lock.is_locked() || (od = stripe->open_read(key)) || dir_probe(key, stripe, &result, &last_collision)) {
@@ -615,6 +674,13 @@ Cache::open_write(Continuation *cont, const CacheKey *key, CacheHTTPInfo *info,
   }
 
   ink_assert(caches[type] == this);
+
+  StripeSM *stripe = key_to_stripe(key, hostname, host_len);
+  if (!stripe->is_ready()) {
+    cont->handleEvent(CACHE_EVENT_OPEN_WRITE_FAILED, reinterpret_cast<void *>(-ECACHE_NOT_READY));
+    return ACTION_RESULT_DONE;
+  }
+
   intptr_t err        = 0;
   int      if_writers = reinterpret_cast<uintptr_t>(info) == CACHE_ALLOW_MULTIPLE_WRITES;
   CacheVC *c          = new_CacheVC(cont);
@@ -630,11 +696,10 @@ Cache::open_write(Continuation *cont, const CacheKey *key, CacheHTTPInfo *info,
   do {
     rand_CacheKey(&c->key);
   } while (DIR_MASK_TAG(c->key.slice32(2)) == DIR_MASK_TAG(c->first_key.slice32(2)));
-  c->earliest_key  = c->key;
-  c->frag_type     = CACHE_FRAG_TYPE_HTTP;
-  c->stripe        = key_to_stripe(key, hostname, host_len);
-  StripeSM *stripe = c->stripe;
-  c->info          = info;
+  c->earliest_key = c->key;
+  c->frag_type    = CACHE_FRAG_TYPE_HTTP;
+  c->stripe       = stripe;
+  c->info         = info;
   if (c->info && reinterpret_cast<uintptr_t>(info) != CACHE_ALLOW_MULTIPLE_WRITES) {
     /*
        Update has the following code paths :
@@ -679,6 +744,15 @@ Cache::open_write(Continuation *cont, const CacheKey *key, CacheHTTPInfo *info,
   // coverity[Y2K38_SAFETY:FALSE]
   c->pin_in_cache = static_cast<uint32_t>(apin_in_cache);
 
+  // A second writer fails anyway, find that out without waiting on the stripe lock.
+  if (!if_writers && stripe->open_dir.has_writer(key)) {
+    ts::Metrics::Counter::increment(cache_rsb.write_busy_lockless);
+    ts::Metrics::Counter::increment(stripe->cache_vol->vol_rsb.write_busy_lockless);
+    err = ECACHE_DOC_BUSY;
+    goto Lfailure;
+  }
+
+  dir_prefetch(key, stripe);
   {
     CACHE_TRY_LOCK(lock, c->stripe->mutex, cont->mutex->thread_holding);
     if (lock.is_locked()) {
@@ -715,6 +789,7 @@ Cache::open_write(Continuation *cont, const CacheKey *key, CacheHTTPInfo *info,
       }
     }
     // missed lock
+    c->stripe_lock_missed();
     SET_CONTINUATION_HANDLER(c, &CacheVC::openWriteStartDone);
     CONT_SCHED_LOCK_RETRY(c);
     return &c->_action;
@@ -746,6 +821,27 @@ Lcallreturn:
 // CacheVConnection
 CacheVConnection::CacheVConnection() : VConnection(nullptr) {}
 
+namespace
+{
+// Count whether the stripe is used from the NUMA node of its disk, only known in NUMA mode.
+StripeSM *
+count_numa_access(StripeSM *stripe)
+{
+  int node = ink_numa_node();
+
+  if (node >= 0 && stripe->disk->numa_node >= 0) {
+    if (node == stripe->disk->numa_node) {
+      ts::Metrics::Counter::increment(cache_rsb.numa_local_access);
+      ts::Metrics::Counter::increment(stripe->cache_vol->vol_rsb.numa_local_access);
+    } else {
+      ts::Metrics::Counter::increment(cache_rsb.numa_remote_access);
+      ts::Metrics::Counter::increment(stripe->cache_vol->vol_rsb.numa_remote_access);
+    }
+  }
+  return stripe;
+}
+} // namespace
+
 // if generic_host_rec.stripes == nullptr, what do we do???
 StripeSM *
 Cache::key_to_stripe(const CacheKey *key, const char *hostname, int host_len) const
@@ -767,7 +863,7 @@ Cache::key_to_stripe(const CacheKey *key, const char *hostname, int host_len) co
           snprintf(format_str, sizeof(format_str), "Volume: %%xd for host: %%.%ds", host_len);
           Dbg(dbg_ctl_cache_hosting, format_str, res.record, hostname);
         }
-        return res.record->stripes[host_hash_table[h]];
+        return count_numa_access(res.record->stripes[host_hash_table[h]]);
       }
     }
   }
@@ -777,9 +873,9 @@ Cache::key_to_stripe(const CacheKey *key, const char *hostname, int host_len) co
       snprintf(format_str, sizeof(format_str), "Generic volume: %%xd for host: %%.%ds", host_len);
       Dbg(dbg_ctl_cache_hosting, format_str, host_rec, hostname);
     }
-    return host_rec->stripes[hash_table[h]];
+    return count_numa_access(host_rec->stripes[hash_table[h]]);
   } else {
-    return host_rec->stripes[0];
+    return count_numa_access(host_rec->stripes[0]);
   }
 }
 
@@ -808,6 +904,7 @@ ink_cache_init(ts::ModuleVersion v)
   REC_EstablishStaticConfigInt32(cache_config_ram_cache_algorithm, "proxy.config.cache.ram_cache.algorithm");
   REC_EstablishStaticConfigInt32(cache_config_ram_cache_compress, "proxy.config.cache.ram_cache.compress");
   REC_EstablishStaticConfigInt32(cache_config_ram_cache_compress_percent, "proxy.config.cache.ram_cache.compress_percent");
+  REC_EstablishStaticConfigInt32(cache_config_ram_cache_compress_threads, "proxy.config.cache.ram_cache.compress_threads");
   REC_ReadConfigInt32(cache_config_ram_cache_use_seen_filter, "proxy.config.cache.ram_cache.use_seen_filter");
 
   REC_EstablishStaticConfigInt32(cache_config_http_max_alts, "proxy.config.cache.limits.http.max_alts");
@@ -873,6 +970,19 @@ ink_cache_init(ts::ModuleVersion v)
   REC_EstablishStaticConfigInt32(cache_config_agg_write_backlog, "proxy.config.cache.agg_write_backlog");
   Dbg(dbg_ctl_cache_init, "proxy.config.cache.agg_write_backlog = %d", cache_config_agg_write_backlog);
 
+  REC_ReadConfigInt32(cache_config_agg_write_queue_depth, "proxy.config.cache.agg_write_queue_depth");
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.agg_write_queue_depth = %d", cache_config_agg_write_queue_depth);
+
+  REC_ReadConfigInt32(cache_config_agg_write_size, "proxy.config.cache.agg_write_size");
+  if (cache_config_agg_write_size < STORE_BLOCK_SIZE || cache_config_agg_write_size > AGG_SIZE) {
+    Warning("proxy.config.cache.agg_write_size must be between %d and %d, using %d", STORE_BLOCK_SIZE, AGG_SIZE, AGG_SIZE);
+    cache_config_agg_write_size = AGG_SIZE;
+  }
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.agg_write_size = %d", cache_config_agg_write_size);
+
+  REC_ReadConfigInt32(cache_config_stripe_early_online, "proxy.config.cache.stripe_early_online");
+  Dbg(dbg_ctl_cache_init, "proxy.config.cache.stripe_early_online = %d", cache_config_stripe_early_online);
+
   REC_EstablishStaticConfigInt32(cache_config_enable_checksum, "proxy.config.cache.enable_checksum");
   Dbg(dbg_ctl_cache_init, "proxy.config.cache.enable_checksum = %d", cache_config_enable_checksum);
 
@@ -31,6 +31,8 @@
 #include "tscore/hugepages.h"
 #include "tscore/Random.h"
 
+#include <algorithm>
+
 #ifdef LOOP_CHECK_MODE
 #define DIR_LOOP_THRESHOLD 1000
 #endif
@@ -107,6 +109,7 @@ OpenDir::open_write(CacheVC *cont, int allow_if_writers, int max_writers)
   cont->od           = od;
   cont->write_vector = &od->vector;
   bucket[b].push(od);
+  _swap_writer_slot(b, CryptoHash(), cont->first_key);
   return 1;
 }
 
@@ -146,6 +149,7 @@ OpenDir::close_write(CacheVC *cont)
     unsigned int h = cont->first_key.slice32(0);
     int          b = h % OPEN_DIR_BUCKETS;
     bucket[b].remove(cont->od);
+    _swap_writer_slot(b, cont->first_key, CryptoHash());
     delayed_readers.append(cont->od->readers);
     signal_readers(0, nullptr);
     cont->od->vector.clear();
@@ -168,6 +172,56 @@ OpenDir::open_read(const CryptoHash *key) const
   return nullptr;
 }
 
+bool
+OpenDir::has_writer(const CryptoHash *key) const
+{
+  const WriterSlots &slots = _writer_slots[key->slice32(0) % OPEN_DIR_BUCKETS];
+  uint32_t           seq   = slots.seq.load(std::memory_order_acquire);
+  bool               found = false;
+
+  if (seq & 1) {
+    return false;
+  }
+  for (auto const &slot : slots.key) {
+    int i = 0;
+    while (i < KEY_WORDS && slot[i].load(std::memory_order_relaxed) == key->u64[i]) {
+      ++i;
+    }
+    if (i == KEY_WORDS) {
+      found = true;
+      break;
+    }
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return found && slots.seq.load(std::memory_order_relaxed) == seq;
+}
+
+// Replace the slot holding @a from with @a to, the stripe lock serializes the updates of a bucket.
+// A full bucket leaves the key unpublished, has_writer() then reports it as unknown.
+void
+OpenDir::_swap_writer_slot(int b, const CryptoHash &from, const CryptoHash &to)
+{
+  WriterSlots &slots = _writer_slots[b];
+
+  for (auto &slot : slots.key) {
+    int i = 0;
+    while (i < KEY_WORDS && slot[i].load(std::memory_order_relaxed) == from.u64[i]) {
+      ++i;
+    }
+    if (i < KEY_WORDS) {
+      continue;
+    }
+    uint32_t seq = slots.seq.load(std::memory_order_relaxed);
+    slots.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (i = 0; i < KEY_WORDS; ++i) {
+      slot[i].store(to.u64[i], std::memory_order_relaxed);
+    }
+    slots.seq.store(seq + 2, std::memory_order_release);
+    return;
+  }
+}
+
 int
 OpenDirEntry::wait(CacheVC *cont, int msec)
 {
@@ -222,6 +276,7 @@ dir_init_segment(int s, Stripe *stripe)
   stripe->directory.header->freelist[s] = 0;
   Dir *seg                              = stripe->directory.get_segment(s);
   int  l, b;
+  stripe->directory.mark_dirty(s);
   memset(static_cast<void *>(seg), 0, SIZEOF_DIR * DIR_DEPTH * stripe->directory.buckets);
   for (l = 1; l < DIR_DEPTH; l++) {
     for (b = 0; b < stripe->directory.buckets; b++) {
@@ -308,6 +363,7 @@ unlink_from_freelist(Dir *e, int s, Stripe *stripe)
 {
   Dir *seg = stripe->directory.get_segment(s);
   Dir *p   = dir_from_offset(dir_prev(e), seg);
+  stripe->directory.mark_dirty(s);
   if (p) {
     dir_set_next(p, dir_next(e));
   } else {
@@ -325,6 +381,7 @@ dir_delete_entry(Dir *e, Dir *p, int s, Stripe *stripe)
   Dir *seg                        = stripe->directory.get_segment(s);
   int  no                         = dir_next(e);
   stripe->directory.header->dirty = 1;
+  stripe->directory.mark_dirty(s);
   if (p) {
     unsigned int fo = stripe->directory.header->freelist[s];
     unsigned int eo = dir_to_offset(e, seg);
@@ -404,12 +461,14 @@ dir_clean_vol(Stripe *stripe)
 void
 dir_clear_range(off_t start, off_t end, Stripe *stripe)
 {
+  off_t const segment_entries = stripe->directory.buckets * DIR_DEPTH;
   for (off_t i = 0; i < stripe->directory.entries(); i++) {
     Dir *e = dir_index(stripe, i);
     if (dir_offset(e) >= static_cast<int64_t>(start) && dir_offset(e) < static_cast<int64_t>(end)) {
       ts::Metrics::Gauge::decrement(cache_rsb.direntries_used);
       ts::Metrics::Gauge::decrement(stripe->cache_vol->vol_rsb.direntries_used);
       dir_set_offset(e, 0); // delete
+      stripe->directory.mark_dirty(i / segment_entries);
     }
   }
   dir_clean_vol(stripe);
@@ -438,6 +497,7 @@ freelist_clean(int s, StripeSM *stripe)
   Warning("cache directory overflow on '%s' segment %d, purging...", stripe->disk->path, s);
   int  n   = 0;
   Dir *seg = stripe->directory.get_segment(s);
+  stripe->directory.mark_dirty(s);
   for (int bi = 0; bi < stripe->directory.buckets; bi++) {
     Dir *b = dir_bucket(bi, seg);
     for (int l = 0; l < DIR_DEPTH; l++) {
@@ -462,6 +522,7 @@ freelist_pop(int s, StripeSM *stripe)
     return nullptr;
   }
   stripe->directory.header->freelist[s] = dir_next(e);
+  stripe->directory.mark_dirty(s);
   // if the freelist if bad, punt.
   if (dir_offset(e)) {
     dir_init_segment(s, stripe);
@@ -480,6 +541,7 @@ dir_free_entry(Dir *e, int s, Stripe *stripe)
   Dir         *seg = stripe->directory.get_segment(s);
   unsigned int fo  = stripe->directory.header->freelist[s];
   unsigned int eo  = dir_to_offset(e, seg);
+  stripe->directory.mark_dirty(s);
   dir_set_next(e, fo);
   if (fo) {
     dir_set_prev(dir_from_offset(fo, seg), eo);
@@ -487,13 +549,30 @@ dir_free_entry(Dir *e, int s, Stripe *stripe)
   stripe->directory.header->freelist[s] = eo;
 }
 
+/*
+   Start loading the bucket of @a key while the caller is still going for
+   the stripe lock. This does not touch the directory, only the address is
+   computed, so it is safe without the lock. A bucket is 40 bytes and can
+   straddle two cache lines.
+   */
+void
+dir_prefetch(const CacheKey *key, const Stripe *stripe)
+{
+  int         s = key->slice32(0) % stripe->directory.segments;
+  int         b = key->slice32(1) % stripe->directory.buckets;
+  const char *e = reinterpret_cast<const char *>(dir_bucket(b, stripe->directory.get_segment(s)));
+  __builtin_prefetch(e);
+  __builtin_prefetch(e + SIZEOF_DIR * DIR_DEPTH - 1);
+}
+
 int
 dir_probe(const CacheKey *key, StripeSM *stripe, Dir *result, Dir **last_collision)
 {
   ink_assert(stripe->mutex->thread_holding == this_ethread());
-  int  s   = key->slice32(0) % stripe->directory.segments;
-  int  b   = key->slice32(1) % stripe->directory.buckets;
-  Dir *seg = stripe->directory.get_segment(s);
+  int      s   = key->slice32(0) % stripe->directory.segments;
+  int      b   = key->slice32(1) % stripe->directory.buckets;
+  uint32_t tag = DIR_MASK_TAG(key->slice32(2));
+  Dir     *seg = stripe->directory.get_segment(s);
   Dir *e = nullptr, *p = nullptr, *collision = *last_collision;
   CHECK_DIR(d);
 #ifdef LOOP_CHECK_MODE
@@ -504,7 +583,7 @@ Lagain:
   e = dir_bucket(b, seg);
   if (dir_offset(e)) {
     do {
-      if (dir_compare_tag(e, key)) {
+      if (dir_tag(e) == tag) {
         ink_assert(dir_offset(e));
         // Bug: 51680. Need to check collision before checking
         // dir_valid(). In case of a collision, if !dir_valid(), we
@@ -537,7 +616,7 @@ Lagain:
           continue;
         }
       } else {
-        DDbg(dbg_ctl_dir_probe_tag, "tag mismatch %p %X vs expected %X", e, dir_tag(e), key->slice32(3));
+        DDbg(dbg_ctl_dir_probe_tag, "tag mismatch %p %X vs expected %X", e, dir_tag(e), tag);
       }
     Lcont:
       p = e;
@@ -618,6 +697,7 @@ Lfill:
        bi, e, key->slice32(1), dir_tag(e), dir_offset(e));
   CHECK_DIR(d);
   stripe->directory.header->dirty = 1;
+  stripe->directory.mark_dirty(s);
   ts::Metrics::Gauge::increment(cache_rsb.direntries_used);
   ts::Metrics::Gauge::increment(stripe->cache_vol->vol_rsb.direntries_used);
 
@@ -709,6 +789,7 @@ Lfill:
        stripe->fd, bi, e, t, dir_tag(e), dir_offset(e));
   CHECK_DIR(d);
   stripe->directory.header->dirty = 1;
+  stripe->directory.mark_dirty(s);
   return res;
 }
 
@@ -922,11 +1003,54 @@ sync_cache_dir_on_shutdown()
   Dbg(dbg_ctl_cache_dir_sync, "sync started");
   EThread *t = reinterpret_cast<EThread *>(0xdeadbeef);
   for (int i = 0; i < gnstripes; i++) {
-    gstripes[i]->shutdown(t);
+    // The directory of a stripe still initializing is not complete.
+    if (gstripes[i]->is_ready()) {
+      gstripes[i]->shutdown(t);
+    }
   }
   Dbg(dbg_ctl_cache_dir_sync, "sync done");
 }
 
+/*
+   Copy the parts of the directory that are to be written to @a copy to buf,
+   at the same offsets they have in the directory. That is the header, the
+   freelists, the footer and every segment changed since the last sync of this
+   copy. The other segments already match what is on disk.
+ */
+void
+CacheSync::snapshot(Stripe *stripe, int copy)
+{
+  off_t const footerlen = ROUND_TO_STORE_BLOCK(sizeof(StripteHeaderFooter));
+  off_t const dirlen    = stripe->dirlen();
+  off_t const seglen    = stripe->directory.buckets * DIR_DEPTH * SIZEOF_DIR;
+  off_t const segstart  = stripe->headerlen();
+
+  ranges.clear();
+  range_index = 0;
+  if (segstart > footerlen) {
+    ranges.emplace_back(footerlen, segstart);
+  }
+  for (int s = 0; s < stripe->directory.segments; s++) {
+    if (!(stripe->directory.dirty_segments[s] & copy)) {
+      continue;
+    }
+    stripe->directory.dirty_segments[s] &= ~copy;
+    off_t b = std::max(footerlen, (segstart + s * seglen) / STORE_BLOCK_SIZE * STORE_BLOCK_SIZE);
+    off_t e = std::min(dirlen - footerlen, static_cast<off_t>(ROUND_TO_STORE_BLOCK(segstart + (s + 1) * seglen)));
+    if (!ranges.empty() && b <= ranges.back().second) {
+      ranges.back().second = e;
+    } else {
+      ranges.emplace_back(b, e);
+    }
+  }
+
+  memcpy(buf, stripe->directory.raw_dir, footerlen);
+  for (auto const &[b, e] : ranges) {
+    memcpy(buf + b, stripe->directory.raw_dir + b, e - b);
+  }
+  memcpy(buf + dirlen - footerlen, stripe->directory.raw_dir + dirlen - footerlen, footerlen);
+}
+
 int
 CacheSync::mainEvent(int event, Event *e)
 {
@@ -963,8 +1087,10 @@ Lrestart:
     // AIO Thread
     if (!io.ok()) {
       Warning("vol write error during directory sync '%s'", gstripes[stripe_index]->hash_text.get());
-      event = EVENT_NONE;
-      goto Ldone;
+      // The segments left out of this copy are marked again under the stripe lock.
+      failed  = true;
+      trigger = eventProcessor.schedule_imm(this);
+      return EVENT_CONT;
     }
     ts::Metrics::Counter::increment(cache_rsb.directory_sync_bytes, io.aio_result);
     ts::Metrics::Counter::increment(stripe->cache_vol->vol_rsb.directory_sync_bytes, io.aio_result);
@@ -982,9 +1108,19 @@ Lrestart:
       start_time = ink_get_hrtime();
     }
 
+    if (failed) {
+      // Nothing is known about what reached the disk, write it all next time.
+      failed = false;
+      stripe->directory.mark_all_dirty();
+      stripe->directory.header->dirty = 1;
+      stripe->dir_sync_in_progress    = false;
+      start_time                      = 0;
+      goto Ldone;
+    }
+
     stripe->recompute_hit_evacuate_window();
 
-    if (DISK_BAD(stripe->disk)) {
+    if (DISK_BAD(stripe->disk) || !stripe->is_ready()) {
       goto Ldone;
     }
 
@@ -1002,7 +1138,7 @@ Lrestart:
         Dbg(dbg_ctl_cache_dir_sync, "Dir %s not dirty", stripe->hash_text.get());
         goto Ldone;
       }
-      if (stripe->is_io_in_progress() || stripe->get_agg_buf_pos()) {
+      if (stripe->is_io_in_progress() || stripe->get_agg_writes_in_flight() || stripe->get_agg_buf_pos()) {
         Dbg(dbg_ctl_cache_dir_sync, "Dir %s: waiting for agg buffer", stripe->hash_text.get());
         stripe->dir_sync_waiting = true;
         if (!stripe->is_io_in_progress()) {
@@ -1035,27 +1171,34 @@ Lrestart:
       stripe->directory.header->sync_serial++;
       stripe->directory.footer->sync_serial = stripe->directory.header->sync_serial;
       CHECK_DIR(d);
-      memcpy(buf, stripe->directory.raw_dir, dirlen);
+      snapshot(stripe, (stripe->directory.header->sync_serial & 1) ? DIR_SYNC_COPY_B : DIR_SYNC_COPY_A);
       stripe->dir_sync_in_progress = true;
+      Dbg(dbg_ctl_cache_dir_sync, "Dir %s: writing %zu ranges", stripe->hash_text.get(), ranges.size());
     }
     size_t B     = stripe->directory.header->sync_serial & 1;
     off_t  start = stripe->skip + (B ? dirlen : 0);
 
+    /* The header goes first and the footer last, a copy is only used by
+       recovery if the sync serial of both match, so a copy cut short by a
+       crash is passed over for the other one.
+     */
     if (!writepos) {
       // write header
       aio_write(stripe->fd, buf + writepos, headerlen, start + writepos);
       writepos += headerlen;
-    } else if (writepos < static_cast<off_t>(dirlen) - headerlen) {
-      // write part of body
-      int l = cache_config_dir_sync_max_write;
-      if (writepos + l > static_cast<off_t>(dirlen) - headerlen) {
-        l = dirlen - headerlen - writepos;
-      }
+    } else if (range_index < ranges.size()) {
+      // write part of a changed range of the body
+      auto const &[range_start, range_end] = ranges[range_index];
+      writepos                             = std::max(writepos, range_start);
+      int l                                = std::min(static_cast<off_t>(cache_config_dir_sync_max_write), range_end - writepos);
       aio_write(stripe->fd, buf + writepos, l, start + writepos);
       writepos += l;
+      if (writepos >= range_end) {
+        ++range_index;
+      }
     } else if (writepos < static_cast<off_t>(dirlen)) {
-      ink_assert(writepos == (off_t)dirlen - headerlen);
       // write footer
+      writepos = dirlen - headerlen;
       aio_write(stripe->fd, buf + writepos, headerlen, start + writepos);
       writepos += headerlen;
     } else {
@@ -25,6 +25,8 @@
 #include "P_CacheInternal.h"
 #include "StripeSM.h"
 
+#include "tscore/ink_hw.h"
+
 void
 CacheDisk::incrErrors(const AIOCallback *io)
 {
@@ -60,6 +62,7 @@ CacheDisk::open(char *s, off_t blocks, off_t askip, int ahw_sector_size, int fil
   path           = ats_strdup(s);
   hw_sector_size = ahw_sector_size;
   fd             = fildes;
+  numa_node      = ink_fd_numa_node(fildes);
   skip           = askip;
   start          = skip;
   /* we can't use fractions of store blocks. */
@@ -185,6 +185,16 @@ CacheHostMatcher::NewEntry(matcher_line *line_info)
   return;
 }
 
+// void CacheHostMatcher::Finalize()
+//
+//  Builds the lookup trie once all the entries are in
+//
+void
+CacheHostMatcher::Finalize()
+{
+  host_lookup->Finalize();
+}
+
 /*************************************************************
  *   End class HostMatcher
  *************************************************************/
@@ -383,6 +393,10 @@ CacheHostTable::BuildTableFromString(const char *config_file_path, char *file_bu
     ats_free(last);
   }
 
+  if (hostMatch != nullptr) {
+    hostMatch->Finalize();
+  }
+
   Note("%s finished loading", ts::filename::HOSTING);
 
   if (!generic_rec_initd) {
@@ -158,7 +158,7 @@ CachePeriodicMetricsUpdate()
 inline int64_t
 cache_bytes_used(int index)
 {
-  if (!DISK_BAD(gstripes[index]->disk)) {
+  if (!DISK_BAD(gstripes[index]->disk) && gstripes[index]->is_ready()) {
     if (!gstripes[index]->directory.header->cycle) {
       return gstripes[index]->directory.header->write_pos - gstripes[index]->start;
     } else {
@@ -275,7 +275,9 @@ CacheProcessor::start_internal(int flags)
         if (check) {
           cache_disk->read_only_p = true;
         }
-        cache_disk->forced_volume_num = span->forced_volume_num;
+        cache_disk->forced_volume_num     = span->forced_volume_num;
+        cache_disk->agg_write_size        = span->agg_write_size;
+        cache_disk->agg_write_queue_depth = span->agg_write_queue_depth;
         if (span->hash_base_string) {
           cache_disk->hash_base_string = ats_strdup(span->hash_base_string);
         }
@@ -362,7 +364,9 @@ int
 CacheProcessor::dir_check(bool /* afix ATS_UNUSED */)
 {
   for (int i = 0; i < gnstripes; i++) {
-    gstripes[i]->dir_check();
+    if (gstripes[i]->is_ready()) {
+      gstripes[i]->dir_check();
+    }
   }
   return 0;
 }
@@ -456,8 +460,10 @@ CacheProcessor::mark_storage_offline(CacheDisk *d, ///< Target disk
 
   for (p = 0; p < gnstripes; p++) {
     if (d->fd == gstripes[p]->fd) {
-      total_dir_delete   += gstripes[p]->directory.entries();
-      used_dir_delete    += dir_entries_used(gstripes[p]);
+      total_dir_delete += gstripes[p]->directory.entries();
+      if (gstripes[p]->is_ready()) {
+        used_dir_delete += dir_entries_used(gstripes[p]);
+      }
       total_bytes_delete += gstripes[p]->len - gstripes[p]->dirlen();
     }
   }
@@ -1134,6 +1140,7 @@ register_cache_stats(CacheStatsBlock *rsb, const std::string &prefix)
   rsb->bytes_used            = ts::Metrics::Gauge::createPtr(prefix + ".bytes_used");
   rsb->bytes_total           = ts::Metrics::Gauge::createPtr(prefix + ".bytes_total");
   rsb->stripes               = ts::Metrics::Gauge::createPtr(prefix + ".stripes");
+  rsb->stripes_online        = ts::Metrics::Gauge::createPtr(prefix + ".stripes_online");
   rsb->ram_cache_bytes_total = ts::Metrics::Gauge::createPtr(prefix + ".ram_cache.total_bytes");
   rsb->ram_cache_bytes       = ts::Metrics::Gauge::createPtr(prefix + ".ram_cache.bytes_used");
   rsb->ram_cache_hits        = ts::Metrics::Counter::createPtr(prefix + ".ram_cache.hits");
@@ -1158,6 +1165,11 @@ register_cache_stats(CacheStatsBlock *rsb, const std::string &prefix)
   rsb->directory_sync_count  = ts::Metrics::Counter::createPtr(prefix + ".sync.count");
   rsb->directory_sync_bytes  = ts::Metrics::Counter::createPtr(prefix + ".sync.bytes");
   rsb->directory_sync_time   = ts::Metrics::Counter::createPtr(prefix + ".sync.time");
+  rsb->stripe_lock_miss      = ts::Metrics::Counter::createPtr(prefix + ".stripe_lock.miss");
+  rsb->stripe_lock_wait_time = ts::Metrics::Counter::createPtr(prefix + ".stripe_lock.wait_time");
+  rsb->numa_local_access     = ts::Metrics::Counter::createPtr(prefix + ".numa.local_access");
+  rsb->numa_remote_access    = ts::Metrics::Counter::createPtr(prefix + ".numa.remote_access");
+  rsb->write_busy_lockless   = ts::Metrics::Counter::createPtr(prefix + ".write.busy.lockless");
   rsb->span_errors_read      = ts::Metrics::Counter::createPtr(prefix + ".span.errors.read");
   rsb->span_errors_write     = ts::Metrics::Counter::createPtr(prefix + ".span.errors.write");
   rsb->span_failing          = ts::Metrics::Gauge::createPtr(prefix + ".span.failing");
@@ -1386,6 +1398,24 @@ fillExclusiveDisks(CacheVol *cp)
   return diskCount;
 }
 
+static void
+update_stripe_versions()
+{
+  if (gnstripes) { // start with whatever the first stripe is.
+    cacheProcessor.min_stripe_version = cacheProcessor.max_stripe_version = gstripes[0]->directory.header->version;
+  }
+  // scan the rest of the stripes.
+  for (int i = 1; i < gnstripes; i++) {
+    StripeSM *v = gstripes[i];
+    if (v->directory.header->version < cacheProcessor.min_stripe_version) {
+      cacheProcessor.min_stripe_version = v->directory.header->version;
+    }
+    if (cacheProcessor.max_stripe_version < v->directory.header->version) {
+      cacheProcessor.max_stripe_version = v->directory.header->version;
+    }
+  }
+}
+
 void
 CacheProcessor::cacheInitialized()
 {
@@ -1418,19 +1448,9 @@ CacheProcessor::cacheInitialized()
     caches[CACHE_FRAG_TYPE_NONE] = theCache;
   }
 
-  // Update stripe version data.
-  if (gnstripes) { // start with whatever the first stripe is.
-    cacheProcessor.min_stripe_version = cacheProcessor.max_stripe_version = gstripes[0]->directory.header->version;
-  }
-  // scan the rest of the stripes.
-  for (int i = 1; i < gnstripes; i++) {
-    StripeSM *v = gstripes[i];
-    if (v->directory.header->version < cacheProcessor.min_stripe_version) {
-      cacheProcessor.min_stripe_version = v->directory.header->version;
-    }
-    if (cacheProcessor.max_stripe_version < v->directory.header->version) {
-      cacheProcessor.max_stripe_version = v->directory.header->version;
-    }
+  // Early online stripes are not read yet, see stripesInitialized.
+  if (!cache_config_stripe_early_online) {
+    update_stripe_versions();
   }
 
   if (caches_ready) {
@@ -1448,6 +1468,9 @@ CacheProcessor::cacheInitialized()
         case RAM_CACHE_ALGORITHM_LRU:
           gstripes[i]->ram_cache = new_RamCacheLRU();
           break;
+        case RAM_CACHE_ALGORITHM_TINYLFU:
+          gstripes[i]->ram_cache = new_RamCacheTinyLFU();
+          break;
         }
       }
 
@@ -1518,9 +1541,12 @@ CacheProcessor::cacheInitialized()
         total_direntries              += vol_total_direntries;
         ts::Metrics::Gauge::increment(stripe->cache_vol->vol_rsb.direntries_total, vol_total_direntries);
 
-        uint64_t vol_used_direntries = dir_entries_used(stripe);
-        ts::Metrics::Gauge::increment(stripe->cache_vol->vol_rsb.direntries_used, vol_used_direntries);
-        used_direntries += vol_used_direntries;
+        // Early online stripes count their entries once they are ready.
+        if (!cache_config_stripe_early_online) {
+          uint64_t vol_used_direntries = dir_entries_used(stripe);
+          ts::Metrics::Gauge::increment(stripe->cache_vol->vol_rsb.direntries_used, vol_used_direntries);
+          used_direntries += vol_used_direntries;
+        }
       }
 
       switch (cache_config_ram_cache_compress) {
@@ -1541,7 +1567,9 @@ CacheProcessor::cacheInitialized()
       ts::Metrics::Gauge::store(cache_rsb.ram_cache_bytes_total, total_ram_cache_bytes);
       ts::Metrics::Gauge::store(cache_rsb.bytes_total, total_cache_bytes);
       ts::Metrics::Gauge::store(cache_rsb.direntries_total, total_direntries);
-      ts::Metrics::Gauge::store(cache_rsb.direntries_used, used_direntries);
+      if (!cache_config_stripe_early_online) {
+        ts::Metrics::Gauge::store(cache_rsb.direntries_used, used_direntries);
+      }
 
       if (!check) {
         dir_sync_init();
@@ -1571,3 +1599,14 @@ CacheProcessor::cacheInitialized()
     Emergency("Cache initialization failed with cache required, exiting.");
   }
 }
+
+/**
+  Called once all the stripes are initialized, if they were brought online
+  one by one rather than before cacheInitialized.
+ */
+void
+CacheProcessor::stripesInitialized()
+{
+  update_stripe_versions();
+  Note("all %d cache stripes initialized", gnstripes.load());
+}
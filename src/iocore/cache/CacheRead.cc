@@ -759,8 +759,10 @@ CacheVC::openReadStartEarliest(int /* event ATS_UNUSED */, Event * /* e ATS_UNUS
   {
     CACHE_TRY_LOCK(lock, stripe->mutex, mutex->thread_holding);
     if (!lock.is_locked()) {
+      stripe_lock_missed();
       VC_SCHED_LOCK_RETRY();
     }
+    stripe_lock_acquired();
     if (!buf) {
       goto Lread;
     }
@@ -966,8 +968,10 @@ CacheVC::openReadStartHead(int event, Event *e)
   {
     CACHE_TRY_LOCK(lock, stripe->mutex, mutex->thread_holding);
     if (!lock.is_locked()) {
+      stripe_lock_missed();
       VC_SCHED_LOCK_RETRY();
     }
+    stripe_lock_acquired();
     if (!buf) {
       goto Lread;
     }
@@ -29,8 +29,10 @@
 #include "StripeSM.h"
 #include "iocore/aio/AIO.h"
 #include "tscore/Random.h"
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
+#include <vector>
 
 CacheTestSM::CacheTestSM(RegressionTest *t, const char *name) : RegressionSM(t), cache_test_name(name)
 {
@@ -672,8 +674,96 @@ REGRESSION_TEST(ram_cache)(RegressionTest *t, int level, int *pstatus)
   for (int s = 20; s <= 28; s += 4) {
     int64_t cache_size = 1LL << s;
     *pstatus           = REGRESSION_TEST_PASSED;
-    if (!test_RamCache(t, new_RamCacheLRU(), "LRU", cache_size) || !test_RamCache(t, new_RamCacheCLFUS(), "CLFUS", cache_size)) {
+    if (!test_RamCache(t, new_RamCacheLRU(), "LRU", cache_size) || !test_RamCache(t, new_RamCacheCLFUS(), "CLFUS", cache_size) ||
+        !test_RamCache(t, new_RamCacheTinyLFU(), "TinyLFU", cache_size)) {
       *pstatus = REGRESSION_TEST_FAILED;
     }
   }
 }
+
+/*
+   Replay a request trace against a RAM cache, filling it on misses like
+   the cache read path does, and report the hit ratio over the second half
+   of the trace and the memory used per resident entry beyond its data.
+   */
+static void
+replay_RamCache(RegressionTest *t, RamCache *cache, const char *name, int64_t cache_size, const std::vector<int> &trace)
+{
+  CacheKey  key;
+  StripeSM *stripe = theCache->key_to_stripe(&key, "example.com", sizeof("example.com") - 1);
+  int64_t   hits   = 0;
+
+  cache->init(cache_size, stripe);
+
+  for (size_t i = 0; i < trace.size(); i++) {
+    CryptoHash        hash;
+    Ptr<IOBufferData> get_data;
+
+    hash.u64[0] = (static_cast<uint64_t>(trace[i]) << 32) + trace[i];
+    hash.u64[1] = (static_cast<uint64_t>(trace[i]) << 32) + trace[i];
+    if (cache->get(&hash, &get_data)) {
+      if (i >= trace.size() / 2) {
+        hits++;
+      }
+      continue;
+    }
+    Ptr<IOBufferData> d = make_ptr(THREAD_ALLOC(ioDataAllocator, this_thread()));
+    d->alloc(BUFFER_SIZE_INDEX_16K);
+    cache->put(&hash, d.get(), d->block_size());
+  }
+
+  // Count what is left in the cache to get the overhead per entry.
+  std::vector<int> ids(trace);
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  int64_t resident = 0;
+  for (int id : ids) {
+    CryptoHash        hash;
+    Ptr<IOBufferData> get_data;
+
+    hash.u64[0] = (static_cast<uint64_t>(id) << 32) + id;
+    hash.u64[1] = (static_cast<uint64_t>(id) << 32) + id;
+    resident    += cache->get(&hash, &get_data);
+  }
+
+  double  hit_rate = static_cast<double>(hits) / (trace.size() - trace.size() / 2);
+  int64_t overhead = resident ? (cache->size() - resident * BUFFER_SIZE_FOR_INDEX(BUFFER_SIZE_INDEX_16K)) / resident : 0;
+  rprintf(t, "RamCache %s Size %lld Hit Rate %f Entries %lld Overhead/Entry %lld\n", name, cache_size, hit_rate, resident, overhead);
+
+  delete cache;
+}
+
+REGRESSION_TEST(ram_cache_trace)(RegressionTest *t, int level, int *pstatus)
+{
+  *pstatus = REGRESSION_TEST_PASSED;
+  if (REGRESSION_TEST_EXTENDED > level) {
+    return;
+  }
+
+  if (cacheProcessor.IsCacheEnabled() != CACHE_INITIALIZED) {
+    rprintf(t, "cache not initialized");
+    *pstatus = REGRESSION_TEST_FAILED;
+    return;
+  }
+
+  // Zipf distributed requests, with a scan of objects that are never seen again every 10000 requests.
+  int64_t          cache_size = 1LL << 26;
+  int              objects    = cache_size / BUFFER_SIZE_FOR_INDEX(BUFFER_SIZE_INDEX_16K);
+  int              scan_id    = ZIPF_SIZE;
+  std::vector<int> trace;
+
+  build_zipf();
+  ts::Random::seed(13);
+  for (int i = 0; i < objects * 64; i++) {
+    if (i % 10000 == 0) {
+      for (int j = 0; j < objects; j++) {
+        trace.push_back(scan_id++);
+      }
+    }
+    trace.push_back(get_zipf(ts::Random::drandom()));
+  }
+
+  replay_RamCache(t, new_RamCacheLRU(), "LRU", cache_size, trace);
+  replay_RamCache(t, new_RamCacheCLFUS(), "CLFUS", cache_size, trace);
+  replay_RamCache(t, new_RamCacheTinyLFU(), "TinyLFU", cache_size, trace);
+}
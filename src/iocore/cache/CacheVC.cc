@@ -690,6 +690,10 @@ CacheVC::scanObject(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
   }
 
   if (!fragment) { // initialize for first read
+    // Skip a stripe that is still initializing, its directory is not complete.
+    if (!stripe->is_ready()) {
+      goto Lnext_vol;
+    }
     fragment            = 1;
     scan_stripe_map     = make_vol_map(stripe);
     io.aiocb.aio_offset = next_in_map(stripe, scan_stripe_map, stripe->vol_offset_to_offset(0));
@@ -193,6 +193,8 @@ struct CacheVC : public CacheVConnection {
   }
 
   void    cancel_trigger();
+  void    stripe_lock_missed();
+  void    stripe_lock_acquired();
   int64_t get_object_size() override;
   void    set_http_info(CacheHTTPInfo *info) override;
   void    get_http_info(CacheHTTPInfo **info) override;
@@ -266,6 +268,7 @@ struct CacheVC : public CacheVConnection {
   ContinuationHandler       save_handler;
   uint32_t                  pin_in_cache;
   ink_hrtime                start_time;
+  ink_hrtime                stripe_lock_wait; // time of the first missed stripe lock of an open, 0 if none
   int                       op_type; // Index into the metrics array for this operation, rather than a CacheOpType (fewer casts)
   int                       recursive;
   int                       closed;
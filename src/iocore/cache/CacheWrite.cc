@@ -678,8 +678,10 @@ CacheVC::openWriteStartDone(int event, Event *e)
   {
     CACHE_TRY_LOCK(lock, stripe->mutex, mutex->thread_holding);
     if (!lock.is_locked()) {
+      stripe_lock_missed();
       VC_LOCK_RETRY_EVENT();
     }
+    stripe_lock_acquired();
 
     if (_action.cancelled && (!od || !od->has_multiple_writers())) {
       goto Lcancel;
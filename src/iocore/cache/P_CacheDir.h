@@ -29,8 +29,11 @@
 #include "iocore/aio/AIO.h"
 #include "tscore/Version.h"
 
+#include <atomic>
 #include <cstdint>
 #include <ctime>
+#include <utility>
+#include <vector>
 
 class Stripe;
 class StripeSM;
@@ -62,6 +65,8 @@ class CacheEvacuateDocVC;
 #define DIR_SIZE_WITH_BLOCK(_i) ((1 << DIR_SIZE_WIDTH) * DIR_BLOCK_SIZE(_i))
 #define DIR_OFFSET_BITS         40
 #define DIR_OFFSET_MAX          ((((off_t)1) << DIR_OFFSET_BITS) - 1)
+#define DIR_SYNC_COPY_A         1
+#define DIR_SYNC_COPY_B         2
 
 #define DO_NOT_REMOVE_THIS 0
 
@@ -106,7 +111,8 @@ class CacheEvacuateDocVC;
 
 // OpenDir
 
-#define OPEN_DIR_BUCKETS 256
+#define OPEN_DIR_BUCKETS      256
+#define OPEN_DIR_WRITER_SLOTS 4
 
 struct EvacuationBlock;
 
@@ -187,6 +193,10 @@ struct Dir {
 #define dir_pinned(_e)         dir_bit(_e, 2, 14)
 #define dir_set_pinned(_e, _v) dir_set_bit(_e, 2, 14, _v)
 // Bit 2:15 is unused.
+// A free entry keeps the freelist prev link where the tag is, and the rows of
+// a bucket are handed out to the chains of other buckets. The tags of a bucket
+// are therefore not a contiguous set that could be matched at once, see
+// dir_probe for the chain walk.
 #define dir_next(_e)         (_e)->w[3]
 #define dir_set_next(_e, _o) (_e)->w[3] = (uint16_t)(_o)
 #define dir_prev(_e)         (_e)->w[2]
@@ -236,7 +246,29 @@ struct OpenDir : public Continuation {
   OpenDirEntry *open_read(const CryptoHash *key) const;
   int           signal_readers(int event, Event *e);
 
+  /** Check for a writer of @a key without holding the stripe lock.
+
+      Only the first @c OPEN_DIR_WRITER_SLOTS entries of a bucket are visible here, and a bucket
+      being updated concurrently is skipped, so @c false means "unknown" and must be confirmed
+      with @c open_read under the stripe lock.  @c true is exact at the time of the call.
+   */
+  bool has_writer(const CryptoHash *key) const;
+
   OpenDir();
+
+private:
+  static constexpr int KEY_WORDS = CRYPTO_HASH_SIZE / sizeof(uint64_t);
+
+  // Keys of the open entries of a bucket, published under the stripe lock and read with a
+  // sequence lock so that lookups never block the stripe.
+  struct WriterSlots {
+    std::atomic<uint32_t> seq{0};
+    std::atomic<uint64_t> key[OPEN_DIR_WRITER_SLOTS][KEY_WORDS];
+  };
+
+  void _swap_writer_slot(int b, const CryptoHash &from, const CryptoHash &to);
+
+  WriterSlots _writer_slots[OPEN_DIR_BUCKETS];
 };
 
 struct CacheSync : public Continuation {
@@ -248,8 +280,17 @@ struct CacheSync : public Continuation {
   AIOCallback io;
   Event      *trigger    = nullptr;
   ink_hrtime  start_time = 0;
-  int         mainEvent(int event, Event *e);
-  void        aio_write(int fd, char *b, int n, off_t o);
+  bool        failed     = false;
+
+  // Parts of the directory body written by the current sync, as [start, end)
+  // offsets in the directory. Only the segments changed since the last sync to
+  // the same copy are copied to buf and written.
+  std::vector<std::pair<off_t, off_t>> ranges;
+  size_t                               range_index = 0;
+
+  int  mainEvent(int event, Event *e);
+  void aio_write(int fd, char *b, int n, off_t o);
+  void snapshot(Stripe *stripe, int copy);
 
   CacheSync() : Continuation(new_ProxyMutex()) { SET_HANDLER(&CacheSync::mainEvent); }
 };
@@ -280,6 +321,11 @@ struct Directory {
   int                  segments{};
   off_t                buckets{};
 
+  /* Segments changed since they were last synced to each copy of the
+     directory, bit 0 for copy A and bit 1 for copy B.
+   */
+  std::vector<uint8_t> dirty_segments;
+
   /* Total number of dir entries.
    */
   int entries() const;
@@ -287,6 +333,14 @@ struct Directory {
   /* Returns the first dir in segment @a s.
    */
   Dir *get_segment(int s) const;
+
+  /* Note a change to segment @a s, it is written by the next sync of each copy.
+   */
+  void mark_dirty(int s);
+
+  /* Note a change to every segment.
+   */
+  void mark_all_dirty();
 };
 
 inline int
@@ -301,9 +355,22 @@ Directory::get_segment(int s) const
   return reinterpret_cast<Dir *>((reinterpret_cast<char *>(this->dir)) + (s * this->buckets) * DIR_DEPTH * SIZEOF_DIR);
 }
 
+inline void
+Directory::mark_dirty(int s)
+{
+  this->dirty_segments[s] = DIR_SYNC_COPY_A | DIR_SYNC_COPY_B;
+}
+
+inline void
+Directory::mark_all_dirty()
+{
+  this->dirty_segments.assign(this->segments, DIR_SYNC_COPY_A | DIR_SYNC_COPY_B);
+}
+
 // Global Functions
 
 int      dir_probe(const CacheKey *, StripeSM *, Dir *, Dir **);
+void     dir_prefetch(const CacheKey *key, const Stripe *stripe);
 int      dir_insert(const CacheKey *key, StripeSM *stripe, Dir *to_part);
 int      dir_overwrite(const CacheKey *key, StripeSM *stripe, Dir *to_part, Dir *overwrite, bool must_overwrite = true);
 int      dir_delete(const CacheKey *key, StripeSM *stripe, Dir *del);
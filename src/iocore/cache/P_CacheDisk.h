@@ -89,12 +89,15 @@ struct CacheDisk : public Continuation {
   DiskStripe  *free_blocks       = nullptr;
   int          num_errors        = 0;
   int          cleared           = 0;
+  int          numa_node         = -1; ///< NUMA node the device is attached to, -1 if not known.
   bool         read_only_p       = false;
   bool         online = true; /* flag marking cache disk online or offline (because of too many failures or by the operator). */
 
   // Extra configuration values
-  int            forced_volume_num = -1; ///< Volume number for this disk.
-  ats_scoped_str hash_base_string;       ///< Base string for hash seed.
+  int            forced_volume_num     = -1; ///< Volume number for this disk.
+  int            agg_write_size        = 0;  ///< Aggregation write size of the stripes, 0 for the default.
+  int            agg_write_queue_depth = 0;  ///< Aggregation buffers per stripe, 0 for the default.
+  ats_scoped_str hash_base_string;           ///< Base string for hash seed.
 
   CacheDisk() : Continuation(new_ProxyMutex()) {}
 
@@ -78,6 +78,7 @@ public:
 
   void AllocateSpace(int num_entries);
   void NewEntry(matcher_line *line_info);
+  void Finalize(); // Called once all entries are added, before matching.
 
   void Match(const char *rdata, int rlen, CacheHostResult *result) const;
   void Print() const;
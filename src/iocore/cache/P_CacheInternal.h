@@ -103,12 +103,16 @@ extern int cache_config_select_alternate;
 extern int cache_config_max_doc_size;
 extern int cache_config_min_average_object_size;
 extern int cache_config_agg_write_backlog;
+extern int cache_config_agg_write_queue_depth;
+extern int cache_config_agg_write_size;
+extern int cache_config_stripe_early_online;
 extern int cache_config_enable_checksum;
 extern int cache_config_alt_rewrite_max_size;
 extern int cache_config_read_while_writer;
 extern int cache_config_agg_write_backlog;
 extern int cache_config_ram_cache_compress;
 extern int cache_config_ram_cache_compress_percent;
+extern int cache_config_ram_cache_compress_threads;
 extern int cache_config_ram_cache_use_seen_filter;
 extern int cache_config_hit_evacuate_percent;
 extern int cache_config_hit_evacuate_size_limit;
@@ -295,6 +299,29 @@ CacheVC::cancel_trigger()
   }
 }
 
+// Stripe lock contention of the open_read / open_write paths, the wait is counted from the first
+// miss until the lock is taken.
+inline void
+CacheVC::stripe_lock_missed()
+{
+  ts::Metrics::Counter::increment(cache_rsb.stripe_lock_miss);
+  ts::Metrics::Counter::increment(stripe->cache_vol->vol_rsb.stripe_lock_miss);
+  if (!stripe_lock_wait) {
+    stripe_lock_wait = ink_get_hrtime();
+  }
+}
+
+inline void
+CacheVC::stripe_lock_acquired()
+{
+  if (stripe_lock_wait) {
+    ink_hrtime wait = ink_get_hrtime() - stripe_lock_wait;
+    ts::Metrics::Counter::increment(cache_rsb.stripe_lock_wait_time, wait);
+    ts::Metrics::Counter::increment(stripe->cache_vol->vol_rsb.stripe_lock_wait_time, wait);
+    stripe_lock_wait = 0;
+  }
+}
+
 inline int
 CacheVC::die()
 {
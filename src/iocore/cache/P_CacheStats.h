@@ -40,6 +40,7 @@ struct CacheStatsBlock {
   ts::Metrics::Gauge::AtomicType   *bytes_used            = nullptr;
   ts::Metrics::Gauge::AtomicType   *bytes_total           = nullptr;
   ts::Metrics::Gauge::AtomicType   *stripes               = nullptr;
+  ts::Metrics::Gauge::AtomicType   *stripes_online        = nullptr;
   ts::Metrics::Gauge::AtomicType   *ram_cache_bytes       = nullptr;
   ts::Metrics::Gauge::AtomicType   *ram_cache_bytes_total = nullptr;
   ts::Metrics::Gauge::AtomicType   *direntries_total      = nullptr;
@@ -64,6 +65,11 @@ struct CacheStatsBlock {
   ts::Metrics::Counter::AtomicType *directory_sync_count  = nullptr;
   ts::Metrics::Counter::AtomicType *directory_sync_time   = nullptr;
   ts::Metrics::Counter::AtomicType *directory_sync_bytes  = nullptr;
+  ts::Metrics::Counter::AtomicType *stripe_lock_miss      = nullptr;
+  ts::Metrics::Counter::AtomicType *stripe_lock_wait_time = nullptr;
+  ts::Metrics::Counter::AtomicType *numa_local_access     = nullptr;
+  ts::Metrics::Counter::AtomicType *numa_remote_access    = nullptr;
+  ts::Metrics::Counter::AtomicType *write_busy_lockless   = nullptr;
   ts::Metrics::Counter::AtomicType *span_errors_read      = nullptr;
   ts::Metrics::Counter::AtomicType *span_errors_write     = nullptr;
   ts::Metrics::Gauge::AtomicType   *span_offline          = nullptr;
@@ -167,9 +167,9 @@ void
 PreservationTable::scan_for_pinned_documents(Stripe const *stripe)
 {
   if (cache_config_permit_pinning) {
-    // we can't evacuate anything between header->write_pos and
-    // header->write_pos + AGG_SIZE.
-    int ps = stripe->offset_to_vol_offset(stripe->directory.header->write_pos + AGG_SIZE);
+    // we can't evacuate anything between header->write_pos and the end
+    // of the aggregation buffer being filled.
+    int ps = stripe->offset_to_vol_offset(stripe->get_agg_buf_offset() + AGG_SIZE);
     int pe =
       stripe->offset_to_vol_offset(stripe->directory.header->write_pos + 2 * EVACUATION_SIZE + (stripe->len / PIN_SCAN_EVERY));
     int vol_end_offset    = stripe->offset_to_vol_offset(stripe->len + stripe->skip);
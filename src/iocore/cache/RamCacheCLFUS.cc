@@ -31,16 +31,27 @@
 #include "iocore/eventsystem/Tasks.h"
 #include "fastlz/fastlz.h"
 #include "tscore/CryptoHash.h"
+#include "records/RecCore.h"
+#include "swoc/swoc_file.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <zlib.h>
 #ifdef HAVE_LZMA_H
 #include <lzma.h>
 #endif
+#ifdef HAVE_ZSTD_H
+#include <zstd.h>
+#endif
 
 #define REQUIRED_COMPRESSION 0.9 // must get to this size or declared incompressible
 #define REQUIRED_SHRINK      0.8 // must get to this size or keep original buffer (with padding)
 #define HISTORY_HYSTERIA     10  // extra temporary history
 #define ENTRY_OVERHEAD       256 // per-entry overhead to consider when computing cache value/size
 #define LZMA_BASE_MEMLIMIT   (64 * 1024 * 1024)
+#define ZSTD_LEVEL           3
+#define RAM_CACHE_COMPRESS_BATCH 64 // entries compressed per release of the stripe lock
 // #define CHECK_ACOUNTING 1 // very expensive double checking of all sizes
 
 #define REQUEUE_HITS(_h)              ((_h) ? ((_h) - 1) : 0)
@@ -62,6 +73,168 @@ DbgCtl dbg_ctl_ram_cache_compare{"ram_cache_compare"};
 
 #endif
 
+struct RamCacheCLFUSEntry;
+
+// Trained zstd dictionary of a cache volume, shared by the RAM caches of its stripes.
+struct RamCacheZstdDict {
+#ifdef HAVE_ZSTD_H
+  ZSTD_CDict *cdict = nullptr;
+  ZSTD_DDict *ddict = nullptr;
+
+  ~RamCacheZstdDict()
+  {
+    ZSTD_freeCDict(cdict);
+    ZSTD_freeDDict(ddict);
+  }
+#endif
+};
+
+namespace
+{
+
+// An entry picked for compression, the data is compressed with the stripe lock released.
+struct CompressJob {
+  RamCacheCLFUSEntry *e = nullptr;
+  Ptr<IOBufferData>   data;
+  CryptoHash          key;
+  uint32_t            len     = 0;
+  char               *out     = nullptr;
+  uint32_t            out_len = 0;
+  bool                failed  = false;
+};
+
+#ifdef HAVE_ZSTD_H
+// Contexts are per thread and live as long as the thread.
+thread_local ZSTD_CCtx *zstd_cctx = nullptr;
+thread_local ZSTD_DCtx *zstd_dctx = nullptr;
+
+std::mutex                                                 zstd_dict_mutex;
+std::unordered_map<int, std::shared_ptr<RamCacheZstdDict>> zstd_dicts;
+
+/* Dictionaries are read from proxy.config.cache.ram_cache.compress_dictionary_dir,
+   the one for volume N is volume_N.dict (as written by zstd --train). Volumes
+   without a dictionary compress without one.
+ */
+std::shared_ptr<RamCacheZstdDict>
+zstd_dict_for_volume(int vol_number)
+{
+  std::lock_guard<std::mutex> lock(zstd_dict_mutex);
+
+  if (auto spot = zstd_dicts.find(vol_number); spot != zstd_dicts.end()) {
+    return spot->second;
+  }
+
+  std::shared_ptr<RamCacheZstdDict> dict;
+  std::string                       dir = RecConfigReadConfigPath("proxy.config.cache.ram_cache.compress_dictionary_dir");
+  if (!dir.empty()) {
+    swoc::file::path path = swoc::file::path(dir) / swoc::file::path("volume_" + std::to_string(vol_number) + ".dict");
+    std::error_code  ec;
+    std::string      content = swoc::file::load(path, ec);
+    if (!ec && !content.empty()) {
+      dict        = std::make_shared<RamCacheZstdDict>();
+      dict->cdict = ZSTD_createCDict(content.data(), content.size(), ZSTD_LEVEL);
+      dict->ddict = ZSTD_createDDict(content.data(), content.size());
+      if (dict->cdict && dict->ddict) {
+        Note("loaded RAM cache compression dictionary %s for volume %d", path.c_str(), vol_number);
+      } else {
+        Warning("unable to use RAM cache compression dictionary %s", path.c_str());
+        dict.reset();
+      }
+    }
+  }
+  zstd_dicts[vol_number] = dict;
+  return dict;
+}
+
+size_t
+zstd_decompress(char *dst, size_t dst_len, const char *src, size_t src_len, const RamCacheZstdDict *dict)
+{
+  if (!zstd_dctx) {
+    zstd_dctx = ZSTD_createDCtx();
+  }
+  size_t l = dict ? ZSTD_decompress_usingDDict(zstd_dctx, dst, dst_len, src, src_len, dict->ddict) :
+                    ZSTD_decompressDCtx(zstd_dctx, dst, dst_len, src, src_len);
+  return ZSTD_isError(l) ? 0 : l;
+}
+#endif
+
+void
+compress_buffer(int ctype, [[maybe_unused]] const RamCacheZstdDict *dict, CompressJob &job)
+{
+  const char *src = job.data->data();
+  uint32_t    l   = 0;
+
+  switch (ctype) {
+  default:
+    job.failed = true;
+    return;
+  case CACHE_COMPRESSION_FASTLZ:
+    l = static_cast<uint32_t>(static_cast<double>(job.len) * 1.05 + 66);
+    break;
+  case CACHE_COMPRESSION_LIBZ:
+    l = static_cast<uint32_t>(compressBound(job.len));
+    break;
+#ifdef HAVE_LZMA_H
+  case CACHE_COMPRESSION_LIBLZMA:
+    l = job.len;
+    break;
+#endif
+#ifdef HAVE_ZSTD_H
+  case CACHE_COMPRESSION_ZSTD:
+    l = static_cast<uint32_t>(ZSTD_compressBound(job.len));
+    break;
+#endif
+  }
+
+  job.out = static_cast<char *>(ats_malloc(l));
+  switch (ctype) {
+  case CACHE_COMPRESSION_FASTLZ: {
+    int r = fastlz_compress(src, job.len, job.out);
+    if (r <= 0) {
+      job.failed = true;
+    }
+    l = r;
+    break;
+  }
+  case CACHE_COMPRESSION_LIBZ: {
+    uLongf ll = l;
+    if ((Z_OK != compress(reinterpret_cast<Bytef *>(job.out), &ll, reinterpret_cast<const Bytef *>(src), job.len))) {
+      job.failed = true;
+    }
+    l = static_cast<int>(ll);
+    break;
+  }
+#ifdef HAVE_LZMA_H
+  case CACHE_COMPRESSION_LIBLZMA: {
+    size_t pos = 0, ll = l;
+    if (LZMA_OK != lzma_easy_buffer_encode(LZMA_PRESET_DEFAULT, LZMA_CHECK_NONE, nullptr, reinterpret_cast<const uint8_t *>(src),
+                                           job.len, reinterpret_cast<uint8_t *>(job.out), &pos, ll)) {
+      job.failed = true;
+    }
+    l = static_cast<int>(pos);
+    break;
+  }
+#endif
+#ifdef HAVE_ZSTD_H
+  case CACHE_COMPRESSION_ZSTD: {
+    if (!zstd_cctx) {
+      zstd_cctx = ZSTD_createCCtx();
+    }
+    size_t r = dict ? ZSTD_compress_usingCDict(zstd_cctx, job.out, l, src, job.len, dict->cdict) :
+                      ZSTD_compressCCtx(zstd_cctx, job.out, l, src, job.len, ZSTD_LEVEL);
+    if (ZSTD_isError(r)) {
+      job.failed = true;
+    }
+    l = static_cast<uint32_t>(r);
+    break;
+  }
+#endif
+  }
+  job.out_len = l;
+}
+
+} // end anonymous namespace
+
 struct RamCacheCLFUSEntry {
   CryptoHash key;
   uint64_t   auxkey;
@@ -115,9 +288,12 @@ private:
   int                 _ncompressed = 0;
   RamCacheCLFUSEntry *_compressed  = nullptr; // first uncompressed lru[0] entry
 
+  std::shared_ptr<RamCacheZstdDict> _zstd_dict;
+
   void                _resize_hashtable();
   void                _victimize(RamCacheCLFUSEntry *e);
   void                _move_compressed(RamCacheCLFUSEntry *e);
+  void                _install_compressed(int ctype, CompressJob &job);
   RamCacheCLFUSEntry *_destroy(RamCacheCLFUSEntry *e);
   void                _requeue_victims(Que(RamCacheCLFUSEntry, lru_link) & victims);
   void                _tick(); // move CLOCK on history
@@ -164,6 +340,11 @@ RamCacheCLFUSCompressor::mainEvent(int /* event ATS_UNUSED */, Event *e)
   case CACHE_COMPRESSION_LIBLZMA:
 #ifndef HAVE_LZMA_H
     Warning("lzma not available for RAM cache compression");
+#endif
+    break;
+  case CACHE_COMPRESSION_ZSTD:
+#ifndef HAVE_ZSTD_H
+    Warning("zstd not available for RAM cache compression");
 #endif
     break;
   }
@@ -175,6 +356,19 @@ RamCacheCLFUSCompressor::mainEvent(int /* event ATS_UNUSED */, Event *e)
 
 ClassAllocator<RamCacheCLFUSEntry> ramCacheCLFUSEntryAllocator("RamCacheCLFUSEntry");
 
+// Compression runs on its own threads if proxy.config.cache.ram_cache.compress_threads is set, else on the task threads.
+static EventType
+ram_cache_compress_event_type()
+{
+  static EventType type = []() -> EventType {
+    if (cache_config_ram_cache_compress_threads > 0) {
+      return eventProcessor.spawn_event_threads("ET_RAM_COMPRESS", cache_config_ram_cache_compress_threads);
+    }
+    return ET_TASK;
+  }();
+  return type;
+}
+
 static const int bucket_sizes[] = {127,      251,      509,       1021,      2039,      4093,       8191,      16381,   32749,
                                    65521,    131071,   262139,    524287,    1048573,   2097143,    4194301,   8388593, 16777213,
                                    33554393, 67108859, 134217689, 268435399, 536870909, 1073741789, 2147483647};
@@ -218,7 +412,12 @@ RamCacheCLFUS::init(int64_t abytes, StripeSM *astripe)
   }
   this->_resize_hashtable();
   if (cache_config_ram_cache_compress) {
-    eventProcessor.schedule_every(new RamCacheCLFUSCompressor(this), HRTIME_SECOND, ET_TASK);
+#ifdef HAVE_ZSTD_H
+    if (cache_config_ram_cache_compress == CACHE_COMPRESSION_ZSTD) {
+      this->_zstd_dict = zstd_dict_for_volume(stripe->cache_vol->vol_number);
+    }
+#endif
+    eventProcessor.schedule_every(new RamCacheCLFUSCompressor(this), HRTIME_SECOND, ram_cache_compress_event_type());
   }
 }
 
@@ -298,6 +497,15 @@ RamCacheCLFUS::get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey
             ram_hit_state = RAM_HIT_COMPRESS_LIBLZMA;
             break;
           }
+#endif
+#ifdef HAVE_ZSTD_H
+          case CACHE_COMPRESSION_ZSTD: {
+            if (e->len != zstd_decompress(b, e->len, e->data->data(), e->compressed_len, this->_zstd_dict.get())) {
+              goto Lfailed;
+            }
+            ram_hit_state = RAM_HIT_COMPRESS_ZSTD;
+            break;
+          }
 #endif
           }
           IOBufferData *data = new_xmalloc_IOBufferData(b, e->len);
@@ -431,149 +639,122 @@ RamCacheCLFUS::compress_entries(EThread *thread, int do_at_most)
     return;
   }
   ink_assert(stripe != nullptr);
+  int         ctype = cache_config_ram_cache_compress;
+  CompressJob batch[RAM_CACHE_COMPRESS_BATCH];
+  int         n = 0;
+
   MUTEX_TAKE_LOCK(stripe->mutex, thread);
-  if (!this->_compressed) {
-    this->_compressed  = this->_lru[0].head;
-    this->_ncompressed = 0;
-  }
-  float target = (cache_config_ram_cache_compress_percent / 100.0) * this->_objects;
-  int   n      = 0;
-  char *b = nullptr, *bb = nullptr;
-  while (this->_compressed && target > this->_ncompressed) {
-    RamCacheCLFUSEntry *e = this->_compressed;
-    if (e->flag_bits.incompressible || e->flag_bits.compressed) {
-      goto Lcontinue;
-    }
-    n++;
-    if (do_at_most < n) {
-      break;
+  for (bool at_tail = false; !at_tail;) {
+    // Pick the next batch under the lock, the cursor moves past the picked entries.
+    if (!this->_compressed) {
+      this->_compressed  = this->_lru[0].head;
+      this->_ncompressed = 0;
     }
-    {
-      e->compressed_len = e->size;
-      uint32_t l        = 0;
-      int      ctype    = cache_config_ram_cache_compress;
-      switch (ctype) {
-      default:
-        goto Lcontinue;
-      case CACHE_COMPRESSION_FASTLZ:
-        l = static_cast<uint32_t>(static_cast<double>(e->len) * 1.05 + 66);
-        break;
-      case CACHE_COMPRESSION_LIBZ:
-        l = static_cast<uint32_t>(compressBound(e->len));
-        break;
-#ifdef HAVE_LZMA_H
-      case CACHE_COMPRESSION_LIBLZMA:
-        l = e->len;
-        break;
-#endif
-      }
-      // store transient data for lock release
-      Ptr<IOBufferData> edata = e->data;
-      uint32_t          elen  = e->len;
-      CryptoHash        key   = e->key;
-      MUTEX_UNTAKE_LOCK(stripe->mutex, thread);
-      b           = static_cast<char *>(ats_malloc(l));
-      bool failed = false;
-      switch (ctype) {
-      default:
-        goto Lfailed;
-      case CACHE_COMPRESSION_FASTLZ:
-        if (e->len < 16) {
-          goto Lfailed;
-        }
-        if ((l = fastlz_compress(edata->data(), elen, b)) <= 0) {
-          failed = true;
-        }
-        break;
-      case CACHE_COMPRESSION_LIBZ: {
-        uLongf ll = l;
-        if ((Z_OK != compress(reinterpret_cast<Bytef *>(b), &ll, reinterpret_cast<Bytef *>(edata->data()), elen))) {
-          failed = true;
+    float target = (cache_config_ram_cache_compress_percent / 100.0) * this->_objects;
+    int   nbatch = 0;
+    while (this->_compressed && target > this->_ncompressed && nbatch < RAM_CACHE_COMPRESS_BATCH && n < do_at_most) {
+      RamCacheCLFUSEntry *e = this->_compressed;
+      if (!e->flag_bits.incompressible && !e->flag_bits.compressed) {
+        e->compressed_len = e->size;
+        if (ctype == CACHE_COMPRESSION_FASTLZ && e->len < 16) {
+          e->flag_bits.incompressible = 1;
+        } else {
+          CompressJob &job = batch[nbatch++];
+          job              = CompressJob();
+          job.e            = e;
+          job.data         = e->data;
+          job.key          = e->key;
+          job.len          = e->len;
+          n++;
         }
-        l = static_cast<int>(ll);
-        break;
       }
-#ifdef HAVE_LZMA_H
-      case CACHE_COMPRESSION_LIBLZMA: {
-        size_t pos = 0, ll = l;
-        if (LZMA_OK != lzma_easy_buffer_encode(LZMA_PRESET_DEFAULT, LZMA_CHECK_NONE, nullptr,
-                                               reinterpret_cast<uint8_t *>(edata->data()), elen, reinterpret_cast<uint8_t *>(b),
-                                               &pos, ll)) {
-          failed = true;
-        }
-        l = static_cast<int>(pos);
+      if (!e->lru_link.next) {
+        at_tail = true;
         break;
       }
-#endif
-      }
-      MUTEX_TAKE_LOCK(stripe->mutex, thread);
-      // see if the entry is till around
-      {
-        if (failed) {
-          goto Lfailed;
-        }
-        uint32_t            i  = key.slice32(3) % this->_nbuckets;
-        RamCacheCLFUSEntry *ee = this->_bucket[i].head;
-        while (ee) {
-          if (ee->key == key && ee->data == edata) {
-            break;
-          }
-          ee = ee->hash_link.next;
-        }
-        if (!ee || ee != e) {
-          e = this->_compressed;
-          ats_free(b);
-          goto Lcontinue;
-        }
-      }
-      if (l > REQUIRED_COMPRESSION * e->len) {
-        e->flag_bits.incompressible = true;
-      }
-      if (l > REQUIRED_SHRINK * e->size) {
-        goto Lfailed;
-      }
-      if (l < e->len) {
-        e->flag_bits.compressed = cache_config_ram_cache_compress;
-        bb                      = static_cast<char *>(ats_malloc(l));
-        memcpy(bb, b, l);
-        ats_free(b);
-        e->compressed_len  = l;
-        int64_t delta      = (static_cast<int64_t>(l)) - static_cast<int64_t>(e->size);
-        this->_bytes      += delta;
-        ts::Metrics::Gauge::increment(cache_rsb.ram_cache_bytes, delta);
-        ts::Metrics::Gauge::increment(stripe->cache_vol->vol_rsb.ram_cache_bytes, delta);
-        e->size = l;
-      } else {
-        ats_free(b);
-        e->flag_bits.compressed = 0;
-        bb                      = static_cast<char *>(ats_malloc(e->len));
-        memcpy(bb, e->data->data(), e->len);
-        int64_t delta  = (static_cast<int64_t>(e->len)) - static_cast<int64_t>(e->size);
-        this->_bytes  += delta;
-        ts::Metrics::Gauge::increment(cache_rsb.ram_cache_bytes, delta);
-        ts::Metrics::Gauge::increment(stripe->cache_vol->vol_rsb.ram_cache_bytes, delta);
-        e->size = e->len;
-        l       = e->len;
-      }
-      e->data            = new_xmalloc_IOBufferData(bb, l);
-      e->data->_mem_type = DEFAULT_ALLOC;
-      check_accounting(this);
+      this->_compressed = e->lru_link.next;
+      this->_ncompressed++;
+    }
+    if (!nbatch) {
+      break;
+    }
+
+    // Compress without the lock, the picked data is kept alive by the batch.
+    MUTEX_UNTAKE_LOCK(stripe->mutex, thread);
+    for (int i = 0; i < nbatch; i++) {
+      compress_buffer(ctype, this->_zstd_dict.get(), batch[i]);
     }
-    goto Lcontinue;
-  Lfailed:
-    ats_free(b);
-    e->flag_bits.incompressible = 1;
-  Lcontinue:;
-    DDbg(dbg_ctl_ram_cache, "compress %X %" PRId64 " %d %d %d %d %d", e->key.slice32(3), e->auxkey, e->flag_bits.incompressible,
-         e->flag_bits.compressed, e->len, e->compressed_len, this->_ncompressed);
-    if (!e->lru_link.next) {
+    MUTEX_TAKE_LOCK(stripe->mutex, thread);
+
+    for (int i = 0; i < nbatch; i++) {
+      this->_install_compressed(ctype, batch[i]);
+      batch[i].data = nullptr;
+    }
+    if (nbatch < RAM_CACHE_COMPRESS_BATCH) {
       break;
     }
-    this->_compressed = e->lru_link.next;
-    this->_ncompressed++;
   }
   MUTEX_UNTAKE_LOCK(stripe->mutex, thread);
-  return;
+}
+
+// Replace the data of a compressed entry, unless it was removed or changed while the lock was released.
+void
+RamCacheCLFUS::_install_compressed(int ctype, CompressJob &job)
+{
+  uint32_t            i = job.key.slice32(3) % this->_nbuckets;
+  RamCacheCLFUSEntry *e = this->_bucket[i].head;
+  while (e && !(e == job.e && e->key == job.key && e->data == job.data)) {
+    e = e->hash_link.next;
+  }
+  if (!e) {
+    ats_free(job.out);
+    return;
+  }
+
+  uint32_t l  = job.out_len;
+  char    *bb = nullptr;
+  if (job.failed) {
+    goto Lfailed;
+  }
+  if (l > REQUIRED_COMPRESSION * e->len) {
+    e->flag_bits.incompressible = true;
+  }
+  if (l > REQUIRED_SHRINK * e->size) {
+    goto Lfailed;
+  }
+  if (l < e->len) {
+    e->flag_bits.compressed = ctype;
+    bb                      = static_cast<char *>(ats_malloc(l));
+    memcpy(bb, job.out, l);
+    ats_free(job.out);
+    e->compressed_len  = l;
+    int64_t delta      = (static_cast<int64_t>(l)) - static_cast<int64_t>(e->size);
+    this->_bytes      += delta;
+    ts::Metrics::Gauge::increment(cache_rsb.ram_cache_bytes, delta);
+    ts::Metrics::Gauge::increment(stripe->cache_vol->vol_rsb.ram_cache_bytes, delta);
+    e->size = l;
+  } else {
+    ats_free(job.out);
+    e->flag_bits.compressed = 0;
+    bb                      = static_cast<char *>(ats_malloc(e->len));
+    memcpy(bb, e->data->data(), e->len);
+    int64_t delta  = (static_cast<int64_t>(e->len)) - static_cast<int64_t>(e->size);
+    this->_bytes  += delta;
+    ts::Metrics::Gauge::increment(cache_rsb.ram_cache_bytes, delta);
+    ts::Metrics::Gauge::increment(stripe->cache_vol->vol_rsb.ram_cache_bytes, delta);
+    e->size = e->len;
+    l       = e->len;
+  }
+  e->data            = new_xmalloc_IOBufferData(bb, l);
+  e->data->_mem_type = DEFAULT_ALLOC;
+  check_accounting(this);
+  goto Ldone;
+Lfailed:
+  ats_free(job.out);
+  e->flag_bits.incompressible = 1;
+Ldone:
+  DDbg(dbg_ctl_ram_cache, "compress %X %" PRId64 " %d %d %d %d %d", e->key.slice32(3), e->auxkey, e->flag_bits.incompressible,
+       e->flag_bits.compressed, e->len, e->compressed_len, this->_ncompressed);
 }
 
 void
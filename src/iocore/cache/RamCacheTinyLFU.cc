@@ -0,0 +1,409 @@
+/** @file
+
+  W-TinyLFU RAM cache: a small LRU admission window in front of a segmented
+  LRU main space, with admission to the main space decided by a count-min
+  sketch of recent access frequencies.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "P_RamCache.h"
+#include "P_CacheInternal.h"
+#include "StripeSM.h"
+#include "iocore/eventsystem/IOBuffer.h"
+#include "tscore/CryptoHash.h"
+#include "tscore/List.h"
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#define ENTRY_OVERHEAD       128 // per-entry overhead to consider when computing sizes
+#define WINDOW_PERCENT       1   // share of the cache given to the admission window
+#define PROTECTED_PERCENT    80  // share of the main space given to the protected segment
+#define SKETCH_SAMPLE_FACTOR 10  // counters are halved after this many increments per tracked entry
+
+namespace
+{
+
+#ifdef DEBUG
+DbgCtl dbg_ctl_ram_cache{"ram_cache"};
+#endif
+
+inline uint64_t
+mix64(uint64_t x)
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+/* Count-min sketch with four rows of 4 bit counters.
+
+   Each 64 bit word holds 16 counters, four per row, so an increment or a
+   lookup touches at most four words. The counters are periodically halved
+   so the sketch follows changes in popularity.
+ */
+class FrequencySketch
+{
+public:
+  void
+  init(int64_t entries)
+  {
+    int64_t words = 1;
+    while (words < entries && words < (1 << 24)) {
+      words <<= 1;
+    }
+    table.assign(words, 0);
+    mask        = words - 1;
+    sample_size = std::max<int64_t>(entries, 1) * SKETCH_SAMPLE_FACTOR;
+    additions   = 0;
+  }
+
+  void
+  increment(const CryptoHash &key)
+  {
+    uint64_t h     = hash(key);
+    bool     added = false;
+    for (int row = 0; row < ROWS; ++row) {
+      uint64_t &word  = table[index(h, row)];
+      int       shift = slot(h, row) * 4;
+      if (((word >> shift) & 0xF) != 0xF) {
+        word  += 1ULL << shift;
+        added  = true;
+      }
+    }
+    if (added && ++additions >= sample_size) {
+      reset();
+    }
+  }
+
+  int
+  frequency(const CryptoHash &key) const
+  {
+    uint64_t h    = hash(key);
+    int      freq = 0xF;
+    for (int row = 0; row < ROWS; ++row) {
+      freq = std::min(freq, static_cast<int>((table[index(h, row)] >> (slot(h, row) * 4)) & 0xF));
+    }
+    return freq;
+  }
+
+private:
+  static constexpr int ROWS = 4;
+
+  static uint64_t
+  hash(const CryptoHash &key)
+  {
+    return mix64(key.u64[0] ^ mix64(key.u64[1]));
+  }
+
+  uint64_t
+  index(uint64_t h, int row) const
+  {
+    return mix64(h + row * 0x9e3779b97f4a7c15ULL) & mask;
+  }
+
+  static int
+  slot(uint64_t h, int row)
+  {
+    return row * 4 + ((h >> (row * 2)) & 3);
+  }
+
+  void
+  reset()
+  {
+    for (auto &word : table) {
+      word = (word >> 1) & 0x7777777777777777ULL;
+    }
+    additions /= 2;
+  }
+
+  std::vector<uint64_t> table;
+  uint64_t              mask        = 0;
+  int64_t               sample_size = 0;
+  int64_t               additions   = 0;
+};
+
+} // end anonymous namespace
+
+struct RamCacheTinyLFUEntry {
+  CryptoHash key;
+  uint64_t   auxkey;
+  LINK(RamCacheTinyLFUEntry, lru_link);
+  LINK(RamCacheTinyLFUEntry, hash_link);
+  Ptr<IOBufferData> data;
+  uint32_t          region; // WINDOW, PROBATION or PROTECTED
+};
+
+struct RamCacheTinyLFU : public RamCache {
+  enum { WINDOW, PROBATION, PROTECTED, REGIONS };
+
+  int64_t max_bytes = 0;
+  int64_t bytes     = 0;
+  int64_t objects   = 0;
+
+  // returns 1 on found/stored, 0 on not found/stored, if provided auxkey must match
+  int     get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey = 0) override;
+  int     put(CryptoHash *key, IOBufferData *data, uint32_t len, bool copy = false, uint64_t auxkey = 0) override;
+  int     fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey) override;
+  int64_t size() const override;
+
+  void init(int64_t max_bytes, StripeSM *stripe) override;
+
+  // private
+  FrequencySketch sketch;
+  Que(RamCacheTinyLFUEntry, lru_link) lru[REGIONS];
+  int64_t region_bytes[REGIONS]                  = {0, 0, 0};
+  int64_t window_max                             = 0;
+  int64_t protected_max                          = 0;
+  DList(RamCacheTinyLFUEntry, hash_link) *bucket = nullptr;
+  int       nbuckets                             = 0;
+  int       ibuckets                             = 0;
+  StripeSM *stripe                               = nullptr;
+
+  void                  resize_hashtable();
+  void                  touch(RamCacheTinyLFUEntry *e);
+  void                  move(RamCacheTinyLFUEntry *e, uint32_t region);
+  void                  admit(RamCacheTinyLFUEntry *candidate);
+  RamCacheTinyLFUEntry *remove(RamCacheTinyLFUEntry *e);
+};
+
+int64_t
+RamCacheTinyLFU::size() const
+{
+  int64_t s = 0;
+  for (auto const &q : lru) {
+    forl_LL(RamCacheTinyLFUEntry, e, q)
+    {
+      s += sizeof(*e);
+      s += sizeof(*e->data);
+      s += e->data->block_size();
+    }
+  }
+  return s;
+}
+
+ClassAllocator<RamCacheTinyLFUEntry> ramCacheTinyLFUEntryAllocator("RamCacheTinyLFUEntry");
+
+static const int bucket_sizes[] = {8191,    16381,   32749,    65521,    131071,   262139,    524287,    1048573,   2097143,
+                                   4194301, 8388593, 16777213, 33554393, 67108859, 134217689, 268435399, 536870909, 1073741827};
+
+void
+RamCacheTinyLFU::resize_hashtable()
+{
+  ink_release_assert(ibuckets < static_cast<int>(std::size(bucket_sizes)));
+
+  int anbuckets = bucket_sizes[ibuckets];
+  DDbg(dbg_ctl_ram_cache, "resize hashtable %d", anbuckets);
+  int64_t s                                          = anbuckets * sizeof(DList(RamCacheTinyLFUEntry, hash_link));
+  DList(RamCacheTinyLFUEntry, hash_link) *new_bucket = static_cast<DList(RamCacheTinyLFUEntry, hash_link) *>(ats_malloc(s));
+  memset(static_cast<void *>(new_bucket), 0, s);
+  if (bucket) {
+    for (int64_t i = 0; i < nbuckets; i++) {
+      RamCacheTinyLFUEntry *e = nullptr;
+      while ((e = bucket[i].pop())) {
+        new_bucket[e->key.slice32(3) % anbuckets].push(e);
+      }
+    }
+    ats_free(bucket);
+  }
+  bucket   = new_bucket;
+  nbuckets = anbuckets;
+}
+
+void
+RamCacheTinyLFU::init(int64_t abytes, StripeSM *astripe)
+{
+  stripe    = astripe;
+  max_bytes = abytes;
+  DDbg(dbg_ctl_ram_cache, "initializing ram_cache %" PRId64 " bytes", abytes);
+  if (!max_bytes) {
+    return;
+  }
+  window_max    = max_bytes * WINDOW_PERCENT / 100;
+  protected_max = (max_bytes - window_max) * PROTECTED_PERCENT / 100;
+  sketch.init(max_bytes / std::max(cache_config_min_average_object_size, 1));
+  resize_hashtable();
+}
+
+void
+RamCacheTinyLFU::move(RamCacheTinyLFUEntry *e, uint32_t region)
+{
+  uint32_t len = ENTRY_OVERHEAD + e->data->block_size();
+
+  lru[e->region].remove(e);
+  region_bytes[e->region] -= len;
+  e->region                = region;
+  lru[region].enqueue(e);
+  region_bytes[region] += len;
+}
+
+// A hit in probation promotes the entry to the protected segment, which in turn demotes its least recently used entries.
+void
+RamCacheTinyLFU::touch(RamCacheTinyLFUEntry *e)
+{
+  if (e->region != PROBATION) {
+    move(e, e->region);
+    return;
+  }
+  move(e, PROTECTED);
+  while (region_bytes[PROTECTED] > protected_max && lru[PROTECTED].head != e) {
+    move(lru[PROTECTED].head, PROBATION);
+  }
+}
+
+// Move the window's least recently used entry to the main space if it is accessed more often than what it would displace.
+void
+RamCacheTinyLFU::admit(RamCacheTinyLFUEntry *candidate)
+{
+  int64_t main_max = max_bytes - window_max;
+  int64_t len      = ENTRY_OVERHEAD + candidate->data->block_size();
+
+  while (region_bytes[PROBATION] + region_bytes[PROTECTED] + len > main_max) {
+    RamCacheTinyLFUEntry *victim = lru[PROBATION].head ? lru[PROBATION].head : lru[PROTECTED].head;
+    if (!victim || sketch.frequency(candidate->key) <= sketch.frequency(victim->key)) {
+      DDbg(dbg_ctl_ram_cache, "put %X %" PRIu64 " REJECTED", candidate->key.slice32(3), candidate->auxkey);
+      remove(candidate);
+      return;
+    }
+    remove(victim);
+  }
+  move(candidate, PROBATION);
+}
+
+int
+RamCacheTinyLFU::get(CryptoHash *key, Ptr<IOBufferData> *ret_data, uint64_t auxkey)
+{
+  if (!max_bytes) {
+    return 0;
+  }
+  sketch.increment(*key);
+  uint32_t              i = key->slice32(3) % nbuckets;
+  RamCacheTinyLFUEntry *e = bucket[i].head;
+  while (e) {
+    if (e->key == *key && e->auxkey == auxkey) {
+      touch(e);
+      (*ret_data) = e->data;
+      DDbg(dbg_ctl_ram_cache, "get %X %" PRIu64 " HIT", key->slice32(3), auxkey);
+      ts::Metrics::Counter::increment(cache_rsb.ram_cache_hits);
+      ts::Metrics::Counter::increment(stripe->cache_vol->vol_rsb.ram_cache_hits);
+
+      return 1;
+    }
+    e = e->hash_link.next;
+  }
+  DDbg(dbg_ctl_ram_cache, "get %X %" PRIu64 " MISS", key->slice32(3), auxkey);
+  ts::Metrics::Counter::increment(cache_rsb.ram_cache_misses);
+  ts::Metrics::Counter::increment(stripe->cache_vol->vol_rsb.ram_cache_misses);
+
+  return 0;
+}
+
+RamCacheTinyLFUEntry *
+RamCacheTinyLFU::remove(RamCacheTinyLFUEntry *e)
+{
+  RamCacheTinyLFUEntry *ret = e->hash_link.next;
+  uint32_t              b   = e->key.slice32(3) % nbuckets;
+  uint32_t              len = ENTRY_OVERHEAD + e->data->block_size();
+  bucket[b].remove(e);
+  lru[e->region].remove(e);
+  region_bytes[e->region] -= len;
+  bytes                   -= len;
+  ts::Metrics::Gauge::decrement(cache_rsb.ram_cache_bytes, len);
+  ts::Metrics::Gauge::decrement(stripe->cache_vol->vol_rsb.ram_cache_bytes, len);
+
+  DDbg(dbg_ctl_ram_cache, "put %X %" PRIu64 " FREED", e->key.slice32(3), e->auxkey);
+  e->data = nullptr;
+  THREAD_FREE(e, ramCacheTinyLFUEntryAllocator, this_thread());
+  objects--;
+  return ret;
+}
+
+// ignore 'copy' since we don't touch the data
+int
+RamCacheTinyLFU::put(CryptoHash *key, IOBufferData *data, [[maybe_unused]] uint32_t len, bool, uint64_t auxkey)
+{
+  if (!max_bytes) {
+    return 0;
+  }
+  uint32_t              i = key->slice32(3) % nbuckets;
+  RamCacheTinyLFUEntry *e = bucket[i].head;
+  while (e) {
+    if (e->key == *key) {
+      if (e->auxkey == auxkey) {
+        touch(e);
+        return 1;
+      } else { // discard when aux keys conflict
+        e = remove(e);
+        continue;
+      }
+    }
+    e = e->hash_link.next;
+  }
+  // The sketch is the admission filter, the seen filter is not used here.
+  sketch.increment(*key);
+  e         = THREAD_ALLOC(ramCacheTinyLFUEntryAllocator, this_ethread());
+  e->key    = *key;
+  e->auxkey = auxkey;
+  e->data   = data;
+  e->region = WINDOW;
+  bucket[i].push(e);
+  lru[WINDOW].enqueue(e);
+  region_bytes[WINDOW] += ENTRY_OVERHEAD + data->block_size();
+  bytes                += ENTRY_OVERHEAD + data->block_size();
+  objects++;
+  ts::Metrics::Gauge::increment(cache_rsb.ram_cache_bytes, ENTRY_OVERHEAD + data->block_size());
+  ts::Metrics::Gauge::increment(stripe->cache_vol->vol_rsb.ram_cache_bytes, ENTRY_OVERHEAD + data->block_size());
+  DDbg(dbg_ctl_ram_cache, "put %X %" PRIu64 " INSERTED", key->slice32(3), auxkey);
+  while (region_bytes[WINDOW] > window_max && lru[WINDOW].head) {
+    admit(lru[WINDOW].head);
+  }
+  if (objects > nbuckets * 0.75) { // Resize when 75% "full"
+    ++ibuckets;
+    resize_hashtable();
+  }
+  return 1;
+}
+
+int
+RamCacheTinyLFU::fixup(const CryptoHash *key, uint64_t old_auxkey, uint64_t new_auxkey)
+{
+  if (!max_bytes) {
+    return 0;
+  }
+  uint32_t              i = key->slice32(3) % nbuckets;
+  RamCacheTinyLFUEntry *e = bucket[i].head;
+  while (e) {
+    if (e->key == *key && e->auxkey == old_auxkey) {
+      e->auxkey = new_auxkey;
+      return 1;
+    }
+    e = e->hash_link.next;
+  }
+  return 0;
+}
+
+RamCache *
+new_RamCacheTinyLFU()
+{
+  return new RamCacheTinyLFU;
+}
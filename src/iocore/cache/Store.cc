@@ -40,6 +40,8 @@
 //
 const char Store::VOLUME_KEY[]           = "volume";
 const char Store::HASH_BASE_STRING_KEY[] = "id";
+const char Store::AGG_WRITE_SIZE_KEY[]   = "agg_write_size";
+const char Store::AGG_QUEUE_DEPTH_KEY[]  = "agg_queue_depth";
 
 namespace
 {
@@ -262,8 +264,10 @@ Store::read_config()
     Dbg(dbg_ctl_cache_init, "Store::read_config: \"%s\"", path);
     ++n_spans_in_config;
 
-    int64_t     size       = -1;
-    int         volume_num = -1;
+    int64_t     size            = -1;
+    int         volume_num      = -1;
+    int         agg_write_size  = 0;
+    int         agg_queue_depth = 0;
     const char *e;
     while (nullptr != (e = tokens.getNext())) {
       if (ParseRules::is_digit(*e)) {
@@ -291,6 +295,26 @@ Store::read_config()
           Error("%s failed to load", ts::filename::STORAGE);
           return Result::failure("failed to parse volume number '%s'", e);
         }
+      } else if (0 == strncasecmp(AGG_WRITE_SIZE_KEY, e, sizeof(AGG_WRITE_SIZE_KEY) - 1)) {
+        e += sizeof(AGG_WRITE_SIZE_KEY) - 1;
+        if ('=' == *e) {
+          ++e;
+        }
+        if (!*e || !ParseRules::is_digit(*e) || 0 >= (agg_write_size = ink_atoi(e))) {
+          delete sd;
+          Error("%s failed to load", ts::filename::STORAGE);
+          return Result::failure("failed to parse aggregation write size '%s'", e);
+        }
+      } else if (0 == strncasecmp(AGG_QUEUE_DEPTH_KEY, e, sizeof(AGG_QUEUE_DEPTH_KEY) - 1)) {
+        e += sizeof(AGG_QUEUE_DEPTH_KEY) - 1;
+        if ('=' == *e) {
+          ++e;
+        }
+        if (!*e || !ParseRules::is_digit(*e) || 0 >= (agg_queue_depth = ink_atoi(e)) || agg_queue_depth > 16) {
+          delete sd;
+          Error("%s failed to load", ts::filename::STORAGE);
+          return Result::failure("failed to parse aggregation queue depth '%s'", e);
+        }
       }
     }
 
@@ -314,6 +338,8 @@ Store::read_config()
     if (volume_num > 0) {
       ns->volume_number_set(volume_num);
     }
+    ns->agg_write_size        = agg_write_size;
+    ns->agg_write_queue_depth = agg_queue_depth;
 
     // new Span
     {
@@ -162,6 +162,8 @@ Stripe::_init_directory(std::size_t directory_size, int header_size, int footer_
   this->directory.header = reinterpret_cast<StripteHeaderFooter *>(this->directory.raw_dir);
   std::size_t const footer_offset{directory_size - static_cast<std::size_t>(footer_size)};
   this->directory.footer = reinterpret_cast<StripteHeaderFooter *>(this->directory.raw_dir + footer_offset);
+  // Neither copy on disk is known to match until the first sync of each.
+  this->directory.mark_all_dirty();
 }
 
 int
@@ -359,15 +361,23 @@ Stripe::_init_dir()
 bool
 Stripe::flush_aggregate_write_buffer(int fd)
 {
+  off_t agg_buf_offset = this->get_agg_buf_offset();
+
   // set write limit
-  this->directory.header->agg_pos = this->directory.header->write_pos + this->_write_buffer.get_buffer_pos();
+  this->directory.header->agg_pos = agg_buf_offset + this->_write_buffer.get_buffer_pos();
 
-  if (!this->_write_buffer.flush(fd, this->directory.header->write_pos)) {
+  if (!this->_write_buffer.flush(fd, agg_buf_offset)) {
     return false;
   }
-  this->directory.header->last_write_pos  = this->directory.header->write_pos;
-  this->directory.header->write_pos      += this->_write_buffer.get_buffer_pos();
-  ink_assert(this->directory.header->write_pos == this->directory.header->agg_pos);
+  // The documents of the writes in flight carry the serials following the
+  // current one, see StripeSM::aggWrite.
+  this->directory.header->write_serial += this->_write_buffer.get_writes_in_flight();
+  if (this->_write_buffer.is_empty() && this->_write_buffer.get_writes_in_flight()) {
+    this->directory.header->last_write_pos = this->_write_buffer.get_newest_write().offset;
+  } else {
+    this->directory.header->last_write_pos = agg_buf_offset;
+  }
+  this->directory.header->write_pos = this->directory.header->agg_pos;
   this->_write_buffer.reset_buffer_pos();
   this->directory.header->write_serial++;
 
@@ -381,7 +391,11 @@ Stripe::copy_from_aggregate_write_buffer(char *dest, Dir const &dir, size_t nbyt
     return false;
   }
 
-  int agg_offset = this->vol_offset(&dir) - this->directory.header->write_pos;
-  this->_write_buffer.copy_from(dest, agg_offset, nbytes);
+  off_t offset         = this->vol_offset(&dir);
+  off_t agg_buf_offset = this->get_agg_buf_offset();
+  if (offset < agg_buf_offset) {
+    return this->_write_buffer.copy_from_write(dest, offset, nbytes);
+  }
+  this->_write_buffer.copy_from(dest, offset - agg_buf_offset, nbytes);
   return true;
 }
@@ -126,13 +126,19 @@ public:
   off_t vol_relative_length(off_t start_offset) const;
 
   int get_agg_buf_pos() const;
+  /* Disk offset the aggregation buffer being filled will be written to,
+     past the data of the aggregation writes in flight.
+   */
+  off_t get_agg_buf_offset() const;
+  int   get_agg_writes_in_flight() const;
 
   /**
    * Retrieve a document from the aggregate write buffer.
    *
    * This is used to speed up reads by copying from the in-memory write buffer
-   * instead of reading from disk. If the document is not in the write buffer,
-   * nothing will be copied.
+   * instead of reading from disk. Documents of aggregation writes still in
+   * flight are copied from their buffer as well. If the document is not in
+   * memory, nothing will be copied.
    *
    * @param dir: The directory entry for the desired document.
    * @param dest: The destination buffer where the document will be copied to.
@@ -223,14 +229,14 @@ inline int
 Stripe::vol_in_phase_valid(Dir const *e) const
 {
   return (dir_offset(e) - 1 <
-          ((this->directory.header->write_pos + this->_write_buffer.get_buffer_pos() - this->start) / CACHE_BLOCK_SIZE));
+          ((this->get_agg_buf_offset() + this->_write_buffer.get_buffer_pos() - this->start) / CACHE_BLOCK_SIZE));
 }
 
 inline int
 Stripe::vol_in_phase_agg_buf_valid(Dir const *e) const
 {
   return (this->vol_offset(e) >= this->directory.header->write_pos &&
-          this->vol_offset(e) < (this->directory.header->write_pos + this->_write_buffer.get_buffer_pos()));
+          this->vol_offset(e) < (this->get_agg_buf_offset() + this->_write_buffer.get_buffer_pos()));
 }
 
 inline off_t
@@ -262,3 +268,15 @@ Stripe::get_agg_buf_pos() const
 {
   return this->_write_buffer.get_buffer_pos();
 }
+
+inline off_t
+Stripe::get_agg_buf_offset() const
+{
+  return this->directory.header->write_pos + this->_write_buffer.get_bytes_in_flight();
+}
+
+inline int
+Stripe::get_agg_writes_in_flight() const
+{
+  return this->_write_buffer.get_writes_in_flight();
+}
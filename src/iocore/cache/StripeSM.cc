@@ -52,6 +52,7 @@
 #include "tscore/ink_hrtime.h"
 #include "tscore/List.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <cstddef>
 #include <cstdlib>
@@ -68,6 +69,10 @@ namespace
 
 short int const CACHE_DB_MAJOR_VERSION_COMPATIBLE = 21;
 
+// The directory is read in pieces of this size, which are queued at once so
+// that the AIO threads of the disk read them in parallel.
+constexpr size_t DIR_READ_CHUNK_SIZE = 16 * 1024 * 1024;
+
 DbgCtl dbg_ctl_cache_dir_sync{"dir_sync"};
 DbgCtl dbg_ctl_cache_disk_error{"cache_disk_error"};
 DbgCtl dbg_ctl_cache_evac{"cache_evac"};
@@ -92,6 +97,11 @@ struct StripeInitInfo {
   AIOCallback vol_aio[4];
   char       *vol_h_f;
 
+  std::unique_ptr<AIOCallback[]> dir_aio;
+  int                            dir_aio_count   = 0;
+  int                            dir_aio_pending = 0;
+  bool                           dir_aio_failed  = false;
+
   StripeInitInfo()
   {
     recover_pos = 0;
@@ -105,6 +115,10 @@ struct StripeInitInfo {
       i.action = nullptr;
       i.mutex.clear();
     }
+    for (int i = 0; i < dir_aio_count; i++) {
+      dir_aio[i].action = nullptr;
+      dir_aio[i].mutex.clear();
+    }
     free(vol_h_f);
   }
 };
@@ -121,6 +135,18 @@ StripeSM::StripeSM(CacheDisk *disk, off_t blocks, off_t dir_skip, int avg_obj_si
 {
   open_dir.mutex = this->mutex;
   SET_HANDLER(&StripeSM::aggWrite);
+
+  _agg_write_depth = disk->agg_write_queue_depth > 0 ? disk->agg_write_queue_depth : cache_config_agg_write_queue_depth;
+  _write_buffer.set_depth(_agg_write_depth);
+  _write_buffer.set_size(disk->agg_write_size > 0 ? std::clamp(disk->agg_write_size, STORE_BLOCK_SIZE, AGG_SIZE) :
+                                                    cache_config_agg_write_size);
+  _agg_write_ops = std::make_unique<AggWriteOp[]>(_agg_write_depth);
+  for (int i = 0; i < _agg_write_depth; i++) {
+    AggWriteOp *op = &_agg_write_ops[i];
+    op->mutex      = this->mutex;
+    op->stripe     = this;
+    SET_CONTINUATION_HANDLER(op, &AggWriteOp::handle_write_done);
+  }
 }
 
 int
@@ -169,6 +195,8 @@ StripeSM::init(bool clear)
 {
   CryptoContext().hash_immediate(hash_id, hash_text, strlen(hash_text));
 
+  _init_start = ink_get_hrtime();
+
   // Evacuation
   this->recompute_hit_evacuate_window();
 
@@ -242,6 +270,13 @@ StripeSM::handle_dir_read(int event, void *data)
 
   if (event == AIO_EVENT_DONE) {
     if (!op->ok()) {
+      init_info->dir_aio_failed = true;
+    }
+    // Wait for all the pieces, a clear must not race with the reads still in flight.
+    if (--init_info->dir_aio_pending > 0) {
+      return EVENT_CONT;
+    }
+    if (init_info->dir_aio_failed) {
       Note("Directory read failed: clearing cache directory %s", this->hash_text.get());
       clear_dir_aio();
       return EVENT_DONE;
@@ -262,7 +297,10 @@ StripeSM::handle_dir_read(int event, void *data)
   }
   CHECK_DIR(this);
 
-  sector_size = directory.header->sector_size;
+  sector_size      = directory.header->sector_size;
+  _init_dir_loaded = ink_get_hrtime();
+  Dbg(dbg_ctl_cache_init, "directory of '%s' read in %" PRId64 " ms", hash_text.get(),
+      ink_hrtime_to_msec(_init_dir_loaded - _init_start));
 
   return this->recover_data();
 }
@@ -370,8 +408,9 @@ StripeSM::handle_recover_from_data(int event, void * /* data ATS_UNUSED */)
          were written to just before syncing the directory) and make sure
          that all documents have write_serial <= directory.header->write_serial.
        */
+      // This is zero if a failed write was skipped just before the sync, see aggWriteDone.
       uint32_t to_check = directory.header->write_pos - directory.header->last_write_pos;
-      ink_assert(to_check && to_check < (uint32_t)io.aiocb.aio_nbytes);
+      ink_assert(to_check < (uint32_t)io.aiocb.aio_nbytes);
       uint32_t done = 0;
       s             = static_cast<char *>(io.aiocb.aio_buf);
       while (done < to_check) {
@@ -657,8 +696,7 @@ StripeSM::handle_header_read(int event, void *data)
       if (dbg_ctl_cache_init.on()) {
         Note("using directory A for '%s'", hash_text.get());
       }
-      io.aiocb.aio_offset = skip;
-      ink_assert(ink_aio_read(&io));
+      this->_read_dir(skip);
     }
     // try B
     else if (hf[2]->sync_serial == hf[3]->sync_serial) {
@@ -666,8 +704,7 @@ StripeSM::handle_header_read(int event, void *data)
       if (dbg_ctl_cache_init.on()) {
         Note("using directory B for '%s'", hash_text.get());
       }
-      io.aiocb.aio_offset = skip + this->dirlen();
-      ink_assert(ink_aio_read(&io));
+      this->_read_dir(skip + this->dirlen());
     } else {
       Note("no good directory, clearing '%s' since sync_serials on both A and B copies are invalid", hash_text.get());
       Note("Header A: %d\nFooter A: %d\n Header B: %d\n Footer B %d\n", hf[0]->sync_serial, hf[1]->sync_serial, hf[2]->sync_serial,
@@ -690,22 +727,104 @@ StripeSM::dir_init_done(int /* event ATS_UNUSED */, void * /* data ATS_UNUSED */
     eventProcessor.schedule_in(this, HRTIME_MSECONDS(5), ET_CALL);
     return EVENT_CONT;
   } else {
-    int i = gnstripes++;
-    ink_assert(!gstripes[i]);
-    gstripes[i] = this;
+    // With early online stripes, Cache::open has registered the stripe already.
+    if (!cache_config_stripe_early_online) {
+      int i = gnstripes++;
+      ink_assert(!gstripes[i]);
+      gstripes[i] = this;
+    }
     SET_HANDLER(&StripeSM::aggWrite);
+    this->_init_done();
     cache->vol_initialized(fd != -1);
     return EVENT_DONE;
   }
 }
 
+/**
+  Read the directory at @a offset, in pieces that are read in parallel.
+  handle_dir_read continues once all of them are done.
+ */
+void
+StripeSM::_read_dir(off_t offset)
+{
+  size_t dir_len = this->dirlen();
+  int    n       = (dir_len + DIR_READ_CHUNK_SIZE - 1) / DIR_READ_CHUNK_SIZE;
+
+  init_info->dir_aio         = std::make_unique<AIOCallback[]>(n);
+  init_info->dir_aio_count   = n;
+  init_info->dir_aio_pending = n;
+  init_info->dir_aio_failed  = false;
+
+  for (int i = 0; i < n; i++) {
+    AIOCallback *aio      = &init_info->dir_aio[i];
+    size_t       done     = i * DIR_READ_CHUNK_SIZE;
+    aio->aiocb.aio_fildes = fd;
+    aio->aiocb.aio_buf    = directory.raw_dir + done;
+    aio->aiocb.aio_nbytes = std::min(dir_len - done, DIR_READ_CHUNK_SIZE);
+    aio->aiocb.aio_offset = offset + done;
+    aio->action           = this;
+    aio->thread           = AIO_CALLBACK_THREAD_ANY;
+    aio->then             = nullptr;
+  }
+  // The callbacks need the stripe lock, which is held here, so none of them
+  // can run before all the pieces are queued.
+  for (int i = 0; i < n; i++) {
+    ink_assert(ink_aio_read(&init_info->dir_aio[i]));
+  }
+}
+
+void
+StripeSM::register_init_stats(const std::string &prefix)
+{
+  _init_rsb.dir_read_time = ts::Metrics::Gauge::createPtr(prefix + ".init.dir_read_time");
+  _init_rsb.recover_time  = ts::Metrics::Gauge::createPtr(prefix + ".init.recover_time");
+  _init_rsb.total_time    = ts::Metrics::Gauge::createPtr(prefix + ".init.total_time");
+}
+
+void
+StripeSM::_init_done()
+{
+  ink_hrtime now = ink_get_hrtime();
+
+  // A cleared directory is not read, count the clear as the read.
+  if (_init_dir_loaded == 0) {
+    _init_dir_loaded = now;
+  }
+  if (_init_rsb.total_time) {
+    ts::Metrics::Gauge::store(_init_rsb.dir_read_time, ink_hrtime_to_msec(_init_dir_loaded - _init_start));
+    ts::Metrics::Gauge::store(_init_rsb.recover_time, ink_hrtime_to_msec(now - _init_dir_loaded));
+    ts::Metrics::Gauge::store(_init_rsb.total_time, ink_hrtime_to_msec(now - _init_start));
+  }
+  Dbg(dbg_ctl_cache_init, "stripe '%s' ready in %" PRId64 " ms", hash_text.get(), ink_hrtime_to_msec(now - _init_start));
+
+  if (fd == -1) {
+    return;
+  }
+  if (cache_config_stripe_early_online) {
+    // CacheProcessor::cacheInitialized may have run before the directory was read.
+    uint64_t used = dir_entries_used(this);
+    ts::Metrics::Gauge::increment(cache_rsb.direntries_used, used);
+    ts::Metrics::Gauge::increment(cache_vol->vol_rsb.direntries_used, used);
+  }
+  ts::Metrics::Gauge::increment(cache_rsb.stripes_online);
+  ts::Metrics::Gauge::increment(cache_vol->vol_rsb.stripes_online);
+  _ready.store(true, std::memory_order_release);
+}
+
+int
+AggWriteOp::handle_write_done(int event, void *data)
+{
+  done.store(true, std::memory_order_release);
+  return stripe->aggWriteDone(this, event, static_cast<Event *>(data));
+}
+
 /* NOTE:: This state can be called by an AIO thread, so DON'T DON'T
    DON'T schedule any events on this thread using VC_SCHED_XXX or
    mutex->thread_holding->schedule_xxx_local(). ALWAYS use
    eventProcessor.schedule_xxx().
    */
 int
-StripeSM::aggWriteDone(int event, Event *e)
+StripeSM::aggWriteDone(AggWriteOp *op, int event, Event *e)
 {
   cancel_trigger();
 
@@ -713,40 +832,61 @@ StripeSM::aggWriteDone(int event, Event *e)
   // retaking the current mutex recursively is a NOOP
   CACHE_TRY_LOCK(lock, dir_sync_waiting ? cacheDirSync->mutex : mutex, mutex->thread_holding);
   if (!lock.is_locked()) {
-    eventProcessor.schedule_in(this, HRTIME_MSECONDS(cache_config_mutex_retry_delay));
+    eventProcessor.schedule_in(op, HRTIME_MSECONDS(cache_config_mutex_retry_delay));
     return EVENT_CONT;
   }
-  if (io.ok()) {
-    directory.header->last_write_pos  = directory.header->write_pos;
-    directory.header->write_pos      += io.aiocb.aio_nbytes;
-    ink_assert(directory.header->write_pos >= start);
-    DDbg(dbg_ctl_cache_agg, "Dir %s, Write: %" PRIu64 ", last Write: %" PRIu64 "", hash_text.get(), directory.header->write_pos,
-         directory.header->last_write_pos);
-    ink_assert(directory.header->write_pos == directory.header->agg_pos);
-    if (directory.header->write_pos + EVACUATION_SIZE > scan_pos) {
-      ink_assert(this->mutex->thread_holding == this_ethread());
-      this->_preserved_dirs.periodic_scan(this);
-    }
-    this->_write_buffer.reset_buffer_pos();
-    directory.header->write_serial++;
-  } else {
-    // delete all the directory entries that we inserted
-    // for fragments is this aggregation buffer
-    Dbg(dbg_ctl_cache_disk_error, "Write error on disk %s\n \
+  // Writes can complete in any order, retire them in the order they were
+  // started so that the directory never covers data that is not on disk.
+  while (this->_write_buffer.get_writes_in_flight() &&
+         this->_agg_write_ops[this->_agg_write_head].done.load(std::memory_order_acquire)) {
+    AIOCallback &io       = this->_agg_write_ops[this->_agg_write_head].io;
+    off_t        write_at = this->_write_buffer.get_oldest_write().offset;
+
+    this->_agg_write_ops[this->_agg_write_head].done.store(false, std::memory_order_relaxed);
+    this->_agg_write_head = (this->_agg_write_head + 1) % this->_agg_write_depth;
+    ink_assert(write_at == directory.header->write_pos);
+
+    if (io.ok()) {
+      this->_write_buffer.finish_write();
+      directory.header->last_write_pos  = directory.header->write_pos;
+      directory.header->write_pos      += io.aiocb.aio_nbytes;
+      ink_assert(directory.header->write_pos >= start);
+      DDbg(dbg_ctl_cache_agg, "Dir %s, Write: %" PRIu64 ", last Write: %" PRIu64 "", hash_text.get(), directory.header->write_pos,
+           directory.header->last_write_pos);
+      ink_assert(this->_write_buffer.get_writes_in_flight() || directory.header->write_pos == directory.header->agg_pos);
+      if (directory.header->write_pos + EVACUATION_SIZE > scan_pos) {
+        ink_assert(this->mutex->thread_holding == this_ethread());
+        this->_preserved_dirs.periodic_scan(this);
+      }
+      directory.header->write_serial++;
+    } else {
+      // delete all the directory entries that we inserted
+      // for fragments is this aggregation buffer
+      Dbg(dbg_ctl_cache_disk_error, "Write error on disk %s\n \
             write range : [%" PRIu64 " - %" PRIu64 " bytes]  [%" PRIu64 " - %" PRIu64 " blocks] \n",
-        hash_text.get(), (uint64_t)io.aiocb.aio_offset, (uint64_t)io.aiocb.aio_offset + io.aiocb.aio_nbytes,
-        (uint64_t)io.aiocb.aio_offset / CACHE_BLOCK_SIZE, (uint64_t)(io.aiocb.aio_offset + io.aiocb.aio_nbytes) / CACHE_BLOCK_SIZE);
-    Dir del_dir;
-    dir_clear(&del_dir);
-    for (int done = 0; done < this->_write_buffer.get_buffer_pos();) {
-      Doc *doc = reinterpret_cast<Doc *>(this->_write_buffer.get_buffer() + done);
-      dir_set_offset(&del_dir, directory.header->write_pos + done);
-      dir_delete(&doc->key, this, &del_dir);
-      done += round_to_approx_size(doc->len);
+          hash_text.get(), (uint64_t)io.aiocb.aio_offset, (uint64_t)io.aiocb.aio_offset + io.aiocb.aio_nbytes,
+          (uint64_t)io.aiocb.aio_offset / CACHE_BLOCK_SIZE,
+          (uint64_t)(io.aiocb.aio_offset + io.aiocb.aio_nbytes) / CACHE_BLOCK_SIZE);
+      AggregateWriteBuffer::Write const &w = this->_write_buffer.get_oldest_write();
+      Dir                                del_dir;
+      dir_clear(&del_dir);
+      for (int done = 0; done < w.len;) {
+        Doc *doc = reinterpret_cast<Doc *>(w.buffer + done);
+        dir_set_offset(&del_dir, w.offset + done);
+        dir_delete(&doc->key, this, &del_dir);
+        done += round_to_approx_size(doc->len);
+      }
+      this->_write_buffer.finish_write();
+      // If nothing was placed behind the failed write the next one goes to
+      // the same position, otherwise the range is skipped. Recovery then has
+      // nothing to check before the write position.
+      if (this->_write_buffer.get_writes_in_flight() || !this->_write_buffer.is_empty()) {
+        directory.header->write_pos      += io.aiocb.aio_nbytes;
+        directory.header->last_write_pos  = directory.header->write_pos;
+        directory.header->write_serial++;
+      }
     }
-    this->_write_buffer.reset_buffer_pos();
   }
-  set_io_not_in_progress();
   // callback ready sync CacheVCs
   CacheVC *c = nullptr;
   while ((c = sync.dequeue())) {
@@ -757,11 +897,11 @@ StripeSM::aggWriteDone(int event, Event *e)
       break;
     }
   }
-  if (dir_sync_waiting) {
+  if (dir_sync_waiting && !this->_write_buffer.get_writes_in_flight()) {
     dir_sync_waiting = false;
     cacheDirSync->handleEvent(EVENT_IMMEDIATE, nullptr);
   }
-  if (this->_write_buffer.get_pending_writers().head || sync.head) {
+  if (!is_io_in_progress() && (this->_write_buffer.get_pending_writers().head || sync.head || dir_sync_waiting)) {
     return aggWrite(event, e);
   }
   return EVENT_CONT;
@@ -781,10 +921,16 @@ StripeSM::aggWrite(int event, void * /* e ATS_UNUSED */)
 
   Que(CacheVC, link) tocall;
   CacheVC *c;
+  off_t    agg_buf_offset;
 
   cancel_trigger();
 
 Lagain:
+  // every aggregation buffer is being written, wait for one to finish
+  if (!this->_write_buffer.can_aggregate()) {
+    goto Lwait;
+  }
+
   this->aggregate_pending_writes(tocall);
 
   // if we got nothing...
@@ -792,7 +938,7 @@ Lagain:
     if (!this->_write_buffer.get_pending_writers().head && !sync.head) { // nothing to get
       return EVENT_CONT;
     }
-    if (directory.header->write_pos == start) {
+    if (this->get_agg_buf_offset() == start) {
       // write aggregation too long, bad bad, punt on everything.
       Note("write aggregation exceeds vol size");
       ink_assert(!tocall.head);
@@ -803,34 +949,44 @@ Lagain:
       }
       return EVENT_CONT;
     }
-    // start back
+    // start back, once everything before the end of the stripe is on disk
     if (this->get_pending_writers().head) {
+      if (this->_write_buffer.get_writes_in_flight()) {
+        goto Lwait;
+      }
       agg_wrap();
       goto Lagain;
     }
   }
 
   // evacuate space
-  off_t end = directory.header->write_pos + this->_write_buffer.get_buffer_pos() + EVACUATION_SIZE;
-  if (evac_range(directory.header->write_pos, end, !directory.header->phase) < 0) {
-    goto Lwait;
-  }
-  if (end > skip + len) {
-    if (evac_range(start, start + (end - (skip + len)), directory.header->phase) < 0) {
+  agg_buf_offset = this->get_agg_buf_offset();
+  {
+    off_t end = agg_buf_offset + this->_write_buffer.get_buffer_pos() + EVACUATION_SIZE;
+    if (evac_range(agg_buf_offset, end, !directory.header->phase) < 0) {
       goto Lwait;
     }
+    if (end > skip + len) {
+      if (evac_range(start, start + (end - (skip + len)), directory.header->phase) < 0) {
+        goto Lwait;
+      }
+    }
   }
 
   // if write_buffer.get_pending_writers.head, then we are near the end of the disk, so
   // write down the aggregation in whatever size it is.
-  if (this->_write_buffer.get_buffer_pos() < AGG_HIGH_WATER && !this->_write_buffer.get_pending_writers().head && !sync.head &&
-      !dir_sync_waiting) {
+  if (this->_write_buffer.get_buffer_pos() < this->_write_buffer.get_size() / 2 &&
+      !this->_write_buffer.get_pending_writers().head && !sync.head && !dir_sync_waiting) {
     goto Lwait;
   }
 
   // write sync marker
   if (this->_write_buffer.is_empty()) {
     ink_assert(sync.head);
+    // the writes in flight move the write serial on as well
+    if (this->_write_buffer.get_writes_in_flight()) {
+      goto Lwait;
+    }
     int l = round_to_approx_size(sizeof(Doc));
     this->_write_buffer.seek(l);
     Doc *d = reinterpret_cast<Doc *>(this->_write_buffer.get_buffer());
@@ -842,21 +998,32 @@ Lagain:
   }
 
   // set write limit
-  directory.header->agg_pos = directory.header->write_pos + this->_write_buffer.get_buffer_pos();
+  directory.header->agg_pos = agg_buf_offset + this->_write_buffer.get_buffer_pos();
 
-  io.aiocb.aio_fildes = fd;
-  io.aiocb.aio_offset = directory.header->write_pos;
-  io.aiocb.aio_buf    = this->_write_buffer.get_buffer();
-  io.aiocb.aio_nbytes = this->_write_buffer.get_buffer_pos();
-  io.action           = this;
-  /*
-    Callback on AIO thread so that we can issue a new write ASAP
-    as all writes are serialized in the volume.  This is not necessary
-    for reads proceed independently.
-   */
-  io.thread = AIO_CALLBACK_THREAD_AIO;
-  SET_HANDLER(&StripeSM::aggWriteDone);
-  ink_aio_write(&io);
+  {
+    int         next = (this->_agg_write_head + this->_write_buffer.get_writes_in_flight()) % this->_agg_write_depth;
+    AggWriteOp *op   = &this->_agg_write_ops[next];
+
+    AggregateWriteBuffer::Write const &w = this->_write_buffer.start_write(agg_buf_offset);
+
+    op->io.aiocb.aio_fildes = fd;
+    op->io.aiocb.aio_offset = w.offset;
+    op->io.aiocb.aio_buf    = w.buffer;
+    op->io.aiocb.aio_nbytes = w.len;
+    op->io.action           = op;
+    /*
+      Callback on AIO thread so that we can issue a new write ASAP
+      as all writes are serialized in the volume.  This is not necessary
+      for reads proceed independently.
+     */
+    op->io.thread = AIO_CALLBACK_THREAD_AIO;
+    ink_aio_write(&op->io);
+  }
+
+  // keep aggregating into the next buffer while this one is written
+  if (this->_write_buffer.can_aggregate() && this->_write_buffer.get_pending_writers().head) {
+    goto Lagain;
+  }
 
 Lwait:
   int ret = EVENT_CONT;
@@ -873,16 +1040,19 @@ Lwait:
 void
 StripeSM::aggregate_pending_writes(Queue<CacheVC, Continuation::Link_link> &tocall)
 {
+  off_t agg_buf_offset = this->get_agg_buf_offset();
   for (auto *c = static_cast<CacheVC *>(this->_write_buffer.get_pending_writers().head); c;) {
     int writelen = c->agg_len;
     // [amc] this is checked multiple places, on here was it strictly less.
     ink_assert(writelen <= AGG_SIZE);
-    if (this->_write_buffer.get_buffer_pos() + writelen > AGG_SIZE ||
-        this->directory.header->write_pos + this->_write_buffer.get_buffer_pos() + writelen > (this->skip + this->len)) {
+    // A document larger than the configured write size still goes into an empty buffer.
+    int limit = this->_write_buffer.is_empty() ? AGG_SIZE : this->_write_buffer.get_size();
+    if (this->_write_buffer.get_buffer_pos() + writelen > limit ||
+        agg_buf_offset + this->_write_buffer.get_buffer_pos() + writelen > (this->skip + this->len)) {
       break;
     }
     DDbg(dbg_ctl_agg_read, "copying: %d, %" PRIu64 ", key: %d", this->_write_buffer.get_buffer_pos(),
-         this->directory.header->write_pos + this->_write_buffer.get_buffer_pos(), c->first_key.slice32(0));
+         agg_buf_offset + this->_write_buffer.get_buffer_pos(), c->first_key.slice32(0));
     [[maybe_unused]] int wrotelen = this->_agg_copy(c);
     ink_assert(writelen == wrotelen);
     CacheVC *n = static_cast<CacheVC *>(c->link.next);
@@ -922,9 +1092,9 @@ StripeSM::_copy_evacuator_to_aggregation(CacheVC *vc)
   ts::Metrics::Counter::increment(this->cache_vol->vol_rsb.gc_frags_evacuated);
 
   doc->sync_serial  = this->directory.header->sync_serial;
-  doc->write_serial = this->directory.header->write_serial;
+  doc->write_serial = this->_agg_write_serial();
 
-  off_t doc_offset{this->directory.header->write_pos + this->_write_buffer.get_buffer_pos()};
+  off_t doc_offset{this->get_agg_buf_offset() + this->_write_buffer.get_buffer_pos()};
   this->_write_buffer.add(doc, approx_size);
 
   vc->dir = vc->overwrite_dir;
@@ -936,7 +1106,7 @@ StripeSM::_copy_evacuator_to_aggregation(CacheVC *vc)
 int
 StripeSM::_copy_writer_to_aggregation(CacheVC *vc)
 {
-  off_t          doc_offset{this->directory.header->write_pos + this->get_agg_buf_pos()};
+  off_t          doc_offset{this->get_agg_buf_offset() + this->get_agg_buf_pos()};
   uint32_t       len         = vc->write_len + vc->header_len + vc->frag_len + sizeof(Doc);
   Doc           *doc         = this->_write_buffer.emplace(this->round_to_approx_size(len));
   IOBufferBlock *res_alt_blk = nullptr;
@@ -952,7 +1122,7 @@ StripeSM::_copy_writer_to_aggregation(CacheVC *vc)
   // fill in document header
   init_document(vc, doc, len);
   doc->sync_serial = this->directory.header->sync_serial;
-  vc->write_serial = doc->write_serial = this->directory.header->write_serial;
+  vc->write_serial = doc->write_serial = this->_agg_write_serial();
   if (vc->get_pin_in_cache()) {
     dir_set_pinned(&vc->dir, 1);
     doc->pin(vc->get_pin_in_cache());
@@ -1339,7 +1509,7 @@ StripeSM::shutdown(EThread *shutdown_thread)
   // check if we have data in the agg buffer
   // dont worry about the cachevc s in the agg queue
   // directories have not been inserted for these writes
-  if (!this->_write_buffer.is_empty()) {
+  if (!this->_write_buffer.is_empty() || this->get_agg_writes_in_flight()) {
     Dbg(dbg_ctl_cache_dir_sync, "Dir %s: flushing agg buffer first", this->hash_text.get());
     this->flush_aggregate_write_buffer(this->fd);
   }
@@ -1389,11 +1559,19 @@ StripeSM::open_write(CacheVC *cont, int allow_if_writers, int max_writers)
 int
 StripeSM::open_write_lock(CacheVC *cont, int allow_if_writers, int max_writers)
 {
+  if (!allow_if_writers && open_dir.has_writer(&cont->first_key)) {
+    ts::Metrics::Counter::increment(cache_rsb.write_busy_lockless);
+    ts::Metrics::Counter::increment(cache_vol->vol_rsb.write_busy_lockless);
+    return ECACHE_DOC_BUSY;
+  }
+
   EThread *t = cont->mutex->thread_holding;
   CACHE_TRY_LOCK(lock, mutex, t);
   if (!lock.is_locked()) {
+    cont->stripe_lock_missed();
     return -1;
   }
+  cont->stripe_lock_acquired();
   return open_write(cont, allow_if_writers, max_writers);
 }
 
@@ -35,7 +35,11 @@
 #include "tscore/CryptoHash.h"
 #include "tscore/List.h"
 
+#include "tsutil/Metrics.h"
+
 #include <atomic>
+#include <memory>
+#include <string>
 
 // Stripe
 #define STRIPE_MAGIC                 0xF1D0F00D
@@ -59,6 +63,23 @@ struct Cache;
 struct StripeInitInfo;
 class CacheEvacuateDocVC;
 class RamCache;
+class StripeSM;
+
+/**
+ * An aggregation write of a stripe.
+ *
+ * A stripe has one for each of its aggregation buffers, so that several
+ * writes can be in flight while the stripe itself reads documents to
+ * evacuate. The stripe mutex is used for all of them.
+ */
+struct AggWriteOp : public Continuation {
+  StripeSM         *stripe = nullptr;
+  AIOCallback       io;
+  /// Set on the AIO thread when the write completes, read under the stripe lock.
+  std::atomic<bool> done{false};
+
+  int handle_write_done(int event, void *data);
+};
 
 class StripeSM : public Continuation, public Stripe
 {
@@ -123,10 +144,23 @@ public:
 
   int dir_init_done(int event, void *data);
 
+  /**
+   * Whether the directory has been read and recovered.
+   *
+   * A stripe that is not ready yet is treated as a miss by the cache
+   * operations, see proxy.config.cache.stripe_early_online.
+   */
+  bool is_ready() const;
+
+  /**
+   * Create the startup timing metrics of this stripe, named after @a prefix.
+   */
+  void register_init_stats(const std::string &prefix);
+
   int  is_io_in_progress() const;
   void set_io_not_in_progress();
 
-  int aggWriteDone(int event, Event *e);
+  int aggWriteDone(AggWriteOp *op, int event, Event *e);
   int aggWrite(int event, void *e);
 
   /**
@@ -237,9 +271,33 @@ public:
     return this->_preserved_dirs;
   }
 
+protected:
+  // Ring of aggregation writes, one per aggregation buffer. The writes in
+  // flight start at _agg_write_head, in the order they were started.
+  std::unique_ptr<AggWriteOp[]> _agg_write_ops;
+  int                           _agg_write_depth = 1;
+  int                           _agg_write_head  = 0;
+
 private:
   mutable PreservationTable _preserved_dirs;
 
+  uint32_t _agg_write_serial() const;
+
+  std::atomic<bool> _ready{false};
+
+  // Startup timing, from init() to the directory being loaded and to the
+  // stripe being ready.
+  ink_hrtime _init_start      = 0;
+  ink_hrtime _init_dir_loaded = 0;
+  struct {
+    ts::Metrics::Gauge::AtomicType *dir_read_time = nullptr;
+    ts::Metrics::Gauge::AtomicType *recover_time  = nullptr;
+    ts::Metrics::Gauge::AtomicType *total_time    = nullptr;
+  } _init_rsb;
+
+  void _read_dir(off_t offset);
+  void _init_done();
+
   int _agg_copy(CacheVC *vc);
   int _copy_writer_to_aggregation(CacheVC *vc);
   int _copy_evacuator_to_aggregation(CacheVC *vc);
@@ -281,6 +339,20 @@ StripeSM::set_io_not_in_progress()
   io.aiocb.aio_fildes = AIO_NOT_IN_PROGRESS;
 }
 
+inline bool
+StripeSM::is_ready() const
+{
+  return _ready.load(std::memory_order_acquire);
+}
+
+// Documents are stamped with the serial their write will have once all the
+// writes ahead of it have finished.
+inline uint32_t
+StripeSM::_agg_write_serial() const
+{
+  return directory.header->write_serial + this->_write_buffer.get_writes_in_flight();
+}
+
 inline Queue<CacheVC, Continuation::Link_link> &
 StripeSM::get_pending_writers()
 {
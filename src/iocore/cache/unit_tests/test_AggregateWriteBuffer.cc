@@ -50,3 +50,54 @@ TEST_CASE("Given 10 bytes are pending to the buffer, "
   write_buffer.emplace(10);
   CHECK(0 == write_buffer.get_bytes_pending_aggregation());
 }
+
+TEST_CASE("Given a ring of two buffers, "
+          "when a write is started, "
+          "then aggregation continues in the other buffer and the data of the write stays readable.")
+{
+  AggregateWriteBuffer write_buffer;
+  write_buffer.set_depth(2);
+  write_buffer.emplace(512)->magic = DOC_MAGIC;
+  char *first                      = write_buffer.get_buffer();
+
+  auto const &w = write_buffer.start_write(8192);
+  CHECK(first == w.buffer);
+  CHECK(512 == w.len);
+  CHECK(1 == write_buffer.get_writes_in_flight());
+  CHECK(512 == write_buffer.get_bytes_in_flight());
+  REQUIRE(write_buffer.can_aggregate());
+  CHECK(write_buffer.is_empty());
+  CHECK(first != write_buffer.get_buffer());
+
+  Doc doc;
+  CHECK(write_buffer.copy_from_write(reinterpret_cast<char *>(&doc), 8192, sizeof(Doc)));
+  CHECK(DOC_MAGIC == doc.magic);
+  CHECK(!write_buffer.copy_from_write(reinterpret_cast<char *>(&doc), 8192 + 512, sizeof(Doc)));
+
+  write_buffer.emplace(512);
+  write_buffer.start_write(8192 + 512);
+  CHECK(!write_buffer.can_aggregate());
+  CHECK(8192 == write_buffer.get_oldest_write().offset);
+
+  write_buffer.finish_write();
+  CHECK(1 == write_buffer.get_writes_in_flight());
+  CHECK(512 == write_buffer.get_bytes_in_flight());
+  CHECK(8192 + 512 == write_buffer.get_oldest_write().offset);
+  REQUIRE(write_buffer.can_aggregate());
+  CHECK(first == write_buffer.get_buffer());
+  write_buffer.finish_write();
+}
+
+TEST_CASE("Given a ring of one buffer, "
+          "when a write is started, "
+          "then nothing can be aggregated until it is finished.")
+{
+  AggregateWriteBuffer write_buffer;
+  write_buffer.emplace(512);
+  write_buffer.start_write(0);
+  CHECK(!write_buffer.can_aggregate());
+  write_buffer.finish_write();
+  CHECK(write_buffer.can_aggregate());
+  CHECK(write_buffer.is_empty());
+  CHECK(0 == write_buffer.get_bytes_in_flight());
+}
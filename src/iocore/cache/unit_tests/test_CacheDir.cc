@@ -106,6 +106,14 @@ public:
     int  s   = key.slice32(0) % stripe->directory.segments, i, j;
     Dir *seg = stripe->directory.get_segment(s);
 
+    // test that an insert marks only its segment for the next sync of each copy
+    std::fill(stripe->directory.dirty_segments.begin(), stripe->directory.dirty_segments.end(), 0);
+    CHECK(dir_insert(&key, stripe, &dir));
+    for (i = 0; i < stripe->directory.segments; i++) {
+      CHECK(stripe->directory.dirty_segments[i] == (i == s ? (DIR_SYNC_COPY_A | DIR_SYNC_COPY_B) : 0));
+    }
+    CHECK(dir_delete(&key, stripe, &dir));
+
     // test insert
     int inserted = 0;
     int free     = dir_freelist_length(stripe, s);
@@ -0,0 +1,193 @@
+/** @file
+
+  Unit tests for the compression of RAM cache CLFUS entries
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "main.h"
+
+#include "../P_CacheInternal.h"
+#include "../P_RamCache.h"
+
+#include <cstring>
+#include <vector>
+
+// Required by main.h
+int  cache_vols           = 1;
+bool reuse_existing_cache = false;
+
+namespace
+{
+// More than three compression batches, so slots of the batch are reused.
+constexpr int     N_ENTRIES = 200;
+constexpr int     ENTRY_LEN = 4096;
+constexpr int64_t RAM_SIZE  = 64 * 1024 * 1024;
+
+// Every third entry is random data that does not compress. Batches are not a multiple of three, so
+// a slot that held an incompressible entry holds a compressible one in the next batch.
+bool
+is_random(int i)
+{
+  return i % 3 == 0;
+}
+
+void
+fill_entry(char *p, int i)
+{
+  if (is_random(i)) {
+    uint32_t x = 0x9e3779b9 * (i + 1);
+    for (int j = 0; j < ENTRY_LEN; j++) {
+      x    = x * 1664525 + 1013904223;
+      p[j] = static_cast<char>(x >> 24);
+    }
+  } else {
+    for (int j = 0; j < ENTRY_LEN; j++) {
+      p[j] = 'a' + (j + i) % 11;
+    }
+  }
+}
+
+CryptoHash
+entry_key(int i)
+{
+  CryptoHash key;
+  key.u64[0] = (static_cast<uint64_t>(i) << 32) + i;
+  key.u64[1] = (static_cast<uint64_t>(i) << 32) + i + 1;
+  return key;
+}
+
+std::vector<int> const compression_types = {
+  CACHE_COMPRESSION_FASTLZ,
+#ifdef HAVE_LZMA_H
+  CACHE_COMPRESSION_LIBLZMA,
+#endif
+#ifdef HAVE_ZSTD_H
+  CACHE_COMPRESSION_ZSTD,
+#endif
+};
+
+} // namespace
+
+class RamCacheCompressTest : public CacheInit
+{
+public:
+  int
+  cache_init_success_callback(int /* event ATS_UNUSED */, void * /* e ATS_UNUSED */) override
+  {
+    REQUIRE(CacheProcessor::IsCacheEnabled() == CACHE_INITIALIZED);
+    REQUIRE(gnstripes >= 1);
+
+    _stripe = gstripes[0];
+    SET_HANDLER(&RamCacheCompressTest::start_phase);
+    this_ethread()->schedule_imm(this);
+    return EVENT_DONE;
+  }
+
+  // Fill a new RAM cache for the next compression type, its compressor runs every second.
+  int
+  start_phase(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+  {
+    MUTEX_TRY_LOCK(lock, _stripe->mutex, this_ethread());
+    if (!lock.is_locked()) {
+      CONT_SCHED_LOCK_RETRY(this);
+      return EVENT_DONE;
+    }
+
+    cache_config_ram_cache_compress         = compression_types[_phase];
+    cache_config_ram_cache_compress_percent = 100;
+
+    // The cache is not freed, its compressor can not be cancelled.
+    _cache = new_RamCacheCLFUS();
+    _cache->init(RAM_SIZE, _stripe);
+
+    for (int i = 0; i < N_ENTRIES; i++) {
+      IOBufferData *d = THREAD_ALLOC(ioDataAllocator, this_thread());
+      d->alloc(BUFFER_SIZE_INDEX_4K);
+      fill_entry(d->data(), i);
+      CryptoHash key = entry_key(i);
+      REQUIRE(_cache->put(&key, d, ENTRY_LEN) == 1);
+    }
+    _initial_size = _cache->size();
+    _checks       = 0;
+
+    SET_HANDLER(&RamCacheCompressTest::check_phase);
+    this_ethread()->schedule_in(this, HRTIME_MSECONDS(100));
+    return EVENT_DONE;
+  }
+
+  int
+  check_phase(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+  {
+    MUTEX_TRY_LOCK(lock, _stripe->mutex, this_ethread());
+    if (!lock.is_locked()) {
+      CONT_SCHED_LOCK_RETRY(this);
+      return EVENT_DONE;
+    }
+
+    // Every compressible entry must shrink to less than half its size.
+    int64_t ncompressible = N_ENTRIES - (N_ENTRIES + 2) / 3;
+    int64_t expected      = _initial_size - ncompressible * ENTRY_LEN / 2;
+    if (_cache->size() > expected && ++_checks < 100) {
+      this_ethread()->schedule_in(this, HRTIME_MSECONDS(100));
+      return EVENT_DONE;
+    }
+
+    CAPTURE(compression_types[_phase]);
+    CHECK(_cache->size() <= expected);
+
+    char expected_data[ENTRY_LEN];
+    for (int i = 0; i < N_ENTRIES; i++) {
+      Ptr<IOBufferData> data;
+      CryptoHash        key = entry_key(i);
+      fill_entry(expected_data, i);
+      CAPTURE(i);
+      REQUIRE(_cache->get(&key, &data) == 1);
+      CHECK(memcmp(data->data(), expected_data, ENTRY_LEN) == 0);
+    }
+
+    if (++_phase < static_cast<int>(compression_types.size())) {
+      SET_HANDLER(&RamCacheCompressTest::start_phase);
+      this_ethread()->schedule_imm(this);
+      return EVENT_DONE;
+    }
+
+    cache_config_ram_cache_compress = CACHE_COMPRESSION_NONE;
+    test_done();
+    delete this;
+    return EVENT_DONE;
+  }
+
+private:
+  StripeSM *_stripe       = nullptr;
+  RamCache *_cache        = nullptr;
+  int       _phase        = 0;
+  int       _checks       = 0;
+  int64_t   _initial_size = 0;
+};
+
+TEST_CASE("RamCacheCLFUS compress")
+{
+  init_cache(0);
+
+  RamCacheCompressTest *init = new RamCacheCompressTest;
+
+  this_ethread()->schedule_imm(init);
+  this_thread()->execute();
+}
@@ -27,9 +27,11 @@
 #include "../P_CacheInternal.h"
 
 #include <array>
+#include <cerrno>
 #include <cstdint>
 #include <cstdio>
 #include <cstring>
+#include <limits>
 
 // Required by main.h
 int  cache_vols           = 1;
@@ -137,6 +139,42 @@ init_stripe_for_writing(StripeSM &stripe, StripteHeaderFooter &header, CacheVol
   return attach_tmpfile_to_stripe(stripe);
 }
 
+// A StripeSM whose aggregation writes are started and completed by the test
+// instead of AIO, so that the test decides the order in which they finish.
+class ManualAggWriteStripe : public StripeSM
+{
+public:
+  using StripeSM::StripeSM;
+
+  // Hand a buffer holding one empty document of @a len bytes to a write.
+  AggWriteOp &
+  start_agg_write(int len)
+  {
+    int         next = (this->_agg_write_head + this->_write_buffer.get_writes_in_flight()) % this->_agg_write_depth;
+    AggWriteOp *op   = &this->_agg_write_ops[next];
+
+    Doc *doc = reinterpret_cast<Doc *>(this->_write_buffer.get_buffer());
+    memset(static_cast<void *>(doc), 0, sizeof(Doc));
+    doc->magic = DOC_MAGIC;
+    doc->len   = len;
+    this->_write_buffer.seek(len);
+    this->directory.header->agg_pos = this->get_agg_buf_offset() + len;
+
+    AggregateWriteBuffer::Write const &w = this->_write_buffer.start_write(this->get_agg_buf_offset());
+
+    op->io.aiocb.aio_offset = w.offset;
+    op->io.aiocb.aio_nbytes = w.len;
+    return *op;
+  }
+};
+
+static void
+complete_agg_write(AggWriteOp &op, bool ok)
+{
+  op.io.aio_result = ok ? static_cast<int64_t>(op.io.aiocb.aio_nbytes) : -EIO;
+  op.handle_write_done(AIO_EVENT_DONE, nullptr);
+}
+
 TEST_CASE("The behavior of StripeSM::add_writer.")
 {
   FakeVC    vc;
@@ -402,3 +440,82 @@ TEST_CASE("aggWrite behavior with f.evacuator set")
   delete[] source;
   ats_free(stripe.directory.raw_dir);
 }
+
+TEST_CASE("aggWriteDone behavior with several writes in flight")
+{
+  CacheDisk disk;
+  init_disk(disk);
+  disk.hw_sector_size        = 256;
+  disk.agg_write_queue_depth = 3;
+  ManualAggWriteStripe stripe{&disk, 10, 0};
+  attach_tmpfile_to_stripe(stripe);
+  REQUIRE(0 == stripe.clear_dir());
+  // Keep the periodic evacuation scan out of the way.
+  stripe.scan_pos = std::numeric_limits<off_t>::max();
+
+  StripteHeaderFooter &header = *stripe.directory.header;
+  off_t const          start  = header.write_pos;
+  std::uint32_t const  serial = header.write_serial;
+  int const            len    = stripe.round_to_approx_size(sizeof(Doc) + 1000);
+
+  SCOPED_MUTEX_LOCK(lock, stripe.mutex, this_ethread());
+  AggWriteOp &first  = stripe.start_agg_write(len);
+  AggWriteOp &second = stripe.start_agg_write(len);
+  AggWriteOp &third  = stripe.start_agg_write(len);
+  REQUIRE(3 == stripe.get_agg_writes_in_flight());
+  CHECK(start + 3 * len == stripe.get_agg_buf_offset());
+
+  SECTION("Given the writes complete out of order, "
+          "then they should be retired in the order they were started.")
+  {
+    complete_agg_write(third, true);
+    CHECK(3 == stripe.get_agg_writes_in_flight());
+    CHECK(start == header.write_pos);
+    CHECK(serial == header.write_serial);
+
+    complete_agg_write(first, true);
+    CHECK(2 == stripe.get_agg_writes_in_flight());
+    CHECK(start + len == header.write_pos);
+    CHECK(serial + 1 == header.write_serial);
+
+    complete_agg_write(second, true);
+    CHECK(0 == stripe.get_agg_writes_in_flight());
+    CHECK(start + 3 * len == header.write_pos);
+    CHECK(start + 2 * len == header.last_write_pos);
+    CHECK(serial + 3 == header.write_serial);
+    CHECK(header.agg_pos == header.write_pos);
+  }
+
+  SECTION("Given the oldest write fails after the later ones completed, "
+          "then its range should be skipped.")
+  {
+    complete_agg_write(second, true);
+    complete_agg_write(third, true);
+    CHECK(3 == stripe.get_agg_writes_in_flight());
+    CHECK(start == header.write_pos);
+
+    complete_agg_write(first, false);
+    CHECK(0 == stripe.get_agg_writes_in_flight());
+    CHECK(start + 3 * len == header.write_pos);
+    CHECK(serial + 3 == header.write_serial);
+  }
+
+  SECTION("Given a retired write, "
+          "then its buffer should be reused for the next write.")
+  {
+    complete_agg_write(first, true);
+    AggWriteOp &fourth = stripe.start_agg_write(len);
+    CHECK(&first == &fourth);
+    CHECK(start + 4 * len == stripe.get_agg_buf_offset());
+
+    complete_agg_write(fourth, true);
+    complete_agg_write(third, true);
+    CHECK(3 == stripe.get_agg_writes_in_flight());
+    complete_agg_write(second, true);
+    CHECK(0 == stripe.get_agg_writes_in_flight());
+    CHECK(start + 4 * len == header.write_pos);
+    CHECK(serial + 4 == header.write_serial);
+  }
+
+  ats_free(stripe.directory.raw_dir);
+}
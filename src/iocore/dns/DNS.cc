@@ -56,6 +56,8 @@ int           dns_failover_number             = DEFAULT_FAILOVER_NUMBER;
 int           dns_failover_period             = DEFAULT_FAILOVER_PERIOD;
 int           dns_failover_try_period         = DEFAULT_FAILOVER_TRY_PERIOD;
 int           dns_max_dns_in_flight           = MAX_DNS_IN_FLIGHT;
+int           dns_max_dns_in_flight_per_ns    = 0;
+int           dns_adaptive_timeout            = 0;
 int           dns_max_tcp_continuous_failures = MAX_DNS_TCP_CONTINUOUS_FAILURES;
 int           dns_validate_qname              = 0;
 unsigned int  dns_handler_initialized         = 0;
@@ -105,6 +107,7 @@ static DNSEntry *get_dns(DNSHandler *h, uint16_t id);
 static void dns_result(DNSHandler *h, DNSEntry *e, HostEnt *ent, bool retry, bool tcp_retry = false);
 static void write_dns(DNSHandler *h, bool tcp_retry = false);
 static bool write_dns_event(DNSHandler *h, DNSEntry *e, bool over_tcp = false);
+static bool flush_dns(DNSHandler *h);
 // "reliable" name to try. need to build up first.
 static int try_servers         = 0;
 static int local_num_entries   = 1;
@@ -232,6 +235,8 @@ DNSProcessor::start(int, size_t stacksize)
   REC_EstablishStaticConfigInt32(dns_failover_number, "proxy.config.dns.failover_number");
   REC_EstablishStaticConfigInt32(dns_failover_period, "proxy.config.dns.failover_period");
   REC_EstablishStaticConfigInt32(dns_max_dns_in_flight, "proxy.config.dns.max_dns_in_flight");
+  REC_EstablishStaticConfigInt32(dns_max_dns_in_flight_per_ns, "proxy.config.dns.max_dns_in_flight_per_nameserver");
+  REC_EstablishStaticConfigInt32(dns_adaptive_timeout, "proxy.config.dns.adaptive_timeout");
   REC_EstablishStaticConfigInt32(dns_validate_qname, "proxy.config.dns.validate_query_name");
   REC_EstablishStaticConfigInt32(dns_ns_rr, "proxy.config.dns.round_robin_nameservers");
   REC_EstablishStaticConfigInt32(dns_max_tcp_continuous_failures, "proxy.config.dns.max_tcp_continuous_failures");
@@ -741,6 +746,9 @@ DNSHandler::switch_named(int ndx)
     }
   }
   in_flight = 0;
+  for (int &n : ns_in_flight) {
+    n = 0;
+  }
   received_one(ndx); // reset failover counters
 }
 
@@ -837,6 +845,9 @@ DNSHandler::rr_failure(int ndx)
       --in_flight;
       Metrics::Gauge::decrement(dns_rsb.in_flight);
     }
+    for (int &n : ns_in_flight) {
+      n = 0;
+    }
   } else {
     // move outstanding requests that were sent to this nameserver to another
     for (DNSEntry *e = entries.head; e; e = static_cast<DNSEntry *>(e->link.next)) {
@@ -849,6 +860,7 @@ DNSHandler::rr_failure(int ndx)
         Metrics::Gauge::decrement(dns_rsb.in_flight);
       }
     }
+    ns_in_flight[ndx] = 0;
   }
 }
 
@@ -859,6 +871,39 @@ good_rcode(char *buff)
   return NOERROR == r || NXDOMAIN == r;
 }
 
+void
+DNSHandler::recv_response(DNSConnection *dnsc, HostEnt *buf, int res)
+{
+  ip_text_buffer ipbuff;
+
+  if (dns_ns_rr) {
+    Dbg(dbg_ctl_dns, "round-robin: nameserver %d DNS response code = %d", dnsc->num, get_rcode(buf->buf));
+    if (good_rcode(buf->buf)) {
+      received_one(dnsc->num);
+      if (ns_down[dnsc->num]) {
+        Warning("connection to DNS server %s restored", ats_ip_ntop(&m_res->nsaddr_list[dnsc->num].sa, ipbuff, sizeof ipbuff));
+        ns_down[dnsc->num] = 0;
+      }
+    }
+  } else {
+    if (!dnsc->num) {
+      Dbg(dbg_ctl_dns, "primary DNS response code = %d", get_rcode(buf->buf));
+      if (good_rcode(buf->buf)) {
+        if (name_server) {
+          recover();
+        } else {
+          received_one(name_server);
+        }
+      }
+    }
+  }
+  if (dns_process(this, buf, res)) {
+    if (dnsc->num == name_server) {
+      received_one(name_server);
+    }
+  }
+}
+
 void
 DNSHandler::recv_dns(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
 {
@@ -867,9 +912,7 @@ DNSHandler::recv_dns(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
   Ptr<HostEnt>   buf;
   while ((dnsc = static_cast<DNSConnection *>(triggered.dequeue()))) {
     while (true) {
-      int        res;
-      IpEndpoint from_ip;
-      socklen_t  from_length = sizeof(from_ip);
+      int res;
       if (dnsc->opt._use_tcp) {
         if (dnsc->tcp_data.buf_ptr == nullptr) {
           dnsc->tcp_data.buf_ptr = make_ptr(dnsBufAllocator.alloc());
@@ -914,67 +957,85 @@ DNSHandler::recv_dns(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
         buf = dnsc->tcp_data.buf_ptr;
         res = dnsc->tcp_data.total_length;
         dnsc->tcp_data.reset();
-        goto Lsuccess;
-      }
-
-      if (!hostent_cache) {
-        hostent_cache = dnsBufAllocator.alloc();
+        recv_response(dnsc, buf.get(), res);
+        continue;
       }
 
-      res = dnsc->sock.recvfrom(hostent_cache->buf, MAX_DNS_RESPONSE_LEN, 0, &from_ip.sa, &from_length);
-      Dbg(dbg_ctl_dns, "DNSHandler::recv_dns res = [%d]", res);
-      if (res == -EAGAIN) {
-        break;
-      }
-      if (res <= 0) {
-      Lerror:
-        Dbg(dbg_ctl_dns, "named error: %d", res);
-        if (dns_ns_rr) {
-          rr_failure(dnsc->num);
-        } else if (dnsc->num == name_server) {
-          failover();
+      {
+        // Drain up to DNS_RECV_BATCH datagrams per call.
+        IpEndpoint from_ip[DNS_RECV_BATCH];
+        int        len[DNS_RECV_BATCH];
+        int        n = 0;
+
+#ifdef HAVE_RECVMMSG
+        mmsghdr msgs[DNS_RECV_BATCH];
+        iovec   iov[DNS_RECV_BATCH];
+        for (int i = 0; i < DNS_RECV_BATCH; ++i) {
+          if (!hostent_cache[i]) {
+            hostent_cache[i] = dnsBufAllocator.alloc();
+          }
+          iov[i].iov_base = hostent_cache[i]->buf;
+          iov[i].iov_len  = MAX_DNS_RESPONSE_LEN;
+          ink_zero(msgs[i]);
+          msgs[i].msg_hdr.msg_name    = &from_ip[i].sa;
+          msgs[i].msg_hdr.msg_namelen = sizeof(from_ip[i]);
+          msgs[i].msg_hdr.msg_iov     = &iov[i];
+          msgs[i].msg_hdr.msg_iovlen  = 1;
         }
-        break;
-      }
-
-      // verify that this response came from the correct server
-      if (!ats_ip_addr_eq(&dnsc->ip.sa, &from_ip.sa)) {
-        Warning("unexpected DNS response from %s (expected %s)", ats_ip_ntop(&from_ip.sa, ipbuff1, sizeof ipbuff1),
-                ats_ip_ntop(&dnsc->ip.sa, ipbuff2, sizeof ipbuff2));
-        continue;
-      }
-      buf              = hostent_cache;
-      hostent_cache    = nullptr;
-      buf->packet_size = res;
-      Dbg(dbg_ctl_dns, "received packet size = %d", res);
-    Lsuccess:
-      if (dns_ns_rr) {
-        Dbg(dbg_ctl_dns, "round-robin: nameserver %d DNS response code = %d", dnsc->num, get_rcode(buf->buf));
-        if (good_rcode(buf->buf)) {
-          received_one(dnsc->num);
-          if (ns_down[dnsc->num]) {
-            Warning("connection to DNS server %s restored",
-                    ats_ip_ntop(&m_res->nsaddr_list[dnsc->num].sa, ipbuff1, sizeof ipbuff1));
-            ns_down[dnsc->num] = 0;
+        res = dnsc->sock.recvmmsg(msgs, DNS_RECV_BATCH, 0, nullptr);
+        Dbg(dbg_ctl_dns, "DNSHandler::recv_dns recvmmsg res = [%d]", res);
+        if (res > 0) {
+          n = res;
+          for (int i = 0; i < n; ++i) {
+            len[i] = msgs[i].msg_len;
           }
         }
-      } else {
-        if (!dnsc->num) {
-          Dbg(dbg_ctl_dns, "primary DNS response code = %d", get_rcode(buf->buf));
-          if (good_rcode(buf->buf)) {
-            if (name_server) {
-              recover();
-            } else {
-              received_one(name_server);
-            }
+#else
+        if (!hostent_cache[0]) {
+          hostent_cache[0] = dnsBufAllocator.alloc();
+        }
+        socklen_t from_length = sizeof(from_ip[0]);
+        res                   = dnsc->sock.recvfrom(hostent_cache[0]->buf, MAX_DNS_RESPONSE_LEN, 0, &from_ip[0].sa, &from_length);
+        Dbg(dbg_ctl_dns, "DNSHandler::recv_dns res = [%d]", res);
+        if (res > 0) {
+          n      = 1;
+          len[0] = res;
+        }
+#endif
+        if (res == -EAGAIN) {
+          break;
+        }
+        if (res <= 0) {
+          goto Lerror;
+        }
+
+        for (int i = 0; i < n; ++i) {
+          if (len[i] <= 0) {
+            continue;
+          }
+          // verify that this response came from the correct server
+          if (!ats_ip_addr_eq(&dnsc->ip.sa, &from_ip[i].sa)) {
+            Warning("unexpected DNS response from %s (expected %s)", ats_ip_ntop(&from_ip[i].sa, ipbuff1, sizeof ipbuff1),
+                    ats_ip_ntop(&dnsc->ip.sa, ipbuff2, sizeof ipbuff2));
+            continue;
           }
+          buf              = hostent_cache[i];
+          hostent_cache[i] = nullptr;
+          buf->packet_size = len[i];
+          Dbg(dbg_ctl_dns, "received packet size = %d", len[i]);
+          recv_response(dnsc, buf.get(), len[i]);
         }
+        continue;
       }
-      if (dns_process(this, buf.get(), res)) {
-        if (dnsc->num == name_server) {
-          received_one(name_server);
-        }
+
+    Lerror:
+      Dbg(dbg_ctl_dns, "named error: %d", res);
+      if (dns_ns_rr) {
+        rr_failure(dnsc->num);
+      } else if (dnsc->num == name_server) {
+        failover();
       }
+      break;
     }
   }
 }
@@ -1086,7 +1147,7 @@ get_entry(DNSHandler *h, char *qname, int qtype)
   return nullptr;
 }
 
-/** Write up to dns_max_dns_in_flight entries. */
+/** Write up to dns_max_dns_in_flight entries, at most dns_max_dns_in_flight_per_ns to each nameserver. */
 static void
 write_dns(DNSHandler *h, bool tcp_retry)
 {
@@ -1117,9 +1178,12 @@ write_dns(DNSHandler *h, bool tcp_retry)
           int ns_start = h->name_server;
           do {
             h->name_server = (h->name_server + 1) % max_nscount;
-          } while (h->ns_down[h->name_server] && h->name_server != ns_start);
+          } while ((h->ns_down[h->name_server] || !h->ns_window_open(h->name_server)) && h->name_server != ns_start);
+        }
+        if (h->ns_down[h->name_server] || !h->ns_window_open(h->name_server) || !write_dns_event(h, e, over_tcp)) {
+          break;
         }
-        if (h->ns_down[h->name_server] || !write_dns_event(h, e, over_tcp)) {
+        if (h->send_batch.count == DNS_SEND_BATCH && !flush_dns(h)) {
           break;
         }
       }
@@ -1128,6 +1192,7 @@ write_dns(DNSHandler *h, bool tcp_retry)
       }
       e = n;
     }
+    flush_dns(h);
   }
   h->in_write_dns = false;
 }
@@ -1166,7 +1231,96 @@ DNSHandler::get_query_id()
 }
 
 /**
-  Construct and Write the request for a single entry (using send(3N)).
+  Send the UDP queries queued by write_dns_event(), with one sendmmsg(2) per
+  nameserver.  Queries that could not be sent are marked as not written so
+  the next write_dns() picks them up again.
+
+  @return true = all sent, false = give up for now.
+
+*/
+static bool
+flush_dns(DNSHandler *h)
+{
+  DNSHandler::SendBatch &b  = h->send_batch;
+  bool                   ok = true;
+
+  for (int ns = 0; ns < MAX_NAMED && b.count; ++ns) {
+    int idx[DNS_SEND_BATCH];
+    int k = 0;
+    for (int i = 0; i < b.count; ++i) {
+      if (b.ns[i] == ns) {
+        idx[k++] = i;
+      }
+    }
+    if (!k) {
+      continue;
+    }
+
+    UnixSocket con_sock = h->udpcon[ns].sock;
+    int        sent     = 0;
+    int        err      = 0;
+#ifdef HAVE_SENDMMSG
+    mmsghdr msgs[DNS_SEND_BATCH];
+    iovec   iov[DNS_SEND_BATCH];
+    for (int j = 0; j < k; ++j) {
+      iov[j].iov_base = b.buf[idx[j]];
+      iov[j].iov_len  = b.len[idx[j]];
+      ink_zero(msgs[j]);
+      msgs[j].msg_hdr.msg_iov    = &iov[j];
+      msgs[j].msg_hdr.msg_iovlen = 1;
+    }
+    if ((sent = con_sock.sendmmsg(msgs, k, 0)) < 0) {
+      err  = sent;
+      sent = 0;
+    }
+#else
+    for (; sent < k; ++sent) {
+      int s = con_sock.send(b.buf[idx[sent]], b.len[idx[sent]], 0);
+      if (s != b.len[idx[sent]]) {
+        err = s < 0 ? s : 0;
+        break;
+      }
+    }
+#endif
+    Dbg(dbg_ctl_dns, "sent %d of %d queries to nameserver %d on fd %d", sent, k, ns, con_sock.get_fd());
+
+    for (int j = 0; j < k; ++j) {
+      DNSEntry *e = b.entry[idx[j]];
+      if (j < sent) {
+        Dbg(dbg_ctl_dns, "sent qname = %s, id = %u, nameserver = %d", e->qname, e->id[dns_retries - e->retries], ns);
+        h->sent_one(ns);
+        continue;
+      }
+      Dbg(dbg_ctl_dns, "send() failed: qname = %s, nameserver= %d", e->qname, ns);
+      e->written_flag = false;
+      e->which_ns     = NO_NAMESERVER_SELECTED;
+      --h->in_flight;
+      Metrics::Gauge::decrement(dns_rsb.in_flight);
+      h->ns_done(ns);
+      if (e->timeout) {
+        e->timeout->cancel();
+        e->timeout = nullptr;
+      }
+    }
+
+    if (sent < k) {
+      ok = false;
+      if (err < 0) {
+        if (dns_ns_rr) {
+          h->rr_failure(ns);
+        } else {
+          h->failover();
+        }
+      }
+    }
+  }
+  b.count = 0;
+  return ok;
+}
+
+/**
+  Construct and Write the request for a single entry.  TCP requests are sent
+  right away (using send(3N)), UDP requests are queued for flush_dns().
 
   @return true = keep going, false = give up for now.
 
@@ -1174,10 +1328,11 @@ DNSHandler::get_query_id()
 static bool
 write_dns_event(DNSHandler *h, DNSEntry *e, bool over_tcp)
 {
-  unsigned char buffer[MAX_DNS_REQUEST_LEN];
-  int           offset = over_tcp ? tcp_data_length_offset : 0;
-  HEADER       *header = reinterpret_cast<HEADER *>(buffer + offset);
-  int           r      = 0;
+  unsigned char  tcp_buffer[MAX_DNS_REQUEST_LEN];
+  unsigned char *buffer = over_tcp ? tcp_buffer : h->send_batch.buf[h->send_batch.count];
+  int            offset = over_tcp ? tcp_data_length_offset : 0;
+  HEADER        *header = reinterpret_cast<HEADER *>(buffer + offset);
+  int            r      = 0;
 
   if ((r = _ink_res_mkquery(h->m_res, e->qname, e->qtype, buffer, over_tcp)) <= 0) {
     Dbg(dbg_ctl_dns, "cannot build query: %s", e->qname);
@@ -1192,42 +1347,51 @@ write_dns_event(DNSHandler *h, DNSEntry *e, bool over_tcp)
     h->release_query_id(e->id[dns_retries - e->retries]);
   }
   e->id[dns_retries - e->retries] = i;
-  UnixSocket con_sock             = over_tcp ? h->tcpcon[h->name_server].sock : h->udpcon[h->name_server].sock;
-  Dbg(dbg_ctl_dns, "send query (qtype=%d) for %s to fd %d", e->qtype, e->qname, con_sock.get_fd());
 
-  int s = con_sock.send(buffer, r, 0);
-  if (s != r) {
-    Dbg(dbg_ctl_dns, "send() failed: qname = %s, %d != %d, nameserver= %d", e->qname, s, r, h->name_server);
+  if (!over_tcp) {
+    DNSHandler::SendBatch &b = h->send_batch;
+    b.entry[b.count]         = e;
+    b.ns[b.count]            = h->name_server;
+    b.len[b.count]           = r;
+    ++b.count;
+    Dbg(dbg_ctl_dns, "queue query (qtype=%d) for %s to nameserver %d", e->qtype, e->qname, h->name_server);
+  } else {
+    UnixSocket con_sock = h->tcpcon[h->name_server].sock;
+    Dbg(dbg_ctl_dns, "send query (qtype=%d) for %s to fd %d", e->qtype, e->qname, con_sock.get_fd());
+
+    int s = con_sock.send(buffer, r, 0);
+    if (s != r) {
+      Dbg(dbg_ctl_dns, "send() failed: qname = %s, %d != %d, nameserver= %d", e->qname, s, r, h->name_server);
 
-    if (over_tcp) {
       // add the counter for tcp connection failed
       Dbg(dbg_ctl_dns, "tcp query failed: name_server = %d, tcp_continuous_failures = %d", h->name_server,
           h->tcp_continuous_failures[h->name_server]);
       ++h->tcp_continuous_failures[h->name_server];
-    }
 
-    // changed if condition from 'r < 0' to 's < 0' - 8/2001 pas
-    if (s < 0) {
-      if (dns_ns_rr) {
-        h->rr_failure(h->name_server);
-      } else {
-        h->failover();
+      // changed if condition from 'r < 0' to 's < 0' - 8/2001 pas
+      if (s < 0) {
+        if (dns_ns_rr) {
+          h->rr_failure(h->name_server);
+        } else {
+          h->failover();
+        }
       }
+      return false;
     }
-    return false;
-  }
 
-  if (over_tcp && h->tcp_continuous_failures[h->name_server] > 0) {
-    // reset the counter for any tcp connection succeed
-    Dbg(dbg_ctl_dns, "reset tcp_continuous_failures: name_server = %d, tcp_continuous_failures = %d", h->name_server,
-        h->tcp_continuous_failures[h->name_server]);
-    h->tcp_continuous_failures[h->name_server] = 0;
+    if (h->tcp_continuous_failures[h->name_server] > 0) {
+      // reset the counter for any tcp connection succeed
+      Dbg(dbg_ctl_dns, "reset tcp_continuous_failures: name_server = %d, tcp_continuous_failures = %d", h->name_server,
+          h->tcp_continuous_failures[h->name_server]);
+      h->tcp_continuous_failures[h->name_server] = 0;
+    }
   }
 
   e->written_flag      = true;
   e->which_ns          = h->name_server;
   e->once_written_flag = true;
   ++h->in_flight;
+  ++h->ns_in_flight[h->name_server];
   Metrics::Gauge::increment(dns_rsb.in_flight);
 
   e->send_time = ink_get_hrtime();
@@ -1239,11 +1403,14 @@ write_dns_event(DNSHandler *h, DNSEntry *e, bool over_tcp)
   if (h->txn_lookup_timeout) {
     e->timeout = h->mutex->thread_holding->schedule_in(e, HRTIME_MSECONDS(h->txn_lookup_timeout)); // this is in msec
   } else {
-    e->timeout = h->mutex->thread_holding->schedule_in(e, HRTIME_SECONDS(dns_timeout));
+    ink_hrtime t = over_tcp ? HRTIME_SECONDS(dns_timeout) : h->query_timeout(h->name_server);
+    e->timeout   = h->mutex->thread_holding->schedule_in(e, t);
   }
 
-  Dbg(dbg_ctl_dns, "sent qname = %s, id = %u, nameserver = %d", e->qname, e->id[dns_retries - e->retries], h->name_server);
-  h->sent_one();
+  if (over_tcp) {
+    Dbg(dbg_ctl_dns, "sent qname = %s, id = %u, nameserver = %d", e->qname, e->id[dns_retries - e->retries], h->name_server);
+    h->sent_one(h->name_server);
+  }
   return true;
 }
 
@@ -1294,6 +1461,7 @@ DNSEntry::mainEvent(int event, Event *e)
     DNSEntry *dup = get_entry(dnsH, qname, qtype);
     if (dup) {
       Dbg(dbg_ctl_dns, "collapsing NS request");
+      Metrics::Counter::increment(dns_rsb.coalesced_lookups);
       dup->dups.enqueue(this);
     } else {
       Dbg(dbg_ctl_dns, "adding first to collapsing queue");
@@ -1313,6 +1481,7 @@ DNSEntry::mainEvent(int event, Event *e)
       Dbg(dbg_ctl_dns, "marking %s as not-written", qname);
       written_flag = false;
       --(dnsH->in_flight);
+      dnsH->ns_done(which_ns);
       Metrics::Gauge::decrement(dns_rsb.in_flight);
     }
     timeout = nullptr;
@@ -1570,9 +1739,15 @@ dns_process(DNSHandler *handler, HostEnt *buf, int len)
   //
   e->written_flag = false;
   --(handler->in_flight);
+  handler->ns_done(e->which_ns);
   Metrics::Gauge::decrement(dns_rsb.in_flight);
   // These are rolling averages
-  ink_hrtime diff = (ink_get_hrtime() - e->send_time) / HRTIME_MSECOND;
+  ink_hrtime rtt  = ink_get_hrtime() - e->send_time;
+  ink_hrtime diff = rtt / HRTIME_MSECOND;
+
+  if (e->which_ns >= 0 && e->which_ns < MAX_NAMED) {
+    handler->ns_rtt[e->which_ns].record(rtt);
+  }
 
   Metrics::Counter::increment(dns_rsb.response_time, diff);
 
@@ -1918,6 +2093,7 @@ ink_dns_init(ts::ModuleVersion v)
   //
   // Register statistics callbacks
   //
+  dns_rsb.coalesced_lookups    = Metrics::Counter::createPtr("proxy.process.dns.coalesced_lookups");
   dns_rsb.fail_time            = Metrics::Counter::createPtr("proxy.process.dns.fail_time");
   dns_rsb.in_flight            = Metrics::Gauge::createPtr("proxy.process.dns.in_flight");
   dns_rsb.lookup_fail          = Metrics::Counter::createPtr("proxy.process.dns.lookup_failures");
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 
@@ -76,6 +77,8 @@ extern int          dns_failover_number;
 extern int          dns_failover_period;
 extern int          dns_failover_try_period;
 extern int          dns_max_dns_in_flight;
+extern int          dns_max_dns_in_flight_per_ns;
+extern int          dns_adaptive_timeout;
 extern int          dns_max_tcp_continuous_failures;
 extern unsigned int dns_sequence_number;
 
@@ -90,6 +93,11 @@ extern unsigned int dns_sequence_number;
 #define DNS_PRIMARY_REOPEN_PERIOD          HRTIME_SECONDS(60)
 #define BAD_DNS_RESULT                     (reinterpret_cast<HostEnt *>((uintptr_t) - 1))
 #define DEFAULT_NUM_TRY_SERVER             8
+#define DNS_SEND_BATCH                     32 // queries sent per sendmmsg(2)
+#define DNS_RECV_BATCH                     8  // responses read per recvmmsg(2)
+#define DNS_RTT_MIN_SAMPLES                64
+#define DNS_RTT_DECAY_SAMPLES              1024
+#define DNS_MIN_ADAPTIVE_TIMEOUT           HRTIME_MSECONDS(250)
 
 // these are from nameser.h
 #ifndef HFIXEDSZ
@@ -101,6 +109,7 @@ extern unsigned int dns_sequence_number;
 
 // Stats
 struct DNSStatsBlock {
+  Metrics::Counter::AtomicType *coalesced_lookups;
   Metrics::Counter::AtomicType *fail_time;
   Metrics::Gauge::AtomicType   *in_flight;
   Metrics::Counter::AtomicType *lookup_fail;
@@ -168,6 +177,53 @@ using DNSEntryHandler = int (DNSEntry::*)(int, void *);
 
 struct DNSEntry;
 
+/**
+  Histogram of the round trip times of one nameserver, in power of two
+  millisecond buckets.  Counts are halved every DNS_RTT_DECAY_SAMPLES samples
+  so the histogram follows changes in the network.
+
+*/
+struct DNSRTTHistogram {
+  static constexpr int N_BUCKETS = 16; ///< Bucket @a i holds times below 2^i ms, the last one everything else.
+
+  uint32_t bucket[N_BUCKETS] = {0};
+  uint32_t total             = 0;
+
+  void
+  record(ink_hrtime rtt)
+  {
+    int      i  = 0;
+    uint64_t ms = rtt > 0 ? rtt / HRTIME_MSECOND : 0;
+    while (ms && i < N_BUCKETS - 1) {
+      ms >>= 1;
+      ++i;
+    }
+    ++bucket[i];
+    if (++total >= DNS_RTT_DECAY_SAMPLES) {
+      total = 0;
+      for (auto &b : bucket) {
+        b     >>= 1;
+        total  += b;
+      }
+    }
+  }
+
+  /// Upper bound of the bucket holding the @a pct percentile.
+  ink_hrtime
+  percentile(int pct) const
+  {
+    uint64_t target = (static_cast<uint64_t>(total) * pct + 99) / 100;
+    uint64_t seen   = 0;
+    int      i      = 0;
+    for (; i < N_BUCKETS - 1; ++i) {
+      if ((seen += bucket[i]) >= target) {
+        break;
+      }
+    }
+    return HRTIME_MSECONDS(1 << i);
+  }
+};
+
 /**
   One DNSHandler is allocated to handle all DNS traffic by polling a
   UDP port.
@@ -188,7 +244,19 @@ struct DNSHandler : public Continuation {
   int                  name_server  = 0;
   int                  in_write_dns = 0;
 
-  HostEnt *hostent_cache = nullptr;
+  HostEnt *hostent_cache[DNS_RECV_BATCH] = {nullptr};
+
+  /// UDP queries built by write_dns_event() waiting for the sendmmsg(2) in flush_dns().
+  struct SendBatch {
+    int           count = 0;
+    DNSEntry     *entry[DNS_SEND_BATCH];
+    int           ns[DNS_SEND_BATCH];
+    int           len[DNS_SEND_BATCH];
+    unsigned char buf[DNS_SEND_BATCH][MAX_DNS_REQUEST_LEN];
+  } send_batch;
+
+  int             ns_in_flight[MAX_NAMED];
+  DNSRTTHistogram ns_rtt[MAX_NAMED];
 
   int        ns_down[MAX_NAMED];
   int        failover_number[MAX_NAMED];
@@ -211,13 +279,45 @@ struct DNSHandler : public Continuation {
     failover_number[i] = failover_soon_number[i] = crossed_failover_number[i] = 0;
   }
 
+  /// Whether nameserver @a i may take another query.
+  bool
+  ns_window_open(int i) const
+  {
+    return dns_max_dns_in_flight_per_ns <= 0 || ns_in_flight[i] < dns_max_dns_in_flight_per_ns;
+  }
+
+  /// A query sent to nameserver @a i is no longer in flight.
+  void
+  ns_done(int i)
+  {
+    if (i >= 0 && i < MAX_NAMED && ns_in_flight[i] > 0) {
+      --ns_in_flight[i];
+    }
+  }
+
+  /** Time to wait for a UDP response from nameserver @a i.
+
+      With proxy.config.dns.adaptive_timeout enabled this is twice the 99th
+      percentile of the measured round trip times, bounded by
+      DNS_MIN_ADAPTIVE_TIMEOUT and proxy.config.dns.lookup_timeout.
+  */
+  ink_hrtime
+  query_timeout(int i) const
+  {
+    ink_hrtime t = HRTIME_SECONDS(dns_timeout);
+    if (dns_adaptive_timeout && ns_rtt[i].total >= DNS_RTT_MIN_SAMPLES) {
+      t = std::min(std::max(2 * ns_rtt[i].percentile(99), DNS_MIN_ADAPTIVE_TIMEOUT), t);
+    }
+    return t;
+  }
+
   void
-  sent_one()
+  sent_one(int i)
   {
-    ++failover_number[name_server];
-    Dbg(_dbg_ctl_dns, "sent_one: failover_number for resolver %d is %d", name_server, failover_number[name_server]);
-    if (failover_number[name_server] >= dns_failover_number && !crossed_failover_number[name_server]) {
-      crossed_failover_number[name_server] = ink_get_hrtime();
+    ++failover_number[i];
+    Dbg(_dbg_ctl_dns, "sent_one: failover_number for resolver %d is %d", i, failover_number[i]);
+    if (failover_number[i] >= dns_failover_number && !crossed_failover_number[i]) {
+      crossed_failover_number[i] = ink_get_hrtime();
     }
   }
 
@@ -282,6 +382,8 @@ private:
   // Check tcp connection for TCP_RETRY mode
   void check_and_reset_tcp_conn();
   bool reset_tcp_conn(int ndx);
+  // Failover bookkeeping and decoding of one response read from @a dnsc.
+  void recv_response(DNSConnection *dnsc, HostEnt *buf, int len);
 
   /** The event used for the periodic retry of connectivity to any down name
    * servers. */
@@ -328,6 +430,7 @@ DNSHandler::DNSHandler()
     failover_soon_number[i]    = 0;
     crossed_failover_number[i] = 0;
     tcp_continuous_failures[i] = 0;
+    ns_in_flight[i]            = 0;
     ns_down[i]                 = 1;
     tcpcon[i].handler          = this;
     udpcon[i].handler          = this;
@@ -101,7 +101,12 @@ EventProcessor::schedule(Event *e, EventType etype)
 
   EThread *affinity_thread = e->continuation->getThreadAffinity();
   EThread *curr_thread     = this_ethread();
-  if (affinity_thread != nullptr && affinity_thread->is_event_type(etype)) {
+  bool     has_affinity    = affinity_thread != nullptr && affinity_thread->is_event_type(etype);
+  if (!has_affinity && thread_group[etype]._work_stealing && e->timeout_at == 0 && e->period == 0) {
+    return schedule_stealable(e, etype, curr_thread);
+  }
+
+  if (has_affinity) {
     e->ethread = affinity_thread;
   } else {
     // Is the current thread eligible?
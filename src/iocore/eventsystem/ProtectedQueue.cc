@@ -91,8 +91,68 @@ ProtectedQueue::wait(ink_hrtime timeout)
    *   - And then the Event Thread goes to sleep and waits for the wakeup signal of `EThread::might_have_data`,
    *   - The `EThread::lock` will be locked again when the Event Thread wakes up.
    */
-  if (INK_ATOMICLIST_EMPTY(al) && localQueue.empty()) {
+  if (INK_ATOMICLIST_EMPTY(al) && localQueue.empty() && stealCount.load(std::memory_order_relaxed) == 0) {
     timespec ts = ink_hrtime_to_timespec(timeout);
     ink_cond_timedwait(&might_have_data, &lock, &ts);
   }
 }
+
+int
+ProtectedQueue::enqueue_stealable(Event *e)
+{
+  ink_assert(!e->in_the_prot_queue && !e->in_the_priority_queue);
+  ink_assert(e->timeout_at == 0 && e->period == 0);
+
+  ink_scoped_mutex_lock guard(stealLock);
+  e->in_the_prot_queue = 1;
+  stealQueue.enqueue(e);
+  return ++stealCount;
+}
+
+Event *
+ProtectedQueue::dequeue_stealable()
+{
+  if (stealCount.load(std::memory_order_relaxed) == 0) {
+    return nullptr;
+  }
+
+  ink_scoped_mutex_lock guard(stealLock);
+  Event                *e = stealQueue.dequeue();
+  if (e) {
+    --stealCount;
+    e->in_the_prot_queue = 0;
+  }
+  return e;
+}
+
+int
+ProtectedQueue::steal(ProtectedQueue &victim, EThread *thief)
+{
+  // Unlocked peek, a busy victim is skipped rather than waited for.
+  if (victim.stealCount.load(std::memory_order_relaxed) == 0 || !ink_mutex_try_acquire(&victim.stealLock)) {
+    return 0;
+  }
+
+  // Take the newest half, the owner keeps running its queue from the oldest event.
+  Que(Event, link) stolen;
+  int n = (victim.stealCount + 1) / 2;
+  for (int i = 0; i < n; ++i) {
+    Event *e = victim.stealQueue.tail;
+    if (e == nullptr) {
+      n = i;
+      break;
+    }
+    victim.stealQueue.remove(e);
+    e->ethread = thief;
+    stolen.push(e);
+  }
+  victim.stealCount -= n;
+  ink_mutex_release(&victim.stealLock);
+
+  if (n > 0) {
+    ink_scoped_mutex_lock guard(stealLock);
+    stealQueue.append(stolen);
+    stealCount += n;
+  }
+  return n;
+}
@@ -30,6 +30,9 @@ extern int cmd_disable_pfreelist;
 void *
 thread_alloc(Allocator &a, ProxyAllocator &l)
 {
+  if (!cmd_disable_pfreelist && !l.freelist) {
+    l.allocated = a.alloc_void_bulk(&l.freelist);
+  }
   if (!cmd_disable_pfreelist && l.freelist) {
     void *v    = l.freelist;
     l.freelist = *static_cast<void **>(l.freelist);
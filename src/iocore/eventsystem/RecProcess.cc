@@ -91,7 +91,9 @@ struct raw_stat_sync_cont : public Continuation {
     RecExecRawStatSyncCbs();
     Dbg(dbg_ctl_statsproc, "raw_stat_sync_cont() processed");
 
-    // This needs to be called periodically even after the old metrics sync is removed
+    // This needs to be called periodically even after the old metrics sync is removed. The sharded
+    // counters are published first, such that derived metrics can be built on top of them.
+    ts::Metrics::ShardedCounter::sync();
     ts::Metrics::Derived::update_derived();
 
     return EVENT_CONT;
@@ -54,6 +54,11 @@ char const *const EThread::Metrics::Slice::STAT_NAME[] = {
 
 int thread_max_heartbeat_mseconds = THREAD_MAX_HEARTBEAT_MSECONDS;
 
+namespace
+{
+DbgCtl dbg_ctl_iocore_thread_steal{"iocore_thread_steal"};
+} // end anonymous namespace
+
 // To define a class inherits from Thread:
 //   1) Define an independent thread_local static member
 //   2) Override Thread::set_specific() and assign that member and call Thread::set_specific()
@@ -182,6 +187,22 @@ EThread::process_event(Event *e, int calling_code)
   }
 }
 
+bool
+EThread::steal_events()
+{
+  auto const &group = eventProcessor.thread_group[steal_group];
+
+  // Start with the next sibling so thieves spread over the busy threads.
+  for (int i = 1; i < group._count; ++i) {
+    EThread *victim = group._thread[(id + i) % group._count];
+    if (int n = EventQueueExternal.steal(victim->EventQueueExternal, this); n > 0) {
+      Dbg(dbg_ctl_iocore_thread_steal, "[%s %d] took %d events from thread %d", group._name.c_str(), id, n, victim->id);
+      return true;
+    }
+  }
+  return false;
+}
+
 void
 EThread::process_queue(Que(Event, link) * NegativeQueue, int *ev_count, int *nq_count)
 {
@@ -216,6 +237,16 @@ EThread::process_queue(Que(Event, link) * NegativeQueue, int *ev_count, int *nq_
     }
     ++(*nq_count);
   }
+
+  // Run the immediate events siblings may steal, those queued meanwhile are left for the next loop.
+  for (int n = EventQueueExternal.stealCount; n > 0 && (e = EventQueueExternal.dequeue_stealable()); --n) {
+    ++(*ev_count);
+    if (e->cancelled) {
+      free_event(e);
+    } else {
+      process_event(e, e->callback_event);
+    }
+  }
 }
 
 void
@@ -300,6 +331,11 @@ EThread::execute_regular()
       sleep_time = 0;
     }
 
+    // An idle thread of a work stealing group takes over events queued on a busy sibling instead of sleeping.
+    if (steal_group != NO_STEAL_GROUP && (EventQueueExternal.stealCount > 0 || steal_events())) {
+      sleep_time = 0;
+    }
+
     // drained the queue by this point
     ink_hrtime post_drain  = ink_get_hrtime();
     ink_hrtime drain_queue = post_drain - loop_start_time;
@@ -79,6 +79,7 @@ private:
   hwloc_obj_type_t obj_type  = HWLOC_OBJ_MACHINE;
   int              obj_count = 0;
   char const      *obj_name  = nullptr;
+  bool             numa      = false; ///< Bind thread memory to the NUMA node of the thread.
 #endif
 };
 
@@ -263,6 +264,14 @@ ThreadAffinityInitializer::init()
 
   obj_count = hwloc_get_nbobjs_by_type(ink_get_topology(), obj_type);
   Dbg(dbg_ctl_iocore_thread, "Affinity: %d %ss: %d PU: %d", affinity, obj_name, obj_count, ink_number_of_processors());
+
+  int numa_mode = 0;
+  REC_ReadConfigInteger(numa_mode, "proxy.config.exec_thread.numa");
+  numa = numa_mode != 0;
+  if (numa && hwloc_get_nbobjs_by_type(ink_get_topology(), HWLOC_OBJ_NODE) <= 1) {
+    Note("proxy.config.exec_thread.numa is set but the system has a single NUMA node");
+    numa = false;
+  }
 }
 
 int
@@ -284,6 +293,23 @@ ThreadAffinityInitializer::set_affinity(int, Event *)
     Dbg(dbg_ctl_iocore_thread, "EThread: %d %s: %d", _name, obj->logical_index);
 #endif // HWLOC_API_VERSION
     hwloc_set_thread_cpubind(ink_get_topology(), t->tid, obj->cpuset, HWLOC_CPUBIND_STRICT);
+
+    if (numa) {
+      // A thread confined to one NUMA node takes all of its memory from that node, which keeps its
+      // free lists, buffers and huge page arenas local.
+      hwloc_nodeset_t nodeset = hwloc_bitmap_alloc();
+      hwloc_cpuset_to_nodeset(ink_get_topology(), obj->cpuset, nodeset);
+      if (hwloc_bitmap_weight(nodeset) == 1) {
+        ink_set_numa_node(hwloc_bitmap_first(nodeset));
+#if HWLOC_API_VERSION >= 0x20000
+        hwloc_set_membind(ink_get_topology(), nodeset, HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_THREAD | HWLOC_MEMBIND_BYNODESET);
+#else
+        hwloc_set_membind_nodeset(ink_get_topology(), nodeset, HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_THREAD);
+#endif
+        Dbg(dbg_ctl_iocore_thread, "EThread: %p bound to NUMA node %d", t, ink_numa_node());
+      }
+      hwloc_bitmap_free(nodeset);
+    }
   } else {
     Warning("hwloc returned an unexpected number of objects -- CPU affinity disabled");
   }
@@ -415,6 +441,41 @@ EventProcessor::schedule_spawn(void (*f)(EThread *), EventType ev_type)
   return e;
 }
 
+// Queue an immediate event of a work stealing group without tying it to a thread. It goes to the
+// current thread if that is in the group, else to the next thread in turn, and if that thread may be
+// busy a sleeping sibling is woken to take over part of its queue.
+Event *
+EventProcessor::schedule_stealable(Event *e, EventType etype, EThread *curr_thread)
+{
+  ThreadGroupDescriptor *tg = &thread_group[etype];
+
+  if (curr_thread != nullptr && curr_thread->is_event_type(etype)) {
+    e->ethread = curr_thread;
+  } else {
+    e->ethread = assign_thread(etype);
+  }
+  if (e->continuation->mutex) {
+    e->mutex = e->continuation->mutex;
+  }
+
+  EThread *owner  = e->ethread;
+  int      queued = owner->EventQueueExternal.enqueue_stealable(e);
+  if (owner != curr_thread) {
+    owner->tail_cb->signalActivity();
+  }
+  if (owner == curr_thread || queued > 1) {
+    for (int i = 1; i < tg->_count; ++i) {
+      EThread *t = tg->_thread[(owner->id + i) % tg->_count];
+      // Succeeds only if the thread is sleeping, a running thread steals before it sleeps.
+      if (t->EventQueueExternal.try_signal()) {
+        break;
+      }
+    }
+  }
+
+  return e;
+}
+
 EventType
 EventProcessor::register_event_type(char const *name)
 {
@@ -460,6 +521,9 @@ EventProcessor::spawn_event_threads(EventType ev_type, int n_threads, size_t sta
     tg->_thread[i]               = t;
     t->id                        = i; // unfortunately needed to support affinity and NUMA logic.
     t->set_event_type(ev_type);
+    if (tg->_work_stealing) {
+      t->steal_group = ev_type;
+    }
     t->schedule_spawn(&thread_initializer);
   }
   tg->_count  = n_threads;
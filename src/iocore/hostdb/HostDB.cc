@@ -70,6 +70,7 @@ int                     hostdb_max_count = DEFAULT_HOST_DB_SIZE;
 static swoc::file::path hostdb_hostfile_path;
 int                     hostdb_disable_reverse_lookup = 0;
 int                     hostdb_max_iobuf_index        = BUFFER_SIZE_INDEX_32K;
+static int              hostdb_sync_frequency         = 0;
 
 ClassAllocator<HostDBContinuation> hostDBContAllocator("hostDBContAllocator");
 
@@ -290,6 +291,110 @@ HostDBBackgroundTask::HostDBBackgroundTask(ts_seconds frequency) : Continuation(
   SET_HANDLER(&HostDBBackgroundTask::sync_event);
 }
 
+int
+HostDBBackgroundTask::wait_event(int, void *)
+{
+  auto next = frequency - std::chrono::duration_cast<ts_milliseconds>(ts_hr_clock::now() - start_time);
+
+  SET_HANDLER(&HostDBBackgroundTask::sync_event);
+  if (next > ts_milliseconds(100)) {
+    eventProcessor.schedule_in(this, HRTIME_MSECONDS(next.count()), ET_TASK);
+  } else {
+    eventProcessor.schedule_imm(this, ET_TASK);
+  }
+  return EVENT_DONE;
+}
+
+/** Persist HostDB incrementally.
+ *
+ * Every @a frequency the records put in or removed from HostDB since the last run are appended to
+ * the HostDB file, and once the file is mostly superseded records it is rewritten from the
+ * current content of HostDB. The partition locks are only held to pick up the changed keys and to
+ * take references to the records for a rewrite, never while writing.
+ */
+struct HostDBSync : public HostDBBackgroundTask {
+  RefCountCacheLog log;
+
+  HostDBSync(ts_seconds frequency, std::string const &path)
+    : HostDBBackgroundTask(frequency), log(path, hostDB.refcountcache->get_header())
+  {
+  }
+
+  int  sync_event(int event, void *edata) override;
+  void append(HostDBRecord *r);
+  void rewrite();
+};
+
+static HostDBSync *hostdb_sync = nullptr;
+
+void
+HostDBSync::append(HostDBRecord *r)
+{
+  auto expiry_time = duration_cast<ts_seconds>(r->expiry_time().time_since_epoch()).count();
+  log.append(r->key, expiry_time, r, r->_record_size);
+}
+
+void
+HostDBSync::rewrite()
+{
+  if (!log.start_rewrite()) {
+    return;
+  }
+
+  std::vector<RefCountCacheHashEntry *> entries;
+  for (size_t i = 0; i < hostDB.refcountcache->partition_count(); ++i) {
+    auto &part = hostDB.refcountcache->get_partition(i);
+    {
+      std::shared_lock<ts::shared_mutex> lock{part.lock};
+      part.copy(entries);
+    }
+    for (auto *e : entries) {
+      this->append(static_cast<HostDBRecord *>(e->item.get()));
+      RefCountCacheHashEntry::free<HostDBRecord>(e);
+    }
+    entries.clear();
+  }
+
+  log.finish_rewrite();
+}
+
+int
+HostDBSync::sync_event(int event, void *edata)
+{
+  start_time = ts_hr_clock::now();
+
+  std::vector<uint64_t> keys;
+  for (size_t i = 0; i < hostDB.refcountcache->partition_count(); ++i) {
+    auto &part = hostDB.refcountcache->get_partition(i);
+
+    std::vector<uint64_t> changes;
+    {
+      std::unique_lock<ts::shared_mutex> lock{part.lock};
+      changes = part.take_changes();
+    }
+    keys.insert(keys.end(), changes.begin(), changes.end());
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+  // Write the current state of each key, which may be newer than the change that listed it.
+  for (auto key : keys) {
+    if (auto r = hostDB.refcountcache->get_partition(hostDB.refcountcache->partition_for_key(key)).peek(key); r) {
+      this->append(r.get());
+    } else {
+      log.append_erase(key);
+    }
+  }
+  log.flush();
+
+  if (log.needs_rewrite()) {
+    this->rewrite();
+  }
+  Dbg(dbg_ctl_hostdb, "synced %zu changed records, file is %jd bytes", keys.size(), static_cast<intmax_t>(log.size()));
+
+  return this->wait_event(event, edata);
+}
+
 int
 HostDBCache::start(int flags)
 {
@@ -320,6 +425,24 @@ HostDBCache::start(int flags)
                                                         "proxy.process.hostdb.cache.");
   this->pending_dns   = new Queue<HostDBContinuation, Continuation::Link_link>[hostdb_partitions];
   this->remoteHostDBQueue = new Queue<HostDBContinuation, Continuation::Link_link>[hostdb_partitions];
+
+  // Warm start from the HostDB file, the records are used in place from a mapping of it.
+  REC_ReadConfigInt32(hostdb_sync_frequency, "proxy.config.hostdb.sync_frequency");
+  if (hostdb_sync_frequency > 0 && hostdb_sync == nullptr) {
+    char filename[PATH_NAME_MAX];
+    REC_ReadConfigString(filename, "proxy.config.hostdb.filename", sizeof(filename));
+    swoc::file::path path = swoc::file::path(RecConfigReadRuntimeDir()) / filename;
+
+    off_t valid_end = LoadRefCountCacheFromLog<HostDBRecord>(*this->refcountcache, path.string(), HostDBRecord::restore);
+    hostdb_sync     = new HostDBSync(ts_seconds(hostdb_sync_frequency), path.string());
+    if (hostdb_sync->log.open(valid_end)) {
+      this->refcountcache->track_changes(true);
+    } else {
+      Warning("HostDB will not be persisted to %s", path.c_str());
+      delete hostdb_sync;
+      hostdb_sync = nullptr;
+    }
+  }
   return 0;
 }
 
@@ -394,6 +517,10 @@ HostDBProcessor::init()
   b->mutex = new_ProxyMutex();
   eventProcessor.schedule_every(b, HRTIME_SECONDS(1), ET_DNS);
 
+  if (hostdb_sync) {
+    eventProcessor.schedule_in(hostdb_sync, HRTIME_SECONDS(hostdb_sync_frequency), ET_TASK);
+  }
+
   return 0;
 }
 
@@ -443,6 +570,7 @@ reply_to_cont(Continuation *cont, HostDBRecord *r, bool is_srv = false)
       ink_assert(!"missing hostname");
       cont->handleEvent(is_srv ? EVENT_SRV_LOOKUP : EVENT_HOST_DB_LOOKUP, nullptr);
       Warning("bogus entry deleted from HostDB: missing hostname");
+      std::unique_lock<ts::shared_mutex> lock{hostDB.refcountcache->lock_for_key(r->key)};
       hostDB.refcountcache->erase(r->key);
       return false;
     }
@@ -533,14 +661,11 @@ probe(HostDBHash const &hash, bool ignore_timeout)
   }
 
   // Otherwise HostDB is enabled, so we'll do our thing
-  uint64_t          folded_hash = hash.hash.fold();
-  ts::shared_mutex &bucket_lock = hostDB.refcountcache->lock_for_key(folded_hash);
+  uint64_t folded_hash = hash.hash.fold();
 
   Ptr<HostDBRecord> record;
   {
-    std::shared_lock<ts::shared_mutex> lock{bucket_lock};
-
-    // get the record from cache
+    // get the record from cache, lookups don't need the partition lock
     record = hostDB.refcountcache->get(folded_hash);
     // If there was nothing in the cache-- this is a miss
     if (record.get() == nullptr) {
@@ -631,12 +756,8 @@ HostDBProcessor::getby(Continuation *cont, cb_process_result_pfn cb_process_resu
     bool loop = lock.is_locked();
     while (loop) {
       loop = false; // Only loop on explicit set for retry.
-      // find the partition lock
-      ts::shared_mutex &bucket_lock = hostDB.refcountcache->lock_for_key(hash.hash.fold());
-
-      // If we can get the lock and a level 1 probe succeeds, return
-      HostDBRecord::Handle               r = probe(hash, false);
-      std::shared_lock<ts::shared_mutex> lock{bucket_lock};
+      // If a level 1 probe succeeds, return
+      HostDBRecord::Handle r = probe(hash, false);
       if (r) {
         // fail, see if we should retry with alternate
         if (hash.db_mark != HOSTDB_MARK_SRV && r->is_failed() && hash.host_name) {
@@ -967,6 +1088,7 @@ HostDBContinuation::dnsEvent(int event, HostEnt *e)
     Ptr<HostDBRecord> old_r = probe(hash, false);
     // If the DNS lookup failed with NXDOMAIN, remove the old record
     if (e && e->isNameError() && old_r) {
+      std::unique_lock<ts::shared_mutex> lock{hostDB.refcountcache->lock_for_key(old_r->key)};
       hostDB.refcountcache->erase(old_r->key);
       old_r = nullptr;
       Dbg(dbg_ctl_hostdb, "Removing the old record when the DNS lookup failed with NXDOMAIN");
@@ -1752,6 +1874,28 @@ HostDBRecord::unmarshall(char *buff, unsigned size)
   return self;
 }
 
+HostDBRecord::self_type *
+HostDBRecord::restore(char *buff, unsigned size)
+{
+  if (size < sizeof(self_type)) {
+    return nullptr;
+  }
+  auto src = reinterpret_cast<self_type *>(buff);
+  if (src->_record_size != size || src->rr_offset < sizeof(self_type) ||
+      src->rr_offset + src->rr_count * sizeof(HostDBInfo) > size) {
+    return nullptr;
+  }
+
+  // Construct over the data, keeping all of it but the VFTP and ref count.
+  auto delta = sizeof(RefCountObj);
+  char data[sizeof(self_type)];
+  memcpy(data, buff + delta, sizeof(self_type) - delta);
+  auto self = new (buff) self_type();
+  memcpy(reinterpret_cast<std::byte *>(self) + delta, data, sizeof(self_type) - delta);
+  self->_iobuffer_index = -1; // Not ours to free.
+  return self;
+}
+
 bool
 HostDBRecord::serve_stale_but_revalidate() const
 {
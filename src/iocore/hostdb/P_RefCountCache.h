@@ -34,7 +34,15 @@
 #include "tsutil/Metrics.h"
 
 #include "swoc/IntrusiveHashMap.h"
+#include <atomic>
 #include <cstdint>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 using ts::Metrics;
@@ -44,8 +52,8 @@ using ts::Metrics;
 #define REFCOUNTCACHE_MAGIC_NUMBER 0x0BAD2D9
 
 static constexpr unsigned char     REFCOUNTCACHE_MAJOR_VERSION = 1;
-static constexpr unsigned char     REFCOUNTCACHE_MINOR_VERSION = 0;
-static constexpr ts::VersionNumber REFCOUNTCACHE_VERSION(1, 0);
+static constexpr unsigned char     REFCOUNTCACHE_MINOR_VERSION = 1;
+static constexpr ts::VersionNumber REFCOUNTCACHE_VERSION(1, 1);
 
 // Stats
 struct RefCountCacheBlock {
@@ -148,6 +156,108 @@ struct RefCountCacheLinkage {
   }
 };
 
+/** Epoch based reclamation for the lock free read path of @c RefCountCachePartition.
+
+    A reader marks its thread with the current epoch for the duration of a @c ReadGuard. A writer
+    that unlinks an object tags it with the epoch in which it was unlinked (@c advance) and may
+    free it once no reader is left in that or an earlier epoch (@c oldest_reader).
+ */
+class RefCountCacheEpoch
+{
+public:
+  struct Slot;
+
+  class ReadGuard
+  {
+  public:
+    ReadGuard();
+    ~ReadGuard();
+
+    ReadGuard(const ReadGuard &)            = delete;
+    ReadGuard &operator=(const ReadGuard &) = delete;
+
+  private:
+    Slot *_slot;
+  };
+
+  /// Start a new epoch, returns the epoch objects unlinked before the call belong to.
+  static uint64_t advance();
+  /// Oldest epoch a reader may still be in, objects retired in an earlier epoch can be freed.
+  static uint64_t oldest_reader();
+};
+
+/** Hash table of key -> entry for lookups without a lock.
+
+    Each bucket is an immutable array of key and entry pairs that is replaced as a whole when the
+    bucket changes, and the table doubles when it holds more entries than buckets. Replaced arrays,
+    tables and unlinked entries are retired and freed once no reader can see them any more.
+
+    Lookups must be made inside a @c RefCountCacheEpoch::ReadGuard. Changes must be serialized by the caller.
+ */
+class RefCountCacheReadTable
+{
+public:
+  using free_func = void (*)(void *);
+
+  RefCountCacheReadTable();
+  ~RefCountCacheReadTable();
+
+  RefCountCacheHashEntry *find(uint64_t key) const;
+  /// Publish @a e ahead of any other entry with the same key.
+  void insert(RefCountCacheHashEntry *e);
+  void remove(RefCountCacheHashEntry *e);
+
+  /// Free @a ptr with @a fn once no reader can see it.
+  void retire(void *ptr, free_func fn);
+  /// Free what was retired and is no longer visible to readers.
+  void reclaim();
+
+private:
+  struct Slot {
+    uint64_t                key;
+    RefCountCacheHashEntry *entry; ///< @c nullptr terminates a bucket.
+  };
+  struct Table {
+    unsigned                   bits;
+    std::atomic<const Slot *> *buckets;
+  };
+  struct Retired {
+    uint64_t  epoch;
+    void     *ptr;
+    free_func fn;
+  };
+
+  static constexpr unsigned MIN_BITS = 6;
+
+  static size_t
+  bucket_of(uint64_t key, unsigned bits)
+  {
+    // Keys are already hashes, but the partition is picked from their low bits.
+    return (key * 0x9E3779B97F4A7C15ULL) >> (64 - bits);
+  }
+
+  static Table *new_table(unsigned bits);
+  static void   free_table(void *t);
+  Table        *grow(Table *t);
+
+  std::atomic<Table *> _table;
+  size_t               _count = 0;
+  std::deque<Retired>  _retired;
+};
+
+inline RefCountCacheHashEntry *
+RefCountCacheReadTable::find(uint64_t key) const
+{
+  const Table *t = _table.load(std::memory_order_acquire);
+
+  for (const Slot *s = t->buckets[bucket_of(key, t->bits)].load(std::memory_order_acquire); s && s->entry; ++s) {
+    if (s->key == key) {
+      return s->entry;
+    }
+  }
+  return nullptr;
+}
+
 class RefCountCacheBase
 {
 protected:
@@ -156,17 +266,27 @@ protected:
 
 // The RefCountCachePartition is simply a map of key -> Ptr<YourClass>
 // We partition the cache to reduce lock contention
+//
+// `get` does not need `lock`, it reads a copy of the map published through a RefCountCacheReadTable.
+// Everything that changes the partition (put, erase, clear) must hold `lock` exclusively, as must
+// anyone walking the map from `get_map` or `copy` hold it shared.
 template <class C> class RefCountCachePartition : private RefCountCacheBase
 {
 public:
   using hash_type = swoc::IntrusiveHashMap<RefCountCacheLinkage>;
 
   RefCountCachePartition(unsigned int part_num, uint64_t max_size, unsigned int max_items, RefCountCacheBlock *rsb = nullptr);
+  ~RefCountCachePartition();
   Ptr<C> get(uint64_t key);
+  Ptr<C> peek(uint64_t key);
   void   put(uint64_t key, C *item, int size = 0, time_t expire_time = 0);
   void   erase(uint64_t key, ink_time_t expiry_time = -1);
 
   void clear();
+
+  // Keys put or removed since the last call, if changes are tracked. Caller must hold `lock`.
+  std::vector<uint64_t> take_changes();
+  void                  track_changes(bool track);
   bool is_full() const;
   bool make_space_for(unsigned int);
   void dealloc_entry(hash_type::iterator ptr);
@@ -185,10 +305,16 @@ private:
   uint64_t     size;
   unsigned int items;
 
-  hash_type item_map;
+  hash_type              item_map;
+  RefCountCacheReadTable read_table;
+
+  bool                  tracking_changes = false;
+  std::vector<uint64_t> changes;
 
   PriorityQueue<RefCountCacheHashEntry *> expiry_queue;
   RefCountCacheBlock                     *rsb;
+
+  static void free_entry(void *e);
 };
 
 template <class C>
@@ -198,26 +324,53 @@ RefCountCachePartition<C>::RefCountCachePartition(unsigned int part_num, uint64_
 {
 }
 
+template <class C> RefCountCachePartition<C>::~RefCountCachePartition()
+{
+  this->clear();
+}
+
 template <class C>
 Ptr<C>
 RefCountCachePartition<C>::get(uint64_t key)
 {
   Metrics::Counter::increment(this->rsb->refcountcache_total_lookups);
-  if (auto it = this->item_map.find(key); it != this->item_map.end()) {
+  // The entry, and so its ref to the item, can't be freed while the guard is held.
+  RefCountCacheEpoch::ReadGuard guard;
+  if (RefCountCacheHashEntry *e = this->read_table.find(key); e != nullptr) {
     // found
     Metrics::Counter::increment(this->rsb->refcountcache_total_hits);
-    return make_ptr(static_cast<C *>(it->item.get()));
+    return make_ptr(static_cast<C *>(e->item.get()));
   } else {
     return Ptr<C>();
   }
 }
 
+// Same as get, but not counted in the lookup metrics.
+template <class C>
+Ptr<C>
+RefCountCachePartition<C>::peek(uint64_t key)
+{
+  RefCountCacheEpoch::ReadGuard guard;
+  if (RefCountCacheHashEntry *e = this->read_table.find(key); e != nullptr) {
+    return make_ptr(static_cast<C *>(e->item.get()));
+  }
+  return Ptr<C>();
+}
+
 template <class C>
 void
 RefCountCachePartition<C>::put(uint64_t key, C *item, int size, time_t expire_time)
 {
   Metrics::Counter::increment(this->rsb->refcountcache_total_inserts);
   size += sizeof(C);
+
+  // Create our value-- which has a ref to the `item`
+  RefCountCacheHashEntry *val = RefCountCacheHashEntry::alloc();
+  val->set(item, key, size, expire_time);
+
+  // Publish it ahead of the entry it replaces, so readers don't miss the key in between
+  this->read_table.insert(val);
+
   // Remove any colliding entries
   this->erase(key);
 
@@ -225,13 +378,12 @@ RefCountCachePartition<C>::put(uint64_t key, C *item, int size, time_t expire_ti
   if (this->is_full() && !this->make_space_for(size)) {
     Dbg(dbg_ctl, "partition %d is full-- not storing item key=%" PRIu64, this->part_num, key);
     Metrics::Counter::increment(this->rsb->refcountcache_total_failed_inserts);
+    this->read_table.remove(val);
+    this->read_table.retire(val, &RefCountCachePartition<C>::free_entry);
+    this->read_table.reclaim();
     return;
   }
 
-  // Create our value-- which has a ref to the `item`
-  RefCountCacheHashEntry *val = RefCountCacheHashEntry::alloc();
-  val->set(item, key, size, expire_time);
-
   // add expiry_entry to expiry queue, if the expire time is positive (otherwise it means don't expire)
   if (expire_time >= 0) {
     Dbg(dbg_ctl, "partition %d adding entry with expire_time=%" PRIdMAX, this->part_num, expire_time);
@@ -245,6 +397,9 @@ RefCountCachePartition<C>::put(uint64_t key, C *item, int size, time_t expire_ti
   this->item_map.insert(val);
   this->size += val->meta.size;
   this->items++;
+  if (this->tracking_changes) {
+    this->changes.push_back(key);
+  }
   Metrics::Gauge::increment(this->rsb->refcountcache_current_size, static_cast<int64_t>(val->meta.size));
   Metrics::Gauge::increment(this->rsb->refcountcache_current_items);
 }
@@ -260,6 +415,7 @@ RefCountCachePartition<C>::erase(uint64_t key, ink_time_t expiry_time)
     this->item_map.erase(it);
     this->dealloc_entry(it);
   }
+  this->read_table.reclaim();
 }
 
 template <class C>
@@ -270,6 +426,9 @@ RefCountCachePartition<C>::dealloc_entry(hash_type::iterator ptr)
   // counters
   this->size -= ptr->meta.size;
   this->items--;
+  if (this->tracking_changes) {
+    this->changes.push_back(ptr->meta.key);
+  }
 
   Metrics::Gauge::decrement(this->rsb->refcountcache_current_size, ptr->meta.size);
   Metrics::Gauge::decrement(this->rsb->refcountcache_current_items);
@@ -283,7 +442,16 @@ RefCountCachePartition<C>::dealloc_entry(hash_type::iterator ptr)
     ptr->expiry_entry = nullptr; // To avoid the destruction of `l` calling the destructor again-- and causing issues
   }
 
-  RefCountCacheHashEntry::free<C>(ptr);
+  // readers may still be looking at it, it is freed once they are done
+  this->read_table.remove(ptr);
+  this->read_table.retire(ptr, &RefCountCachePartition<C>::free_entry);
+}
+
+template <class C>
+void
+RefCountCachePartition<C>::free_entry(void *e)
+{
+  RefCountCacheHashEntry::free<C>(static_cast<RefCountCacheHashEntry *>(e));
 }
 
 template <class C>
@@ -300,6 +468,7 @@ RefCountCachePartition<C>::clear()
     this->item_map.erase(cur);
     this->dealloc_entry(cur);
   }
+  this->read_table.reclaim();
 }
 
 // Are we full?
@@ -335,6 +504,23 @@ RefCountCachePartition<C>::make_space_for(unsigned int size)
   return true;
 }
 
+template <class C>
+std::vector<uint64_t>
+RefCountCachePartition<C>::take_changes()
+{
+  return std::exchange(this->changes, {});
+}
+
+template <class C>
+void
+RefCountCachePartition<C>::track_changes(bool track)
+{
+  this->tracking_changes = track;
+  if (!track) {
+    this->changes.clear();
+  }
+}
+
 template <class C>
 size_t
 RefCountCachePartition<C>::count() const
@@ -377,7 +563,8 @@ public:
 // Once an item is `put` into the cache, the cache will maintain a Ptr<> to that object until erase
 // or clear is called-- which will remove the cache's Ptr<> to the object.
 //
-// This cache may be Persisted (RefCountCacheSync) as well as loaded from disk (LoadRefCountCacheFromPath).
+// This cache may be persisted incrementally (track_changes and RefCountCacheLog) and loaded from disk
+// (LoadRefCountCacheFromLog, or LoadRefCountCacheFromPath for a plain dump).
 // This class will optionally emit metrics at the given `metrics_prefix`.
 //
 // Note: although this cache does allow you to set expiry times this cache does not actively GC itself-- meaning
@@ -387,6 +574,9 @@ public:
 // Also note, that if keys collide the previous
 // entry for a given key will be removed, so this "leak" concern is assuming you don't have sufficient space to store
 // an item for each possible key
+//
+// `get` takes no lock. `put`, `erase` and `clear` must be called with `lock_for_key` of the key (or of every
+// partition for `clear`) held exclusively, unless the cache is not yet shared between threads.
 template <class C> class RefCountCache
 {
 public:
@@ -402,6 +592,9 @@ public:
   void   erase(uint64_t key);
   void   clear();
 
+  // Record the keys changed in each partition, for incremental persistence
+  void track_changes(bool track);
+
   // Some methods to get some internal state
   int                        partition_for_key(uint64_t key);
   ts::shared_mutex          &lock_for_key(uint64_t key);
@@ -540,6 +733,15 @@ RefCountCache<C>::clear()
   }
 }
 
+template <class C>
+void
+RefCountCache<C>::track_changes(bool track)
+{
+  for (unsigned int i = 0; i < this->num_partitions; i++) {
+    this->partitions[i]->track_changes(track);
+  }
+}
+
 // Fill `cache` with items in file `filepath` using `load_func` to unmarshall the record.
 // Errors are -1
 template <typename CacheEntryType>
@@ -594,3 +796,127 @@ LoadRefCountCacheFromPath(RefCountCache<CacheEntryType> &cache, const std::strin
   UnixSocket{fd}.close();
   return 0;
 }
+
+// Records in a RefCountCacheLog are aligned so items can be used in place from a mapping of the file.
+static constexpr size_t REFCOUNTCACHE_LOG_ALIGN = 8;
+
+constexpr size_t
+refcountcache_log_align(size_t n)
+{
+  return (n + REFCOUNTCACHE_LOG_ALIGN - 1) & ~(REFCOUNTCACHE_LOG_ALIGN - 1);
+}
+
+/** Append only file of changes to a RefCountCache.
+
+    The file starts with a RefCountCacheHeader, followed by a RefCountCacheItemMeta and the item
+    data for every item put in the cache, or just the meta with a size of 0 for an item removed.
+    Later records for a key replace earlier ones. As the file grows with superseded records it is
+    rewritten from the current content of the cache, into a new file that replaces it once complete.
+ */
+class RefCountCacheLog : private RefCountCacheBase
+{
+public:
+  RefCountCacheLog(std::string path, RefCountCacheHeader const &header);
+  ~RefCountCacheLog();
+
+  /// Open the file for appending, dropping anything past @a valid_end. A new file is started if @a valid_end is 0.
+  bool open(off_t valid_end);
+
+  void append(uint64_t key, ink_time_t expiry_time, const void *data, unsigned size);
+  void append_erase(uint64_t key);
+  /// Write out the appended records.
+  bool flush();
+
+  /// Whether enough of the file is superseded for a rewrite to be worth it.
+  bool needs_rewrite() const;
+  /// Send appends to a new file, the current one is kept until @c finish_rewrite.
+  bool start_rewrite();
+  /// Replace the file with the new one, or go back to the current file if that fails.
+  bool finish_rewrite();
+
+  off_t size() const;
+
+private:
+  static constexpr size_t FLUSH_SIZE = 1 << 20;
+  // Don't bother rewriting files smaller than this.
+  static constexpr off_t MIN_REWRITE_SIZE = 1 << 20;
+
+  int  create(const std::string &path);
+  void close_fd(int fd);
+
+  std::string         _path;
+  RefCountCacheHeader _header;
+  int                 _fd         = -1;
+  int                 _prev_fd    = -1; ///< File being replaced by a rewrite in progress.
+  off_t               _size       = 0;
+  off_t               _prev_size  = 0;
+  off_t               _base_size  = 0; ///< Size of the file when it was last rewritten.
+  std::vector<char>   _buffer;
+};
+
+// Fill `cache` with the items in a RefCountCacheLog at `filepath`. The file is mapped privately and the
+// items are set up in place by `attach_func` rather than read and copied, so the mapping is kept for the
+// life of the process. Records that have already expired are dropped.
+// Returns the length of the file up to the end of the last complete record, 0 if nothing could be used.
+template <typename CacheEntryType>
+off_t
+LoadRefCountCacheFromLog(RefCountCache<CacheEntryType> &cache, const std::string &filepath,
+                         CacheEntryType *(*attach_func)(char *, unsigned))
+{
+  int fd = open(filepath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    if (errno != ENOENT) {
+      Warning("Unable to open file %s; [Error]: %s", filepath.c_str(), strerror(errno));
+    }
+    return 0;
+  }
+
+  struct stat st;
+  off_t       header_size = refcountcache_log_align(sizeof(RefCountCacheHeader));
+  if (fstat(fd, &st) != 0 || st.st_size < header_size) {
+    UnixSocket{fd}.close();
+    return 0;
+  }
+
+  void *map = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  UnixSocket{fd}.close();
+  if (map == MAP_FAILED) {
+    Warning("Unable to map file %s; [Error]: %s", filepath.c_str(), strerror(errno));
+    return 0;
+  }
+
+  char                *base = static_cast<char *>(map);
+  RefCountCacheHeader *hdr  = reinterpret_cast<RefCountCacheHeader *>(base);
+  if (!cache.get_header().compatible(hdr)) {
+    munmap(map, st.st_size);
+    Warning("Incompatible cache at %s, not loading.", filepath.c_str());
+    return 0;
+  }
+
+  ink_time_t now   = ink_time();
+  off_t      pos   = header_size;
+  size_t     items = 0;
+  while (pos + static_cast<off_t>(sizeof(RefCountCacheItemMeta)) <= st.st_size) {
+    RefCountCacheItemMeta meta(0, 0);
+    memcpy(static_cast<void *>(&meta), base + pos, sizeof(meta));
+    off_t next = pos + refcountcache_log_align(sizeof(meta) + meta.size);
+    if (next > st.st_size) {
+      break;
+    }
+
+    if (meta.size == 0 || (meta.expiry_time >= 0 && meta.expiry_time < now)) {
+      cache.erase(meta.key);
+    } else if (CacheEntryType *item = attach_func(base + pos + sizeof(meta), meta.size); item != nullptr) {
+      cache.put(meta.key, item, meta.size, meta.expiry_time);
+      ++items;
+    } else {
+      Warning("Bad record at offset %jd in %s, not loading the rest.", static_cast<intmax_t>(pos), filepath.c_str());
+      break;
+    }
+    pos = next;
+  }
+
+  Note("loaded %zu records from %s (%jd bytes)", items, filepath.c_str(), static_cast<intmax_t>(pos));
+  return pos;
+}
+
@@ -21,6 +21,10 @@
 
 #include "P_RefCountCache.h"
 
+#include <cerrno>
+#include <cstdio>
+#include <vector>
+
 // Since the hashing values are all fixed size, we can simply use a classAllocator to avoid mallocs
 static ClassAllocator<RefCountCacheHashEntry> refCountCacheHashingValueAllocator("refCountCacheHashingValueAllocator");
 
@@ -49,5 +53,411 @@ RefCountCacheHeader::operator==(RefCountCacheHeader const &that) const
 bool
 RefCountCacheHeader::compatible(RefCountCacheHeader *that) const
 {
-  return this->magic == that->magic && this->version == that->version && this->object_version == that->version;
+  return this->magic == that->magic && this->version == that->version && this->object_version == that->object_version;
+};
+
+// One per thread that has done a lookup, never freed but reused once the thread exits.
+struct alignas(64) RefCountCacheEpoch::Slot {
+  std::atomic<uint64_t> epoch{0}; ///< Epoch the thread is reading in, 0 if it isn't.
+  std::atomic<bool>     in_use{true};
+  Slot                 *next  = nullptr;
+  int                   depth = 0; ///< Only touched by the owning thread.
 };
+
+namespace
+{
+std::atomic<uint64_t>                   global_epoch{1};
+std::atomic<RefCountCacheEpoch::Slot *> epoch_slots{nullptr};
+
+RefCountCacheEpoch::Slot *
+acquire_slot()
+{
+  for (auto *s = epoch_slots.load(std::memory_order_acquire); s; s = s->next) {
+    bool expected = false;
+    if (!s->in_use.load(std::memory_order_relaxed) && s->in_use.compare_exchange_strong(expected, true)) {
+      return s;
+    }
+  }
+
+  auto *s = new RefCountCacheEpoch::Slot;
+  s->next = epoch_slots.load(std::memory_order_relaxed);
+  while (!epoch_slots.compare_exchange_weak(s->next, s, std::memory_order_release, std::memory_order_relaxed)) {}
+  return s;
+}
+
+struct SlotOwner {
+  RefCountCacheEpoch::Slot *slot = nullptr;
+
+  ~SlotOwner()
+  {
+    if (slot) {
+      slot->in_use.store(false, std::memory_order_release);
+    }
+  }
+};
+
+thread_local SlotOwner slot_owner;
+
+} // end anonymous namespace
+
+RefCountCacheEpoch::ReadGuard::ReadGuard()
+{
+  if (slot_owner.slot == nullptr) {
+    slot_owner.slot = acquire_slot();
+  }
+  _slot = slot_owner.slot;
+
+  if (_slot->depth++ == 0) {
+    _slot->epoch.store(global_epoch.load(std::memory_order_acquire), std::memory_order_release);
+    // The epoch must be visible before anything is read from the table, pairs with oldest_reader().
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+RefCountCacheEpoch::ReadGuard::~ReadGuard()
+{
+  if (--_slot->depth == 0) {
+    _slot->epoch.store(0, std::memory_order_release);
+  }
+}
+
+uint64_t
+RefCountCacheEpoch::advance()
+{
+  return global_epoch.fetch_add(1);
+}
+
+uint64_t
+RefCountCacheEpoch::oldest_reader()
+{
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+
+  uint64_t oldest = global_epoch.load(std::memory_order_acquire);
+  for (auto *s = epoch_slots.load(std::memory_order_acquire); s; s = s->next) {
+    if (uint64_t e = s->epoch.load(std::memory_order_acquire); e != 0 && e < oldest) {
+      oldest = e;
+    }
+  }
+  return oldest;
+}
+
+RefCountCacheReadTable::RefCountCacheReadTable() : _table(new_table(MIN_BITS)) {}
+
+RefCountCacheReadTable::~RefCountCacheReadTable()
+{
+  // There can't be any readers left.
+  for (auto &r : _retired) {
+    r.fn(r.ptr);
+  }
+  free_table(_table.load(std::memory_order_relaxed));
+}
+
+RefCountCacheReadTable::Table *
+RefCountCacheReadTable::new_table(unsigned bits)
+{
+  Table *t   = new Table;
+  t->bits    = bits;
+  t->buckets = new std::atomic<const Slot *>[size_t{1} << bits];
+  for (size_t i = 0; i < (size_t{1} << bits); ++i) {
+    t->buckets[i].store(nullptr, std::memory_order_relaxed);
+  }
+  return t;
+}
+
+void
+RefCountCacheReadTable::free_table(void *ptr)
+{
+  Table *t = static_cast<Table *>(ptr);
+
+  for (size_t i = 0; i < (size_t{1} << t->bits); ++i) {
+    ats_free(const_cast<Slot *>(t->buckets[i].load(std::memory_order_relaxed)));
+  }
+  delete[] t->buckets;
+  delete t;
+}
+
+RefCountCacheReadTable::Table *
+RefCountCacheReadTable::grow(Table *t)
+{
+  Table                          *nt = new_table(t->bits + 1);
+  std::vector<std::vector<Slot>> buckets(size_t{1} << nt->bits);
+
+  // Keep the order of entries within a bucket, a replacement must stay ahead of the entry it replaces.
+  for (size_t i = 0; i < (size_t{1} << t->bits); ++i) {
+    for (const Slot *s = t->buckets[i].load(std::memory_order_relaxed); s && s->entry; ++s) {
+      buckets[bucket_of(s->key, nt->bits)].push_back(*s);
+    }
+  }
+  for (size_t i = 0; i < buckets.size(); ++i) {
+    if (!buckets[i].empty()) {
+      buckets[i].push_back(Slot{0, nullptr});
+      Slot *slots = static_cast<Slot *>(ats_malloc(buckets[i].size() * sizeof(Slot)));
+      memcpy(slots, buckets[i].data(), buckets[i].size() * sizeof(Slot));
+      nt->buckets[i].store(slots, std::memory_order_relaxed);
+    }
+  }
+
+  _table.store(nt, std::memory_order_release);
+  this->retire(t, &RefCountCacheReadTable::free_table);
+  return nt;
+}
+
+void
+RefCountCacheReadTable::insert(RefCountCacheHashEntry *e)
+{
+  Table *t = _table.load(std::memory_order_relaxed);
+
+  if (++_count > (size_t{1} << t->bits)) {
+    t = this->grow(t);
+  }
+
+  auto       &bucket = t->buckets[bucket_of(e->meta.key, t->bits)];
+  const Slot *old    = bucket.load(std::memory_order_relaxed);
+  size_t      n      = 0;
+  while (old && old[n].entry) {
+    ++n;
+  }
+
+  Slot *slots = static_cast<Slot *>(ats_malloc((n + 2) * sizeof(Slot)));
+  slots[0]    = Slot{e->meta.key, e};
+  if (n > 0) {
+    memcpy(slots + 1, old, n * sizeof(Slot));
+  }
+  slots[n + 1] = Slot{0, nullptr};
+
+  bucket.store(slots, std::memory_order_release);
+  if (old) {
+    this->retire(const_cast<Slot *>(old), &ats_free);
+  }
+}
+
+void
+RefCountCacheReadTable::remove(RefCountCacheHashEntry *e)
+{
+  Table      *t      = _table.load(std::memory_order_relaxed);
+  auto       &bucket = t->buckets[bucket_of(e->meta.key, t->bits)];
+  const Slot *old    = bucket.load(std::memory_order_relaxed);
+  size_t      n      = 0;
+  bool        found  = false;
+  while (old && old[n].entry) {
+    found = found || old[n].entry == e;
+    ++n;
+  }
+  if (!found) {
+    return;
+  }
+
+  Slot *slots = nullptr;
+  if (n > 1) {
+    slots = static_cast<Slot *>(ats_malloc(n * sizeof(Slot)));
+    for (size_t i = 0, j = 0; i <= n; ++i) {
+      if (old[i].entry != e) {
+        slots[j++] = old[i];
+      }
+    }
+  }
+
+  bucket.store(slots, std::memory_order_release);
+  this->retire(const_cast<Slot *>(old), &ats_free);
+  --_count;
+}
+
+void
+RefCountCacheReadTable::retire(void *ptr, free_func fn)
+{
+  _retired.push_back(Retired{RefCountCacheEpoch::advance(), ptr, fn});
+}
+
+void
+RefCountCacheReadTable::reclaim()
+{
+  if (_retired.empty()) {
+    return;
+  }
+
+  uint64_t oldest = RefCountCacheEpoch::oldest_reader();
+  while (!_retired.empty() && _retired.front().epoch < oldest) {
+    Retired r = _retired.front();
+    _retired.pop_front();
+    r.fn(r.ptr);
+  }
+}
+
+RefCountCacheLog::RefCountCacheLog(std::string path, RefCountCacheHeader const &header) : _path(std::move(path)), _header(header)
+{
+  _buffer.reserve(FLUSH_SIZE);
+}
+
+RefCountCacheLog::~RefCountCacheLog()
+{
+  this->flush();
+  this->close_fd(_prev_fd);
+  this->close_fd(_fd);
+}
+
+void
+RefCountCacheLog::close_fd(int fd)
+{
+  if (fd >= 0) {
+    ::close(fd);
+  }
+}
+
+// Create a file at @a path with just the header.
+int
+RefCountCacheLog::create(const std::string &path)
+{
+  int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0640);
+  if (fd < 0) {
+    Warning("Unable to create file %s; [Error]: %s", path.c_str(), strerror(errno));
+    return -1;
+  }
+
+  char header[refcountcache_log_align(sizeof(RefCountCacheHeader))] = {};
+  memcpy(header, &_header, sizeof(_header));
+  if (::write(fd, header, sizeof(header)) != static_cast<ssize_t>(sizeof(header))) {
+    Warning("Unable to write header to %s; [Error]: %s", path.c_str(), strerror(errno));
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+bool
+RefCountCacheLog::open(off_t valid_end)
+{
+  if (valid_end > 0) {
+    _fd = ::open(_path.c_str(), O_WRONLY | O_CLOEXEC);
+    // Drop a partly written last record, appends have to start on a record boundary.
+    if (_fd >= 0 && ftruncate(_fd, valid_end) == 0 && lseek(_fd, valid_end, SEEK_SET) == valid_end) {
+      _size = _base_size = valid_end;
+      return true;
+    }
+    Warning("Unable to reopen %s, starting a new file; [Error]: %s", _path.c_str(), strerror(errno));
+    this->close_fd(_fd);
+  }
+
+  // Replace rather than truncate, the old file may still be mapped.
+  std::string tmp = _path + ".tmp";
+  _fd             = this->create(tmp);
+  if (_fd < 0) {
+    return false;
+  }
+  if (rename(tmp.c_str(), _path.c_str()) != 0) {
+    Warning("Unable to rename %s to %s; [Error]: %s", tmp.c_str(), _path.c_str(), strerror(errno));
+    this->close_fd(_fd);
+    _fd = -1;
+    return false;
+  }
+  _size = _base_size = refcountcache_log_align(sizeof(RefCountCacheHeader));
+  return true;
+}
+
+void
+RefCountCacheLog::append(uint64_t key, ink_time_t expiry_time, const void *data, unsigned size)
+{
+  RefCountCacheItemMeta meta(key, size, expiry_time);
+  size_t                start = _buffer.size();
+
+  _buffer.resize(start + refcountcache_log_align(sizeof(meta) + size));
+  memcpy(_buffer.data() + start, &meta, sizeof(meta));
+  if (size > 0) {
+    memcpy(_buffer.data() + start + sizeof(meta), data, size);
+  }
+  if (_buffer.size() >= FLUSH_SIZE) {
+    this->flush();
+  }
+}
+
+void
+RefCountCacheLog::append_erase(uint64_t key)
+{
+  this->append(key, -1, nullptr, 0);
+}
+
+bool
+RefCountCacheLog::flush()
+{
+  if (_buffer.empty()) {
+    return true;
+  }
+  if (_fd < 0) {
+    _buffer.clear();
+    return false;
+  }
+
+  const char *data = _buffer.data();
+  size_t      left = _buffer.size();
+  while (left > 0) {
+    ssize_t n = ::write(_fd, data, left);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      Warning("Unable to write to %s; [Error]: %s", _path.c_str(), strerror(errno));
+      // Don't leave a partial record behind for the next append to follow.
+      if (ftruncate(_fd, _size) != 0 || lseek(_fd, _size, SEEK_SET) != _size) {
+        this->close_fd(_fd);
+        _fd = -1;
+      }
+      _buffer.clear();
+      return false;
+    }
+    data  += n;
+    left  -= n;
+    _size += n;
+  }
+  _buffer.clear();
+  return true;
+}
+
+bool
+RefCountCacheLog::needs_rewrite() const
+{
+  return _fd < 0 || (_size > MIN_REWRITE_SIZE && _size > 2 * _base_size);
+}
+
+bool
+RefCountCacheLog::start_rewrite()
+{
+  this->flush();
+
+  int fd = this->create(_path + ".tmp");
+  if (fd < 0) {
+    return false;
+  }
+  _prev_fd   = _fd;
+  _prev_size = _size;
+  _fd        = fd;
+  _size      = refcountcache_log_align(sizeof(RefCountCacheHeader));
+  return true;
+}
+
+bool
+RefCountCacheLog::finish_rewrite()
+{
+  std::string tmp = _path + ".tmp";
+
+  if (this->flush() && fsync(_fd) == 0 && rename(tmp.c_str(), _path.c_str()) == 0) {
+    Dbg(dbg_ctl, "rewrote %s, %jd bytes down to %jd", _path.c_str(), static_cast<intmax_t>(_prev_size),
+        static_cast<intmax_t>(_size));
+    this->close_fd(_prev_fd);
+    _prev_fd   = -1;
+    _base_size = _size;
+    return true;
+  }
+
+  Warning("Unable to replace %s with %s; [Error]: %s", _path.c_str(), tmp.c_str(), strerror(errno));
+  this->close_fd(_fd);
+  unlink(tmp.c_str());
+  _fd      = _prev_fd;
+  _size    = _prev_size;
+  _prev_fd = -1;
+  return false;
+}
+
+off_t
+RefCountCacheLog::size() const
+{
+  return _size;
+}
@@ -101,7 +101,7 @@ temp_prefix()
 }
 
 void
-init_ts(std::string_view name, int debug_on = 0)
+init_ts(std::string_view name, int debug_on, int threads)
 {
   DiagsPtr::set(new Diags(name, "", "", new BaseLogFile("stderr")));
   swoc::file::path prefix = temp_prefix();
@@ -120,8 +120,7 @@ init_ts(std::string_view name, int debug_on = 0)
 
   netProcessor.init();
 
-  const int nproc = ink_number_of_processors();
-  eventProcessor.start(nproc);
+  eventProcessor.start(threads);
   dnsProcessor.start(0, 1024 * 1024);
 
   hdb.start();
@@ -217,6 +216,45 @@ struct StartDNS : Continuation {
   }
 };
 
+// Repeated lookups of names that are already in HostDB, from every thread at once.
+struct CachedLookups : Continuation {
+  const StartDNS::HostList &hostlist;
+  int                       rounds;
+  latch                    &done_latch;
+  int64_t                   hits   = 0;
+  int64_t                   misses = 0;
+
+  CachedLookups(const StartDNS::HostList &hlist, int rounds, latch &l)
+    : Continuation(new_ProxyMutex()), hostlist(hlist), rounds(rounds), done_latch(l)
+  {
+    SET_HANDLER(&CachedLookups::start_lookups);
+  }
+
+  void
+  handle_hostdb(HostDBRecord *)
+  {
+    ++hits;
+  }
+
+  int
+  start_lookups(int, void *)
+  {
+    for (int i = 0; i < rounds; ++i) {
+      for (auto &host : hostlist) {
+        Action *action =
+          hdb.getbyname_imm(this, static_cast<cb_process_result_pfn>(&CachedLookups::handle_hostdb), host.c_str(), 0);
+        if (action != ACTION_RESULT_DONE) {
+          // Not cached, don't wait for DNS
+          ++misses;
+          action->cancel();
+        }
+      }
+    }
+    done_latch.count_down();
+    return 0;
+  }
+};
+
 StartDNS::HostList
 lines(const std::string &fname)
 {
@@ -250,10 +288,18 @@ main(int argc, char **argv)
   }
   int dbg = 0;
   if (argc > 2) {
-    dbg = 1;
+    dbg = atoi(argv[2]);
+  }
+  int nthreads = ink_number_of_processors();
+  if (argc > 3) {
+    nthreads = std::max(1, atoi(argv[3]));
+  }
+  int rounds = 10000;
+  if (argc > 4) {
+    rounds = std::max(0, atoi(argv[4]));
   }
 
-  init_ts("hostdb_test", dbg);
+  init_ts("hostdb_test", dbg, nthreads);
 
   auto threads = eventProcessor.active_group_threads(ET_CALL);
   int  count   = threads.end() - threads.begin();
@@ -298,6 +344,30 @@ main(int argc, char **argv)
   printf("dns min/max: %2.6f/%2.6f\n", min_d.count(), max_d.count());
   printf("imm min/max: %2.6f/%2.6f\n", min_i.count(), max_i.count());
   printf("Total results: %d average lookup %f\n", results_count, total_duration.count() / results_count);
+
+  if (rounds > 0) {
+    latch                        cl{count};
+    std::vector<CachedLookups *> cached;
+
+    auto start = StartDNS::Clock::now();
+    for (auto &t : eventProcessor.active_group_threads(ET_CALL)) {
+      CachedLookups *c = new CachedLookups{hosts, rounds, cl};
+      t->schedule_imm(c);
+      cached.push_back(c);
+    }
+    cl.wait();
+    std::chrono::duration<float> elapsed = StartDNS::Clock::now() - start;
+
+    int64_t hits   = 0;
+    int64_t misses = 0;
+    for (auto *c : cached) {
+      hits   += c->hits;
+      misses += c->misses;
+      delete c;
+    }
+    printf("Cached lookups: %" PRId64 " hits %" PRId64 " misses on %d threads in %f, %f lookups/s\n", hits, misses, count,
+           elapsed.count(), (hits + misses) / elapsed.count());
+  }
   hdb.shutdown();
 }
 
@@ -48,11 +48,17 @@ IOUringConfig IOUringContext::config;
 struct IOUringStatsBlock {
   Metrics::Counter::AtomicType *io_uring_submitted;
   Metrics::Counter::AtomicType *io_uring_completed;
+  Metrics::Counter::AtomicType *io_uring_submit_batches;
+  Metrics::Counter::AtomicType *io_uring_completion_batches;
 };
 
+// The batch counters count the submit / reap passes which moved at least one entry, such that
+// submitted / submit_batches and completed / completion_batches are the average batch sizes.
 static IOUringStatsBlock io_uring_rsb = []() {
   return IOUringStatsBlock{Metrics::Counter::createPtr("proxy.process.io_uring.submitted"),
-                           Metrics::Counter::createPtr("proxy.process.io_uring.completed")};
+                           Metrics::Counter::createPtr("proxy.process.io_uring.completed"),
+                           Metrics::Counter::createPtr("proxy.process.io_uring.submit_batches"),
+                           Metrics::Counter::createPtr("proxy.process.io_uring.completion_batches")};
 }();
 
 void
@@ -61,6 +67,12 @@ IOUringContext::set_config(const IOUringConfig &cfg)
   config = cfg;
 }
 
+bool
+IOUringContext::net_io_enabled()
+{
+  return config.net_io > 0;
+}
+
 static io_uring_probe probe_unsupported             = {};
 constexpr int         MAX_SUPPORTED_OP_BEFORE_PROBE = 20;
 
@@ -147,7 +159,12 @@ IOUringContext::get_wq_max_workers()
 void
 IOUringContext::submit()
 {
-  Metrics::Counter::increment(io_uring_rsb.io_uring_submitted, io_uring_submit(&ring));
+  int count = io_uring_submit(&ring);
+
+  if (count > 0) {
+    Metrics::Counter::increment(io_uring_rsb.io_uring_submitted, count);
+    Metrics::Counter::increment(io_uring_rsb.io_uring_submit_batches);
+  }
 }
 
 void
@@ -163,6 +180,9 @@ IOUringContext::service()
 {
   io_uring_cqe *cqe = nullptr;
   io_uring_peek_cqe(&ring, &cqe);
+  if (cqe) {
+    Metrics::Counter::increment(io_uring_rsb.io_uring_completion_batches);
+  }
   while (cqe) {
     handle_cqe(cqe);
     Metrics::Counter::increment(io_uring_rsb.io_uring_completed);
@@ -187,7 +207,13 @@ IOUringContext::submit_and_wait(ink_hrtime t)
 
   int count = io_uring_submit_and_wait_timeout(&ring, &cqe, 1, &timeout, nullptr);
 
-  Metrics::Counter::increment(io_uring_rsb.io_uring_submitted, count);
+  if (count > 0) {
+    Metrics::Counter::increment(io_uring_rsb.io_uring_submitted, count);
+    Metrics::Counter::increment(io_uring_rsb.io_uring_submit_batches);
+  }
+  if (cqe) {
+    Metrics::Counter::increment(io_uring_rsb.io_uring_completion_batches);
+  }
   while (cqe) {
     handle_cqe(cqe);
     Metrics::Counter::increment(io_uring_rsb.io_uring_completed);
@@ -0,0 +1,238 @@
+/** @file
+
+  io_uring backed socket reads and writes for UnixNetVConnection.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "P_Net.h"
+#include "P_IOUringNetOp.h"
+#include "P_UnixNetVConnection.h"
+#include "iocore/net/NetHandler.h"
+
+namespace
+{
+DbgCtl dbg_ctl_iocore_net_uring{"iocore_net_uring"};
+
+// The completion of a cancel request carries nothing of interest, the cancelled request completes on its own.
+class IOUringCancelHandler : public IOUringCompletionHandler
+{
+public:
+  void
+  handle_complete(io_uring_cqe * /* cqe ATS_UNUSED */) override
+  {
+  }
+};
+
+IOUringCancelHandler cancel_handler;
+
+} // end anonymous namespace
+
+void
+IOUringNetOp::handle_complete(io_uring_cqe *cqe)
+{
+  result = cqe->res;
+  state  = State::DONE;
+
+  if (_vc == nullptr) {
+    Dbg(dbg_ctl_iocore_net_uring, "detached %s op %p completed with %d", _is_read ? "recv" : "send", this, result);
+    delete this;
+    return;
+  }
+
+  NetHandler *nh = _vc->nh;
+  if (nh->cop_list.in(_vc)) {
+    nh->cop_list.remove(_vc);
+  }
+
+  if (_is_read) {
+    if (result > 0) {
+      _blocks[0]->fill(result);
+    }
+    _vc->read.triggered = 1;
+    if (!nh->read_ready_list.in(_vc)) {
+      nh->read_ready_list.enqueue(_vc);
+    }
+  } else {
+    // The kernel is done with the data, the reader is consumed by the VC.
+    for (auto &b : _blocks) {
+      b = nullptr;
+    }
+    _vc->write.triggered = 1;
+    if (!nh->write_ready_list.in(_vc)) {
+      nh->write_ready_list.enqueue(_vc);
+    }
+  }
+}
+
+bool
+IOUringNetOp::start_recv(int fd, int64_t len)
+{
+  ink_assert(state == State::IDLE && _is_read);
+
+  len = std::min(len, static_cast<int64_t>(BUFFER_SIZE_FOR_INDEX(BUFFER_SIZE_INDEX_32K)));
+
+  io_uring_sqe *sqe = IOUringContext::local_context()->next_sqe(this);
+  if (sqe == nullptr) {
+    return false;
+  }
+
+  // Keep receiving into the tail of the previous block unless it is nearly full.
+  int64_t min_avail = std::min(len, static_cast<int64_t>(BUFFER_SIZE_FOR_INDEX(BUFFER_SIZE_INDEX_4K)));
+  if (!_blocks[0] || _blocks[0]->write_avail() < min_avail) {
+    _blocks[0] = new_IOBufferBlock();
+    _blocks[0]->alloc(iobuffer_size_to_index(len, BUFFER_SIZE_INDEX_32K));
+  }
+  len = std::min(len, _blocks[0]->write_avail());
+
+  io_uring_prep_recv(sqe, fd, _blocks[0]->end(), len, 0);
+  state = State::IN_FLIGHT;
+  return true;
+}
+
+bool
+IOUringNetOp::start_send(int fd, IOBufferReader *r, int64_t len)
+{
+  ink_assert(state == State::IDLE && !_is_read);
+
+  io_uring_sqe *sqe = IOUringContext::local_context()->next_sqe(this);
+  if (sqe == nullptr) {
+    return false;
+  }
+
+  IOBufferReader *tmp_reader = r->clone();
+  int             niov       = 0;
+  int64_t         total      = 0;
+
+  while (niov < MAX_IOV && total < len) {
+    int64_t block_len = std::min(tmp_reader->block_read_avail(), len - total);
+    if (block_len <= 0) {
+      break;
+    }
+    _blocks[niov] = tmp_reader->block;
+    _iov[niov]    = IOVec(tmp_reader->start(), block_len);
+    niov++;
+
+    total += block_len;
+    tmp_reader->consume(block_len);
+  }
+  tmp_reader->dealloc();
+  ink_assert(niov > 0);
+
+  ink_zero(_msg);
+  _msg.msg_iov    = _iov;
+  _msg.msg_iovlen = niov;
+
+  io_uring_prep_sendmsg(sqe, fd, &_msg, 0);
+  reader  = r;
+  _queued = total;
+  state   = State::IN_FLIGHT;
+  return true;
+}
+
+int64_t
+IOUringNetOp::deliver(MIOBuffer *writer, int64_t len)
+{
+  ink_assert(state == State::DONE && _is_read && result > 0);
+
+  IOBufferBlock *b     = _blocks[0].get();
+  int64_t        avail = b->read_avail();
+  int64_t        n     = std::min(len, avail);
+
+  if (n == avail && b->write_avail() == 0) {
+    // The whole block goes to the VIO buffer, a new one is allocated for the next recv.
+    writer->append_block(b);
+    _blocks[0] = nullptr;
+  } else {
+    // Hand over the received bytes, the rest of the block stays here for the next recv.
+    IOBufferBlock *clone = b->clone();
+    clone->_end          = clone->_start + n;
+    clone->_buf_end      = clone->_end;
+    writer->append_block(clone);
+    b->consume(n);
+  }
+
+  if (n == avail) {
+    state  = State::IDLE;
+    result = 0;
+  }
+  return n;
+}
+
+int64_t
+IOUringNetOp::finish_send(IOBufferReader *current)
+{
+  ink_assert(state == State::DONE && !_is_read);
+
+  int64_t         r    = result;
+  IOBufferReader *from = reader;
+  reset();
+
+  if (r <= 0 || from == nullptr) {
+    return r < 0 ? r : 0;
+  }
+  from->consume(r);
+  return from == current ? r : 0;
+}
+
+void
+IOUringNetOp::drop_reader()
+{
+  if (_is_read || reader == nullptr) {
+    return;
+  }
+
+  if (state == State::DONE) {
+    if (result > 0) {
+      reader->consume(result);
+    }
+    reset();
+  } else if (state == State::IN_FLIGHT) {
+    // Whatever part of it is not sent belongs to a VIO that is being abandoned.
+    reader->consume(_queued);
+    reader = nullptr;
+  }
+}
+
+void
+IOUringNetOp::reset()
+{
+  state   = State::IDLE;
+  result  = 0;
+  reader  = nullptr;
+  _queued = 0;
+}
+
+void
+IOUringNetOp::release()
+{
+  if (state != State::IN_FLIGHT) {
+    delete this;
+    return;
+  }
+
+  _vc = nullptr;
+
+  io_uring_sqe *sqe = IOUringContext::local_context()->next_sqe(&cancel_handler);
+  if (sqe != nullptr) {
+    io_uring_prep_cancel(sqe, this, 0);
+  } else {
+    Dbg(dbg_ctl_iocore_net_uring, "no sqe to cancel %s op %p, waiting for it to complete", _is_read ? "recv" : "send", this);
+  }
+}
@@ -39,6 +39,8 @@ int net_accept_period  = 10;
 int net_retry_delay    = 10;
 int net_throttle_delay = 50; /* milliseconds */
 
+int net_splice_pipe_size = 0;
+
 // For the in/out congestion control: ToDo: this probably would be better as ports: specifications
 std::string_view net_ccp_in;
 std::string_view net_ccp_out;
@@ -51,6 +53,7 @@ configure_net()
 
   REC_EstablishStaticConfigInt32(net_retry_delay, "proxy.config.net.retry_delay");
   REC_EstablishStaticConfigInt32(net_throttle_delay, "proxy.config.net.throttle_delay");
+  REC_EstablishStaticConfigInt32(net_splice_pipe_size, "proxy.config.net.splice_pipe_size");
 
   // These are not reloadable
   REC_ReadConfigInteger(net_event_period, "proxy.config.net.event_period");
@@ -129,6 +132,8 @@ register_net_stats()
   net_rsb.read_bytes                       = Metrics::Counter::createPtr("proxy.process.net.read_bytes");
   net_rsb.read_bytes_count                 = Metrics::Counter::createPtr("proxy.process.net.read_bytes_count");
   net_rsb.requests_max_throttled_in        = Metrics::Counter::createPtr("proxy.process.net.max.requests_throttled_in");
+  net_rsb.splice_bytes                     = Metrics::Counter::createPtr("proxy.process.net.splice_bytes");
+  net_rsb.splice_pipes_currently_open      = Metrics::Gauge::createPtr("proxy.process.net.splice_pipes_currently_open");
   net_rsb.socks_connections_currently_open = Metrics::Gauge::createPtr("proxy.process.socks.connections_currently_open");
   net_rsb.socks_connections_successful     = Metrics::Counter::createPtr("proxy.process.socks.connections_successful");
   net_rsb.socks_connections_unsuccessful   = Metrics::Counter::createPtr("proxy.process.socks.connections_unsuccessful");
@@ -372,15 +372,17 @@ NetHandler::waitForActivity(ink_hrtime timeout)
 
   pd->result = 0;
 
+#if TS_USE_LINUX_IO_URING
+  // Reap completions before the ready lists are processed, so that socket I/O
+  // completed through io_uring is handled in this pass.
+  ur->service();
+#endif
+
   process_ready_list();
   ink_hrtime post_process = ink_get_hrtime();
   ink_hrtime process_time = post_process - post_poll;
   this->thread->metrics.current_slice.load(std::memory_order_acquire)->record_io_stats(poll_time, process_time);
 
-#if TS_USE_LINUX_IO_URING
-  ur->service();
-#endif
-
   return EVENT_CONT;
 }
 
@@ -0,0 +1,103 @@
+/** @file
+
+  io_uring backed socket reads and writes for UnixNetVConnection.
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#pragma once
+
+#include "tscore/ink_config.h"
+#if TS_USE_LINUX_IO_URING
+
+#include "tscore/ink_memory.h"
+#include "iocore/eventsystem/IOBuffer.h"
+#include "iocore/io_uring/IO_URING.h"
+
+#include <sys/socket.h>
+
+class UnixNetVConnection;
+
+/** A recv or sendmsg queued on the thread local io_uring on behalf of a @c UnixNetVConnection.
+
+    Each VC using io_uring has one read and one write operation, each with at most one request in
+    flight.  The operation owns (or holds a reference to) the memory the kernel reads or writes, so
+    it can outlive its VC: when the VC is freed with a request in flight the operation is detached,
+    the request is cancelled and the operation deletes itself once the completion arrives.
+
+    Completions mark the VC triggered and put it on the net handler ready list, the same as an
+    epoll event would, and the data is then picked up by @c net_read_io or @c net_write_io.
+ */
+class IOUringNetOp final : public IOUringCompletionHandler
+{
+public:
+  enum class State { IDLE, IN_FLIGHT, DONE };
+
+  IOUringNetOp(UnixNetVConnection *vc, bool is_read) : _vc(vc), _is_read(is_read) {}
+
+  void handle_complete(io_uring_cqe *cqe) override;
+
+  /** Queue a recv of at most @a len bytes into a block owned by this operation.
+      @return @c false if the ring had no free submission entry.
+   */
+  bool start_recv(int fd, int64_t len);
+
+  /** Queue a sendmsg of at most @a len bytes from @a reader.  The reader is not consumed, the
+      caller does that with the result once the send completes.
+      @return @c false if the ring had no free submission entry.
+   */
+  bool start_send(int fd, IOBufferReader *reader, int64_t len);
+
+  /// Move at most @a len received bytes to @a writer, returns the number of bytes moved.
+  int64_t deliver(MIOBuffer *writer, int64_t len);
+
+  /** Account the completed send.  The reader the data was taken from is consumed by the bytes sent,
+      they count towards the write VIO only if that reader is still @a current.
+      @return the number of bytes written for @a current or -errno.
+   */
+  int64_t finish_send(IOBufferReader *current);
+
+  /** The write VIO is about to stop using the reader of the last send.  Consume what the kernel took,
+      or is taking, from it while it is still valid; the completion is then not accounted to any reader.
+   */
+  void drop_reader();
+
+  /// Drop the result of the completed request and any buffers it holds.
+  void reset();
+
+  /// Detach from the VC and cancel the request if it is in flight.  The operation can not be used afterwards.
+  void release();
+
+  State           state  = State::IDLE;
+  int             result = 0;
+  IOBufferReader *reader = nullptr; ///< Reader the data of the last send was taken from.
+
+private:
+  // Blocks referenced by a single send.  Kept small as the memory lives as long as the VC.
+  static constexpr int MAX_IOV = 16;
+
+  UnixNetVConnection *_vc;
+  bool                _is_read;
+  int64_t             _queued = 0; ///< Bytes of the send in flight.
+  Ptr<IOBufferBlock>  _blocks[MAX_IOV];
+  IOVec               _iov[MAX_IOV];
+  msghdr              _msg;
+};
+
+#endif
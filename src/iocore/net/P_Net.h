@@ -72,6 +72,8 @@ struct NetStatsBlock {
   Metrics::Gauge::AtomicType   *tunnel_current_client_connections_tls_partial_blind;
   Metrics::Counter::AtomicType *tunnel_total_client_connections_tls_http;
   Metrics::Gauge::AtomicType   *tunnel_current_client_connections_tls_http;
+  Metrics::Counter::AtomicType *splice_bytes;
+  Metrics::Gauge::AtomicType   *splice_pipes_currently_open;
   Metrics::Gauge::AtomicType   *socks_connections_currently_open;
   Metrics::Counter::AtomicType *socks_connections_successful;
   Metrics::Counter::AtomicType *socks_connections_unsuccessful;
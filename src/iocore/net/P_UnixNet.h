@@ -85,6 +85,9 @@ net_connections_to_throttle(ThrottleType t)
   double headroom       = t == ACCEPT ? NET_THROTTLE_ACCEPT_HEADROOM : NET_THROTTLE_CONNECT_HEADROOM;
   int    currently_open = static_cast<int>(Metrics::Gauge::load(net_rsb.connections_currently_open));
 
+  // Each splice pipe holds two more fds.
+  currently_open += static_cast<int>(2 * Metrics::Gauge::load(net_rsb.splice_pipes_currently_open));
+
   // deal with race if we got to multiple net threads
   if (currently_open < 0) {
     currently_open = 0;
@@ -47,6 +47,12 @@
 class UnixNetVConnection;
 class NetHandler;
 struct PollDescriptor;
+#if TS_USE_LINUX_IO_URING
+class IOUringNetOp;
+#endif
+#ifdef HAVE_SPLICE
+struct NetSplice;
+#endif
 
 // WARNING:  many or most of the member functions of UnixNetVConnection should only be used when it is instantiated
 // directly.  They should not be used when UnixNetVConnection is a base class.
@@ -57,6 +63,7 @@ public:
   VIO *do_io_write(Continuation *c, int64_t nbytes, IOBufferReader *buf, bool owner = false) override;
 
   bool get_data(int id, void *data) override;
+  bool splice_to(VIO *read_vio, NetVConnection *peer, VIO *peer_write_vio) override;
 
   void do_io_close(int lerrno = -1) override;
   void do_io_shutdown(ShutdownHowTo_t howto) override;
@@ -245,6 +252,32 @@ private:
   virtual void         *_prepareForMigration();
   virtual NetProcessor *_getNetProcessor();
 
+  int64_t _read_from_net(int64_t toread, MIOBufferAccessor &buf);
+
+#if TS_USE_LINUX_IO_URING
+  // Socket reads and writes go through the thread's io_uring if these are set, see proxy.config.io_uring.net_io.
+  IOUringNetOp *_uring_read  = nullptr;
+  IOUringNetOp *_uring_write = nullptr;
+
+  void    _start_uring_io();
+  void    _stop_uring_io();
+  int64_t _uring_read_from_net(int64_t toread, MIOBufferAccessor &buf);
+  int64_t _uring_load_buffer_and_write(int64_t towrite, MIOBufferAccessor &buf, int64_t &total_written, int &needs);
+#endif
+
+#ifdef HAVE_SPLICE
+  // Set while the data read from this connection is spliced to another one, see splice_to().
+  NetSplice *_splice_out = nullptr;
+  // Set while another connection splices its data to this one.
+  NetSplice *_splice_in = nullptr;
+
+  void    _stop_splice_out();
+  void    _stop_splice_in();
+  bool    _splice_idle(MIOBufferAccessor &buf);
+  int64_t _splice_from_net(int64_t toread);
+  int64_t _splice_to_net(int64_t towrite);
+#endif
+
   bool _is_tunnel_endpoint{false};
 
   // Called by make_tunnel_endpiont() when the far end of the TCP connection is the active/client end.
@@ -27,12 +27,19 @@
 #include "P_UnixNetVConnection.h"
 #include "iocore/net/ConnectionTracker.h"
 #include "iocore/net/NetHandler.h"
+#include "iocore/net/TLSBasicSupport.h"
 #include "iocore/eventsystem/UnixSocket.h"
 #include "tscore/InkErrno.h"
 #include "tscore/ink_atomic.h"
+#if TS_USE_LINUX_IO_URING
+#include "P_IOUringNetOp.h"
+#endif
 
 #include <termios.h>
 #include <utility>
+#ifdef HAVE_SPLICE
+#include <fcntl.h>
+#endif
 
 #define STATE_VIO_OFFSET   ((uintptr_t) & ((NetState *)0)->vio)
 #define STATE_FROM_VIO(_x) ((NetState *)(((char *)(_x)) - STATE_VIO_OFFSET))
@@ -40,6 +47,22 @@
 // Global
 ClassAllocator<UnixNetVConnection> netVCAllocator("netVCAllocator");
 
+#ifdef HAVE_SPLICE
+// Smallest pipe worth splicing through when proxy.config.net.splice_pipe_size
+// is not set, the usual kernel default. Past fs.pipe-user-pages-soft the kernel
+// hands out pipes of a page or two instead.
+static constexpr int NET_SPLICE_MIN_PIPE_SIZE = 65536;
+
+// The pipe the data of @a source goes through on its way to @a sink.
+struct NetSplice {
+  UnixNetVConnection *source   = nullptr; ///< Cleared when the source leaves the rest of the data to @a sink.
+  UnixNetVConnection *sink     = nullptr;
+  int                 fd[2]    = {-1, -1};
+  int64_t             capacity = 0;
+  int64_t             pending  = 0; ///< Bytes in the pipe not yet written to @a sink.
+};
+#endif
+
 namespace
 {
 DbgCtl dbg_ctl_socket{"socket"};
@@ -216,6 +239,11 @@ UnixNetVConnection::do_io_read(Continuation *c, int64_t nbytes, MIOBuffer *buf)
     Error("do_io_read invoked on closed vc %p, cont %p, nbytes %" PRId64 ", buf %p", this, c, nbytes, buf);
     return nullptr;
   }
+#ifdef HAVE_SPLICE
+  if (_splice_out) {
+    this->_stop_splice_out();
+  }
+#endif
   read.vio.op        = VIO::READ;
   read.vio.mutex     = c ? c->mutex : this->mutex;
   read.vio.cont      = c;
@@ -241,12 +269,23 @@ UnixNetVConnection::do_io_write(Continuation *c, int64_t nbytes, IOBufferReader
     Error("do_io_write invoked on closed vc %p, cont %p, nbytes %" PRId64 ", reader %p", this, c, nbytes, reader);
     return nullptr;
   }
+#ifdef HAVE_SPLICE
+  if (_splice_in) {
+    this->_stop_splice_in();
+  }
+#endif
   write.vio.op        = VIO::WRITE;
   write.vio.mutex     = c ? c->mutex : this->mutex;
   write.vio.cont      = c;
   write.vio.nbytes    = nbytes;
   write.vio.ndone     = 0;
   write.vio.vc_server = this;
+#if TS_USE_LINUX_IO_URING
+  // A send taken from the previous reader is settled with it, the new reader did not supply it.
+  if (_uring_write && reader != write.vio.get_reader()) {
+    _uring_write->drop_reader();
+  }
+#endif
   if (reader) {
     ink_assert(!owner);
     write.vio.set_reader(reader);
@@ -262,6 +301,10 @@ UnixNetVConnection::do_io_write(Continuation *c, int64_t nbytes, IOBufferReader
 void
 UnixNetVConnection::do_io_close(int alerrno /* = -1 */)
 {
+#ifdef HAVE_SPLICE
+  this->_stop_splice_out();
+  this->_stop_splice_in();
+#endif
   // The vio continuations will be cleared in ::clear called from ::free_thread
   read.enabled    = 0;
   write.enabled   = 0;
@@ -512,57 +555,36 @@ UnixNetVConnection::net_read_io(NetHandler *nh)
     toread = ntodo;
   }
 
+#ifdef HAVE_SPLICE
+  bool spliced = false;
+  if (_splice_out) {
+    if (_splice_out->pending) {
+      // The sink reschedules this side once it has emptied the pipe.
+      nh->read_ready_list.remove(this);
+      return;
+    }
+    if (this->_splice_idle(buf)) {
+      spliced = true;
+      toread  = std::min(ntodo, _splice_out->capacity);
+    }
+  }
+#endif
+
   // read data
-  int64_t  rattempted = 0, total_read = 0;
-  unsigned niov = 0;
-  IOVec    tiovec[NET_MAX_IOV];
   if (toread) {
-    IOBufferBlock *b = buf.writer()->first_write_block();
-    do {
-      niov       = 0;
-      rattempted = 0;
-      while (b && niov < NET_MAX_IOV) {
-        int64_t a = b->write_avail();
-        if (a > 0) {
-          tiovec[niov].iov_base = b->_end;
-          int64_t togo          = toread - total_read - rattempted;
-          if (a > togo) {
-            a = togo;
-          }
-          tiovec[niov].iov_len  = a;
-          rattempted           += a;
-          niov++;
-          if (a >= togo) {
-            break;
-          }
-        }
-        b = b->next.get();
-      }
-
-      ink_assert(niov > 0);
-      ink_assert(niov <= countof(tiovec));
-      struct msghdr msg;
-
-      ink_zero(msg);
-      msg.msg_name    = const_cast<sockaddr *>(this->get_remote_addr());
-      msg.msg_namelen = ats_ip_size(this->get_remote_addr());
-      msg.msg_iov     = &tiovec[0];
-      msg.msg_iovlen  = niov;
-      r               = this->con.sock.recvmsg(&msg, 0);
-
-      Metrics::Counter::increment(net_rsb.calls_to_read);
-
-      total_read += rattempted;
-    } while (rattempted && r == rattempted && total_read < toread);
-
-    // if we have already moved some bytes successfully, summarize in r
-    if (total_read != rattempted) {
-      if (r <= 0) {
-        r = total_read - rattempted;
-      } else {
-        r = total_read - rattempted + r;
-      }
+#ifdef HAVE_SPLICE
+    if (spliced) {
+      r = this->_splice_from_net(toread);
+    } else
+#endif
+    {
+#if TS_USE_LINUX_IO_URING
+      r = _uring_read ? this->_uring_read_from_net(toread, buf) : this->_read_from_net(toread, buf);
+#else
+      r = this->_read_from_net(toread, buf);
+#endif
     }
+
     // check for errors
     if (r <= 0) {
       if (r == -EAGAIN || r == -ENOTCONN) {
@@ -585,8 +607,6 @@ UnixNetVConnection::net_read_io(NetHandler *nh)
     Metrics::Counter::increment(net_rsb.read_bytes, r);
     Metrics::Counter::increment(net_rsb.read_bytes_count);
 
-    // Add data to buffer and signal continuation.
-    buf.writer()->fill(r);
 #ifdef DEBUG
     if (buf.writer()->write_avail() <= 0) {
       Dbg(dbg_ctl_iocore_net, "read_from_net, read buffer full");
@@ -620,6 +640,12 @@ UnixNetVConnection::net_read_io(NetHandler *nh)
   }
 
   // If here are is no more room, or nothing to do, disable the connection
+#ifdef HAVE_SPLICE
+  if (spliced && s->vio.ntodo() > 0 && s->enabled) {
+    read_reschedule(nh, this);
+    return;
+  }
+#endif
   if (s->vio.ntodo() <= 0 || !s->enabled || !buf.writer()->write_avail()) {
     read_disable(nh, this);
     return;
@@ -628,6 +654,69 @@ UnixNetVConnection::net_read_io(NetHandler *nh)
   read_reschedule(nh, this);
 }
 
+// Read from the socket into the free space of the VIO buffer, filling the
+// buffer with what was read. Returns the number of bytes read or -errno.
+int64_t
+UnixNetVConnection::_read_from_net(int64_t toread, MIOBufferAccessor &buf)
+{
+  int64_t        r          = 0;
+  int64_t        rattempted = 0, total_read = 0;
+  unsigned       niov = 0;
+  IOVec          tiovec[NET_MAX_IOV];
+  IOBufferBlock *b = buf.writer()->first_write_block();
+  do {
+    niov       = 0;
+    rattempted = 0;
+    while (b && niov < NET_MAX_IOV) {
+      int64_t a = b->write_avail();
+      if (a > 0) {
+        tiovec[niov].iov_base = b->_end;
+        int64_t togo          = toread - total_read - rattempted;
+        if (a > togo) {
+          a = togo;
+        }
+        tiovec[niov].iov_len  = a;
+        rattempted           += a;
+        niov++;
+        if (a >= togo) {
+          break;
+        }
+      }
+      b = b->next.get();
+    }
+
+    ink_assert(niov > 0);
+    ink_assert(niov <= countof(tiovec));
+    struct msghdr msg;
+
+    ink_zero(msg);
+    msg.msg_name    = const_cast<sockaddr *>(this->get_remote_addr());
+    msg.msg_namelen = ats_ip_size(this->get_remote_addr());
+    msg.msg_iov     = &tiovec[0];
+    msg.msg_iovlen  = niov;
+    r               = this->con.sock.recvmsg(&msg, 0);
+
+    Metrics::Counter::increment(net_rsb.calls_to_read);
+
+    total_read += rattempted;
+  } while (rattempted && r == rattempted && total_read < toread);
+
+  // if we have already moved some bytes successfully, summarize in r
+  if (total_read != rattempted) {
+    if (r <= 0) {
+      r = total_read - rattempted;
+    } else {
+      r = total_read - rattempted + r;
+    }
+  }
+
+  // Add data to buffer.
+  if (r > 0) {
+    buf.writer()->fill(r);
+  }
+  return r;
+}
+
 //
 // Write the data for a UnixNetVConnection.
 // Rescheduling the UnixNetVConnection when necessary.
@@ -716,6 +805,42 @@ UnixNetVConnection::net_write_io(NetHandler *nh)
   MIOBufferAccessor &buf = s->vio.buffer;
   ink_assert(buf.writer());
 
+#ifdef HAVE_SPLICE
+  // Data spliced from another connection was read before anything now in the write buffer.
+  if (_splice_in && _splice_in->pending) {
+    int64_t r = this->_splice_to_net(std::min(ntodo, _splice_in->pending));
+    if (r > 0) {
+      Metrics::Counter::increment(net_rsb.write_bytes, r);
+      Metrics::Counter::increment(net_rsb.write_bytes_count);
+      s->vio.ndone += r;
+      this->netActivity();
+    } else if (r != -EAGAIN) {
+      this->write.triggered = 0;
+      write_signal_error(nh, this, static_cast<int>(-r));
+      return;
+    }
+    bool drained = _splice_in->pending == 0;
+    if (drained) {
+      if (_splice_in->source) {
+        read_reschedule(nh, _splice_in->source);
+      } else {
+        // The source is gone, it left the pipe to this side to empty.
+        this->_stop_splice_in();
+      }
+    }
+    if (s->vio.ntodo() <= 0) {
+      write_signal_done(VC_EVENT_WRITE_COMPLETE, nh, this);
+      return;
+    }
+    if (!drained) {
+      this->write.triggered = 0;
+      nh->write_ready_list.remove(this);
+      return;
+    }
+    ntodo = s->vio.ntodo();
+  }
+#endif
+
   // Calculate the amount to write.
   int64_t towrite = buf.reader()->read_avail();
   if (towrite > ntodo) {
@@ -851,6 +976,12 @@ UnixNetVConnection::net_write_io(NetHandler *nh)
 int64_t
 UnixNetVConnection::load_buffer_and_write(int64_t towrite, MIOBufferAccessor &buf, int64_t &total_written, int &needs)
 {
+#if TS_USE_LINUX_IO_URING
+  if (_uring_write) {
+    return this->_uring_load_buffer_and_write(towrite, buf, total_written, needs);
+  }
+#endif
+
   int64_t         r            = 0;
   int64_t         try_to_write = 0;
   IOBufferReader *tmp_reader   = buf.reader()->clone();
@@ -935,6 +1066,294 @@ UnixNetVConnection::load_buffer_and_write(int64_t towrite, MIOBufferAccessor &bu
   return r;
 }
 
+#if TS_USE_LINUX_IO_URING
+// Use io_uring for the socket I/O of plain inbound connections if enabled and
+// supported by the kernel. TLS connections keep going through the SSL library.
+void
+UnixNetVConnection::_start_uring_io()
+{
+  if (!IOUringContext::net_io_enabled() || this->get_context() != NET_VCONNECTION_IN ||
+      this->get_service<TLSBasicSupport>() != nullptr) {
+    return;
+  }
+
+  IOUringContext *ur = IOUringContext::local_context();
+  if (!ur->valid() || !ur->supports_op(IORING_OP_RECV) || !ur->supports_op(IORING_OP_SENDMSG)) {
+    return;
+  }
+
+  _uring_read  = new IOUringNetOp(this, true);
+  _uring_write = new IOUringNetOp(this, false);
+}
+
+// Must be called before the socket is closed so requests in flight are cancelled.
+void
+UnixNetVConnection::_stop_uring_io()
+{
+  if (_uring_read) {
+    _uring_read->release();
+    _uring_read = nullptr;
+  }
+  if (_uring_write) {
+    _uring_write->release();
+    _uring_write = nullptr;
+  }
+}
+
+// The io_uring counterpart of _read_from_net. A recv is queued if there is none
+// outstanding and -EAGAIN returned until it completes, the completion puts the
+// VC back on the read ready list.
+int64_t
+UnixNetVConnection::_uring_read_from_net(int64_t toread, MIOBufferAccessor &buf)
+{
+  IOUringNetOp *op = _uring_read;
+
+  switch (op->state) {
+  case IOUringNetOp::State::IN_FLIGHT:
+    return -EAGAIN;
+  case IOUringNetOp::State::DONE:
+    if (op->result > 0) {
+      return op->deliver(buf.writer(), toread);
+    } else {
+      // 0 is EOS, anything else an error. -EAGAIN leaves it to epoll to trigger the next read.
+      int64_t r = op->result;
+      op->reset();
+      return r;
+    }
+  case IOUringNetOp::State::IDLE:
+    break;
+  }
+
+  if (!op->start_recv(this->con.sock.get_fd(), toread)) {
+    // The ring is full, read directly this time.
+    return this->_read_from_net(toread, buf);
+  }
+  Metrics::Counter::increment(net_rsb.calls_to_read);
+  return -EAGAIN;
+}
+
+// The io_uring counterpart of load_buffer_and_write. The reader is consumed
+// when the send completes, at which point the next send is queued right away
+// if there is more data to write.
+int64_t
+UnixNetVConnection::_uring_load_buffer_and_write(int64_t towrite, MIOBufferAccessor &buf, int64_t &total_written, int &needs)
+{
+  IOUringNetOp *op = _uring_write;
+  int64_t       r  = -EAGAIN;
+
+  needs |= EVENTIO_WRITE;
+
+  if (op->state == IOUringNetOp::State::IN_FLIGHT) {
+    return r;
+  }
+
+  if (op->state == IOUringNetOp::State::DONE) {
+    r = op->finish_send(buf.reader());
+
+    if (r > 0) {
+      total_written += r;
+      if (total_written >= towrite) {
+        return r;
+      }
+    } else if (r < 0) {
+      // -EAGAIN leaves it to epoll to trigger the next write.
+      return r;
+    }
+  }
+
+  if (!op->start_send(this->con.sock.get_fd(), buf.reader(), towrite - total_written)) {
+    // The ring is full, write directly this time.
+    _uring_write = nullptr;
+    int64_t res  = this->load_buffer_and_write(towrite, buf, total_written, needs);
+    _uring_write = op;
+    return total_written > 0 ? total_written : res;
+  }
+  Metrics::Counter::increment(net_rsb.calls_to_write);
+
+  return total_written > 0 ? total_written : -EAGAIN;
+}
+#endif
+
+#ifdef HAVE_SPLICE
+static void
+close_net_splice(NetSplice *sp)
+{
+  ::close(sp->fd[0]);
+  ::close(sp->fd[1]);
+  delete sp;
+  Metrics::Gauge::decrement(net_rsb.splice_pipes_currently_open);
+}
+#endif
+
+bool
+UnixNetVConnection::splice_to(VIO *read_vio, NetVConnection *peer, VIO *peer_write_vio)
+{
+#ifdef HAVE_SPLICE
+  UnixNetVConnection *sink = dynamic_cast<UnixNetVConnection *>(peer);
+
+  // Both ends must be plain sockets driven by the same thread and lock, else the
+  // sink can not safely account for the bytes the source moved.
+  if (sink == nullptr || sink == this || read_vio != &this->read.vio || peer_write_vio != &sink->write.vio || _splice_out ||
+      sink->_splice_in || this->closed || sink->closed || this->thread != sink->thread || this->nh != sink->nh ||
+      read.vio.mutex != sink->write.vio.mutex || this->get_service<TLSBasicSupport>() != nullptr ||
+      sink->get_service<TLSBasicSupport>() != nullptr) {
+    return false;
+  }
+#if TS_USE_LINUX_IO_URING
+  if (_uring_read || sink->_uring_write) {
+    return false;
+  }
+#endif
+
+  // The pipe takes two fds, they count against the connection throttle.
+  if (check_net_throttle(CONNECT)) {
+    return false;
+  }
+
+  NetSplice *sp = new NetSplice;
+  if (pipe2(sp->fd, O_NONBLOCK | O_CLOEXEC) < 0) {
+    Dbg(dbg_ctl_iocore_net, "splice_to: pipe2 failed: %s", strerror(errno));
+    delete sp;
+    return false;
+  }
+  Metrics::Gauge::increment(net_rsb.splice_pipes_currently_open);
+
+  // The pipe buffer is kernel memory charged to the user. If the kernel will
+  // not give the size asked for, copying through IOBuffers is faster than a
+  // tiny pipe.
+  int wanted = NET_SPLICE_MIN_PIPE_SIZE;
+  int size;
+  if (net_splice_pipe_size > 0) {
+    wanted = net_splice_pipe_size;
+    size   = fcntl(sp->fd[1], F_SETPIPE_SZ, wanted);
+  } else {
+    size = fcntl(sp->fd[1], F_GETPIPE_SZ);
+  }
+  if (size < wanted) {
+    Dbg(dbg_ctl_iocore_net, "splice_to: pipe of %d bytes refused, got %d: %s", wanted, size,
+        size < 0 ? strerror(errno) : "too small");
+    close_net_splice(sp);
+    return false;
+  }
+  sp->capacity      = size;
+  sp->source        = this;
+  sp->sink          = sink;
+  _splice_out       = sp;
+  sink->_splice_in  = sp;
+  Dbg(dbg_ctl_iocore_net, "splice_to: vc %p fd %d -> vc %p fd %d, pipe %" PRId64 " bytes", this, get_fd(), sink, sink->get_fd(),
+      sp->capacity);
+  return true;
+#else
+  return false;
+#endif
+}
+
+#ifdef HAVE_SPLICE
+// Undo splice_to() for the source end. Bytes already in the pipe were counted
+// as read and the source may be done with them, e.g. released after
+// READ_COMPLETE, so the pipe stays with the sink until it has written them.
+void
+UnixNetVConnection::_stop_splice_out()
+{
+  NetSplice *sp = _splice_out;
+  if (sp == nullptr) {
+    return;
+  }
+  _splice_out = nullptr;
+  sp->source  = nullptr;
+  if (sp->pending > 0) {
+    Dbg(dbg_ctl_iocore_net, "stop splice vc %p -> vc %p, %" PRId64 " bytes left to the sink", this, sp->sink, sp->pending);
+    return;
+  }
+  Dbg(dbg_ctl_iocore_net, "stop splice vc %p -> vc %p", this, sp->sink);
+  sp->sink->_splice_in = nullptr;
+  close_net_splice(sp);
+}
+
+// Undo splice_to() for the sink end. Any data left in the pipe is lost, which
+// only happens when the sink is closed or its write VIO is replaced mid transfer.
+void
+UnixNetVConnection::_stop_splice_in()
+{
+  NetSplice *sp = _splice_in;
+  if (sp == nullptr) {
+    return;
+  }
+  _splice_in = nullptr;
+  Dbg(dbg_ctl_iocore_net, "stop splice vc %p -> vc %p, %" PRId64 " bytes dropped", sp->source, this, sp->pending);
+  UnixNetVConnection *source = sp->source;
+  close_net_splice(sp);
+  // The source may be parked waiting for the sink, let it go back to buffered reads.
+  if (source != nullptr) {
+    source->_splice_out = nullptr;
+    if (source != this && source->nh && !source->closed) {
+      read_reschedule(source->nh, source);
+    }
+  }
+}
+
+// The source may splice only when every byte it read into the VIO buffer has
+// been written by the sink, or the data would go out of order.
+bool
+UnixNetVConnection::_splice_idle(MIOBufferAccessor &buf)
+{
+  IOBufferReader *reader = _splice_out->sink->write.vio.buffer.reader();
+  return buf.writer()->max_read_avail() == 0 && (reader == nullptr || reader->read_avail() == 0);
+}
+
+// Move at most @a toread bytes from the socket into the pipe, the sink takes
+// them from there. Returns the number of bytes moved or -errno.
+int64_t
+UnixNetVConnection::_splice_from_net(int64_t toread)
+{
+  NetSplice *sp = _splice_out;
+  ssize_t    r;
+
+  do {
+    r = splice(this->con.sock.get_fd(), nullptr, sp->fd[1], nullptr, toread, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+  } while (r < 0 && errno == EINTR);
+  Metrics::Counter::increment(net_rsb.calls_to_read);
+
+  if (r < 0) {
+    return -errno;
+  }
+  if (r > 0) {
+    sp->pending += r;
+    Metrics::Counter::increment(net_rsb.splice_bytes, r);
+    sp->sink->reenable(&sp->sink->write.vio);
+  }
+  return r;
+}
+
+// Move at most @a towrite bytes from the pipe to the socket, until the socket
+// is full. Returns the number of bytes moved, -EAGAIN if none or -errno.
+int64_t
+UnixNetVConnection::_splice_to_net(int64_t towrite)
+{
+  NetSplice *sp            = _splice_in;
+  int64_t    total_written = 0;
+  ssize_t    r             = 0;
+
+  while (total_written < towrite) {
+    r = splice(sp->fd[0], nullptr, this->con.sock.get_fd(), nullptr, towrite - total_written, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+    Metrics::Counter::increment(net_rsb.calls_to_write);
+    if (r > 0) {
+      sp->pending   -= r;
+      total_written += r;
+    } else if (r < 0 && errno == EINTR) {
+      continue;
+    } else {
+      break;
+    }
+  }
+
+  if (total_written > 0) {
+    return total_written;
+  }
+  return r < 0 ? -errno : -EAGAIN;
+}
+#endif
+
 void
 UnixNetVConnection::readDisable(NetHandler *nh)
 {
@@ -1015,6 +1434,10 @@ UnixNetVConnection::acceptEvent(int /* event ATS_UNUSED */, Event *e)
     return EVENT_DONE;
   }
 
+#if TS_USE_LINUX_IO_URING
+  this->_start_uring_io();
+#endif
+
   // Switch vc->mutex from NetHandler->mutex to new mutex
   mutex = new_ProxyMutex();
   SCOPED_MUTEX_LOCK(lock2, mutex, t);
@@ -1283,6 +1706,14 @@ UnixNetVConnection::free_thread(EThread *t)
 
   ink_release_assert(t == this_ethread());
 
+#if TS_USE_LINUX_IO_URING
+  this->_stop_uring_io();
+#endif
+#ifdef HAVE_SPLICE
+  this->_stop_splice_out();
+  this->_stop_splice_in();
+#endif
+
   // close socket fd
   if (con.sock.is_ok()) {
     release_inbound_connection_tracking();
@@ -0,0 +1,122 @@
+/** @file
+
+  Catch based unit tests for the send accounting of IOUringNetOp
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "catch.hpp"
+
+#include "iocore/eventsystem/IOBuffer.h"
+#include "tscore/ink_hrtime.h"
+
+#include "../P_IOUringNetOp.h"
+
+#include <string_view>
+#include <sys/socket.h>
+#include <unistd.h>
+
+TEST_CASE("IOUringNetOp send accounting", "[net][io_uring]")
+{
+  MIOBuffer      *a  = new_MIOBuffer(BUFFER_SIZE_INDEX_4K);
+  MIOBuffer      *b  = new_MIOBuffer(BUFFER_SIZE_INDEX_4K);
+  IOBufferReader *ra = a->alloc_reader();
+  IOBufferReader *rb = b->alloc_reader();
+
+  a->write("hello", 5);
+  b->write("world!", 6);
+
+  IOUringNetOp *op = new IOUringNetOp(nullptr, false);
+
+  SECTION("completed send on the current reader")
+  {
+    op->state  = IOUringNetOp::State::DONE;
+    op->result = 3;
+    op->reader = ra;
+
+    CHECK(op->finish_send(ra) == 3);
+    CHECK(ra->read_avail() == 2);
+    CHECK(op->state == IOUringNetOp::State::IDLE);
+    op->release();
+  }
+
+  SECTION("completed send after the reader changed")
+  {
+    op->state  = IOUringNetOp::State::DONE;
+    op->result = 3;
+    op->reader = ra;
+
+    // The bytes came from the first reader, the new one is left alone and the VIO is not credited.
+    CHECK(op->finish_send(rb) == 0);
+    CHECK(ra->read_avail() == 2);
+    CHECK(rb->read_avail() == 6);
+    op->release();
+  }
+
+  SECTION("reader dropped after the send completed")
+  {
+    op->state  = IOUringNetOp::State::DONE;
+    op->result = 4;
+    op->reader = ra;
+
+    op->drop_reader();
+    CHECK(ra->read_avail() == 1);
+    CHECK(op->state == IOUringNetOp::State::IDLE);
+    CHECK(op->reader == nullptr);
+    op->release();
+  }
+
+  SECTION("reader dropped while the send is in flight")
+  {
+    IOUringContext *ur = IOUringContext::local_context();
+    if (!ur->valid() || !ur->supports_op(IORING_OP_SENDMSG)) {
+      WARN("io_uring sendmsg is not available");
+      op->release();
+    } else {
+      int fds[2];
+      REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+      REQUIRE(op->start_send(fds[0], ra, 5));
+      CHECK(ra->read_avail() == 5);
+
+      op->drop_reader();
+      CHECK(ra->read_avail() == 0);
+      CHECK(op->reader == nullptr);
+
+      // The op keeps the data alive for the kernel after the buffer it came from is gone.
+      free_MIOBuffer(a);
+      a = nullptr;
+
+      op->release();
+      ur->submit_and_wait(100 * HRTIME_MSECOND);
+
+      char    buffer[8];
+      ssize_t n = read(fds[1], buffer, sizeof(buffer));
+      CHECK(std::string_view(buffer, n > 0 ? n : 0) == "hello");
+
+      close(fds[0]);
+      close(fds[1]);
+    }
+  }
+
+  if (a) {
+    free_MIOBuffer(a);
+  }
+  free_MIOBuffer(b);
+}
@@ -142,6 +142,17 @@ HostMatcher<Data, MatchResult>::AllocateSpace(int num_entries)
   num_el     = 0;
 }
 
+// void HostMatcher<Data,MatchResult>::Finalize()
+//
+//  Builds the lookup trie once all the entries are in
+//
+template <class Data, class MatchResult>
+void
+HostMatcher<Data, MatchResult>::Finalize()
+{
+  host_lookup->Finalize();
+}
+
 // void HostMatcher<Data,MatchResult>::Match(RequestData* rdata, MatchResult* result)
 //
 //  Searches our tree and updates argresult for each element matching
@@ -374,11 +385,9 @@ RegexMatcher<Data, MatchResult>::RegexMatcher(const char *name, const char *file
 template <class Data, class MatchResult> RegexMatcher<Data, MatchResult>::~RegexMatcher()
 {
   for (int i = 0; i < num_el; i++) {
-    pcre_free(re_array[i]);
     ats_free(re_str[i]);
   }
   delete[] re_str;
-  ats_free(re_array);
 }
 
 //
@@ -407,9 +416,6 @@ RegexMatcher<Data, MatchResult>::AllocateSpace(int num_entries)
   // Should not have been allocated before
   ink_assert(array_len == -1);
 
-  re_array = static_cast<pcre **>(ats_malloc(sizeof(pcre *) * num_entries));
-  memset(re_array, 0, sizeof(pcre *) * num_entries);
-
   data_array = new Data[num_entries];
 
   re_str = new char *[num_entries];
@@ -428,7 +434,7 @@ RegexMatcher<Data, MatchResult>::NewEntry(matcher_line *line_info)
 {
   Data       *cur_d;
   char       *pattern;
-  const char *errptr;
+  std::string errstr;
   int         erroffset;
   Result      error = Result::ok();
 
@@ -444,13 +450,11 @@ RegexMatcher<Data, MatchResult>::NewEntry(matcher_line *line_info)
   ink_assert(line_info->dest_entry < MATCHER_MAX_TOKENS);
   ink_assert(pattern != nullptr);
 
-  // Create the compiled regular expression
-  re_array[num_el] = pcre_compile(pattern, 0, &errptr, &erroffset, nullptr);
-  if (!re_array[num_el]) {
+  // Compile the regular expression into the set, its index is the entry index
+  if (!re_set.add(pattern, errstr, erroffset)) {
     return Result::failure("%s regular expression error at line %d position %d : %s", matcher_name, line_info->line_num, erroffset,
-                           errptr);
+                           errstr.c_str());
   }
-  re_str[num_el] = ats_strdup(pattern);
 
   // Remove our consumed label from the parsed line
   line_info->line[0][line_info->dest_entry] = nullptr;
@@ -462,29 +466,52 @@ RegexMatcher<Data, MatchResult>::NewEntry(matcher_line *line_info)
 
   if (error.failed()) {
     // There was a problem so undo the effects this function
-    ats_free(re_str[num_el]);
-    re_str[num_el] = nullptr;
-    pcre_free(re_array[num_el]);
-    re_array[num_el] = nullptr;
+    re_set.pop_back();
   } else {
+    re_str[num_el] = ats_strdup(pattern);
     num_el++;
   }
 
   return error;
 }
 
+//
+// void RegexMatcher<Data,MatchResult>::Finalize()
+//
+template <class Data, class MatchResult>
+void
+RegexMatcher<Data, MatchResult>::Finalize()
+{
+  re_set.finalize();
+  Dbg(dbg_ctl_matcher, "%s %d of %d regexs prefiltered by a literal", matcher_name, re_set.literal_count(), re_set.size());
+}
+
+//
+// void RegexMatcher<Data,MatchResult>::MatchString(const char *str, RequestData* rdata, MatchResult* result)
+//
+//   Matches arg str against all of the regexs in one pass and
+//     updates arg result for each regex that matches, in line order
+//
+template <class Data, class MatchResult>
+void
+RegexMatcher<Data, MatchResult>::MatchString(const char *str, RequestData *rdata, MatchResult *result) const
+{
+  re_set.match(str, [&](int32_t i) {
+    Dbg(dbg_ctl_matcher, "%s Matched %s with regex at line %d", matcher_name, str, data_array[i].line_num);
+    data_array[i].UpdateMatch(result, rdata);
+  });
+}
+
 //
 // void RegexMatcher<Data,MatchResult>::Match(RequestData* rdata, MatchResult* result)
 //
-//   Coduncts a linear search through the regex array and
-//     updates arg result for each regex that matches arg URL
+//   Updates arg result for each regex that matches arg URL
 //
 template <class Data, class MatchResult>
 void
 RegexMatcher<Data, MatchResult>::Match(RequestData *rdata, MatchResult *result) const
 {
   char *url_str;
-  int   r;
 
   // Check to see there is any work to before we copy the
   //   URL
@@ -504,16 +531,7 @@ RegexMatcher<Data, MatchResult>::Match(RequestData *rdata, MatchResult *result)
   // The function unescapifyStr() is already called in
   // HttpRequestData::get_string(); therefore, no need to call again here.
 
-  for (int i = 0; i < num_el; i++) {
-    r = pcre_exec(re_array[i], nullptr, url_str, strlen(url_str), 0, 0, nullptr, 0);
-    if (r > -1) {
-      Dbg(dbg_ctl_matcher, "%s Matched %s with regex at line %d", matcher_name, url_str, data_array[i].line_num);
-      data_array[i].UpdateMatch(result, rdata);
-    } else if (r < -1) {
-      // An error has occurred
-      Warning("Error [%d] matching regex at line %d.", r, data_array[i].line_num);
-    } // else it's -1 which means no match was found.
-  }
+  this->MatchString(url_str, rdata, result);
   ats_free(url_str);
 }
 
@@ -529,15 +547,13 @@ HostRegexMatcher<Data, MatchResult>::HostRegexMatcher(const char *name, const ch
 //
 // void HostRegexMatcher<Data,MatchResult>::Match(RequestData* rdata, MatchResult* result)
 //
-//   Conducts a linear search through the regex array and
-//     updates arg result for each regex that matches arg host_regex
+//   Updates arg result for each regex that matches arg host_regex
 //
 template <class Data, class MatchResult>
 void
 HostRegexMatcher<Data, MatchResult>::Match(RequestData *rdata, MatchResult *result) const
 {
   const char *url_str;
-  int         r;
 
   // Check to see there is any work to before we copy the
   //   URL
@@ -552,17 +568,7 @@ HostRegexMatcher<Data, MatchResult>::Match(RequestData *rdata, MatchResult *resu
   if (url_str == nullptr) {
     url_str = "";
   }
-  for (int i = 0; i < this->num_el; i++) {
-    r = pcre_exec(this->re_array[i], nullptr, url_str, strlen(url_str), 0, 0, nullptr, 0);
-    if (r != -1) {
-      Dbg(dbg_ctl_matcher, "%s Matched %s with regex at line %d", const_cast<char *>(this->matcher_name), url_str,
-          this->data_array[i].line_num);
-      this->data_array[i].UpdateMatch(result, rdata);
-    } else {
-      // An error has occurred
-      Warning("error matching regex at line %d", this->data_array[i].line_num);
-    }
-  }
+  this->MatchString(url_str, rdata, result);
 }
 
 //
@@ -920,6 +926,16 @@ ControlMatcher<Data, MatchResult>::BuildTableFromString(char *file_buf)
 
   ink_assert(second_pass == numEntries);
 
+  if (hostMatch != nullptr) {
+    hostMatch->Finalize();
+  }
+  if (reMatch != nullptr) {
+    reMatch->Finalize();
+  }
+  if (hrMatch != nullptr) {
+    hrMatch->Finalize();
+  }
+
   if (dbg_ctl_matcher.on()) {
     Print();
   }
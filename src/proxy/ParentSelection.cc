@@ -757,6 +757,15 @@ ParentRecord::Init(matcher_line *line_info)
       int v          = atoi(val);
       secondary_mode = v;
       used           = true;
+    } else if (strcasecmp(label, "hash_algorithm") == 0) {
+      if (strcasecmp(val, "ring") == 0) {
+        hash_algorithm = ATSConsistentHash::Algorithm::RING;
+      } else if (strcasecmp(val, "maglev") == 0) {
+        hash_algorithm = ATSConsistentHash::Algorithm::MAGLEV;
+      } else {
+        errPtr = "invalid argument to hash_algorithm directive";
+      }
+      used = true;
     } else if (strcasecmp(label, "ignore_self_detect") == 0) {
       if (strcasecmp(val, "true") == 0) {
         ignore_self_detect = true;
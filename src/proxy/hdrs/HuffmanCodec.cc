@@ -23,9 +23,11 @@
 
 #include "proxy/hdrs/HuffmanCodec.h"
 #include "tscore/ink_platform.h"
-#include "tscore/ink_memory.h"
+#include "tscore/ink_assert.h"
 #include "tscore/ink_defs.h"
 
+#include <cstring>
+
 struct huffman_entry {
   uint32_t code_as_hex;
   uint32_t bit_len;
@@ -291,140 +293,131 @@ static const huffman_entry huffman_table[] = {
   {0x3fffffff, 30}
 };
 
-using Node = struct node {
-  node *left, *right;
-  char  ascii_code;
-  bool  leaf_node;
+// The decoder is a finite state machine which consumes 4 bits of input per transition. Each state is an
+// internal node of the Huffman tree, and each transition walks the tree 4 bits at a time, emitting at
+// most one symbol (the shortest code is 5 bits long). The table is built once from huffman_table.
+#define HUFFMAN_NUM_STATES 256
+#define HUFFMAN_EOS_SYM    256
+
+enum {
+  HUFFMAN_FLAG_ACCEPT = 0x01, // The bits consumed since the last symbol are a valid padding (a prefix of EOS)
+  HUFFMAN_FLAG_SYM    = 0x02, // A symbol is emitted
+  HUFFMAN_FLAG_FAIL   = 0x04, // EOS was decoded, which is a decoding error
 };
 
-Node *HUFFMAN_TREE_ROOT;
+struct huffman_decode_entry {
+  uint8_t state;
+  uint8_t flags;
+  uint8_t sym;
+};
 
-static Node *
-make_huffman_tree_node()
-{
-  Node *n       = static_cast<Node *>(ats_malloc(sizeof(Node)));
-  n->left       = nullptr;
-  n->right      = nullptr;
-  n->ascii_code = '\0';
-  n->leaf_node  = false;
-  return n;
-}
+static huffman_decode_entry huffman_decode_table[HUFFMAN_NUM_STATES][16];
+static bool                 huffman_decode_table_ready = false;
 
-static Node *
-make_huffman_tree()
+static void
+make_huffman_decode_table()
 {
-  Node *root = make_huffman_tree_node();
+  // Build the tree into flat arrays, internal nodes are numbered in order of creation with the root as 0.
+  // A child value >= 0 is an internal node, a negative value ~sym is a leaf.
+  int  child[HUFFMAN_NUM_STATES][2];
+  bool accept[HUFFMAN_NUM_STATES];
+  int  num_nodes = 1;
 
-  // insert leafs for each ascii code
-  for (unsigned i = 0; i < countof(huffman_table); i++) {
-    uint32_t bit_len = huffman_table[i].bit_len;
-    Node    *current = root;
+  memset(child, 0, sizeof(child));
+  accept[0] = true;
 
-    while (bit_len > 0) {
-      if (huffman_table[i].code_as_hex & (1 << (bit_len - 1))) {
-        if (!current->right) {
-          current->right = make_huffman_tree_node();
-        }
-        current = current->right;
-      } else {
-        if (!current->left) {
-          current->left = make_huffman_tree_node();
-        }
-        current = current->left;
+  for (unsigned i = 0; i < countof(huffman_table); i++) {
+    uint32_t bit_len  = huffman_table[i].bit_len;
+    int      current  = 0;
+    bool     all_ones = true;
+    uint32_t depth    = 0;
+
+    while (bit_len > 1) {
+      int bit   = (huffman_table[i].code_as_hex >> (bit_len - 1)) & 1;
+      all_ones  = all_ones && bit;
+      depth    += 1;
+      if (!child[current][bit]) {
+        ink_release_assert(num_nodes < HUFFMAN_NUM_STATES);
+        child[current][bit] = num_nodes;
+        accept[num_nodes]   = all_ones && depth <= 7;
+        ++num_nodes;
       }
+      current = child[current][bit];
       bit_len--;
     }
-    current->ascii_code = i;
-    current->leaf_node  = true;
+    child[current][huffman_table[i].code_as_hex & 1] = ~static_cast<int>(i);
   }
 
-  return root;
-}
-
-static void
-free_huffman_tree(Node *node)
-{
-  if (node->left) {
-    free_huffman_tree(node->left);
-  }
-  if (node->right) {
-    free_huffman_tree(node->right);
+  for (int state = 0; state < num_nodes; ++state) {
+    for (int nibble = 0; nibble < 16; ++nibble) {
+      huffman_decode_entry &entry   = huffman_decode_table[state][nibble];
+      int                   current = state;
+
+      entry.flags = 0;
+      entry.sym   = 0;
+      for (int shift = 3; shift >= 0; --shift) {
+        int next = child[current][(nibble >> shift) & 1];
+
+        if (next < 0) {
+          if (~next == HUFFMAN_EOS_SYM) {
+            entry.flags |= HUFFMAN_FLAG_FAIL;
+            break;
+          }
+          entry.flags |= HUFFMAN_FLAG_SYM;
+          entry.sym    = ~next;
+          current      = 0;
+        } else {
+          current = next;
+        }
+      }
+      entry.state = current;
+      if (accept[current]) {
+        entry.flags |= HUFFMAN_FLAG_ACCEPT;
+      }
+    }
   }
-
-  ats_free(node);
 }
 
 void
 hpack_huffman_init()
 {
-  if (!HUFFMAN_TREE_ROOT) {
-    HUFFMAN_TREE_ROOT = make_huffman_tree();
+  if (!huffman_decode_table_ready) {
+    make_huffman_decode_table();
+    huffman_decode_table_ready = true;
   }
 }
 
 void
 hpack_huffman_fin()
 {
-  if (HUFFMAN_TREE_ROOT) {
-    free_huffman_tree(HUFFMAN_TREE_ROOT);
-  }
 }
 
-#define MAX_HUFFMAN_CODE_LEN 30
-#define EOS                  0x3fffffff
-
 int64_t
 huffman_decode(char *dst_start, const uint8_t *src, uint32_t src_len)
 {
-  char    *dst_end   = dst_start;
-  uint8_t  shift     = 7;
-  Node    *current   = HUFFMAN_TREE_ROOT;
-  int      nbits     = 0;
-  uint32_t curr_bits = 0;
-
-  while (src_len) {
-    if (nbits > 0) {
-      curr_bits <<= 1;
-    }
-    if (*src & (1 << shift)) {
-      curr_bits |= 1;
-      current    = current->right;
-    } else {
-      current = current->left;
-    }
-    ++nbits;
+  char   *dst_end = dst_start;
+  uint8_t state   = 0;
+  uint8_t flags   = HUFFMAN_FLAG_ACCEPT;
 
-    if (current->leaf_node == true) {
-      if (curr_bits == EOS) {
-        return -1;
-      }
-      nbits     = 0;
-      curr_bits = 0;
-      *dst_end  = current->ascii_code;
-      ++dst_end;
-      current = HUFFMAN_TREE_ROOT;
-    }
-
-    if (shift) {
-      --shift;
-    } else {
-      shift = 7;
-      ++src;
-      --src_len;
-    }
+  for (const uint8_t *src_end = src + src_len; src < src_end; ++src) {
+    const huffman_decode_entry &hi = huffman_decode_table[state][*src >> 4];
+    const huffman_decode_entry &lo = huffman_decode_table[hi.state][*src & 0x0f];
 
-    if (nbits > MAX_HUFFMAN_CODE_LEN) {
+    if ((hi.flags | lo.flags) & HUFFMAN_FLAG_FAIL) {
       return -1;
     }
+    if (hi.flags & HUFFMAN_FLAG_SYM) {
+      *dst_end++ = hi.sym;
+    }
+    if (lo.flags & HUFFMAN_FLAG_SYM) {
+      *dst_end++ = lo.sym;
+    }
+    state = lo.state;
+    flags = lo.flags;
   }
 
-  if (nbits > 7) {
-    return -1;
-  }
-
-  // Padding bits must be a prefix of EOS
-  uint8_t mask = (1 << nbits) - 1;
-  if ((mask & curr_bits) != mask) {
+  // Padding bits must be at most 7 bits long, and a prefix of EOS
+  if (!(flags & HUFFMAN_FLAG_ACCEPT)) {
     return -1;
   }
 
@@ -444,37 +437,28 @@ int64_t
 huffman_encode(uint8_t *dst_start, const uint8_t *src, uint32_t src_len)
 {
   uint8_t *dst = dst_start;
-  // NOTE: The maximum length of Huffman Code is 30, thus using uint32_t as buffer.
-  uint32_t buf         = 0;
-  uint32_t remain_bits = 32;
+  // NOTE: The maximum length of Huffman Code is 30, thus a 64 bit accumulator can always take one more
+  // code while it holds less than 32 pending bits. Full 32 bit words are written out at a time.
+  uint64_t buf   = 0;
+  uint32_t nbits = 0;
 
   for (uint32_t i = 0; i < src_len; ++i) {
-    const uint32_t hex     = huffman_table[src[i]].code_as_hex;
-    const uint32_t bit_len = huffman_table[src[i]].bit_len;
-
-    if (remain_bits > bit_len) {
-      remain_bits  = remain_bits - bit_len;
-      buf         |= hex << remain_bits;
-    } else if (remain_bits == bit_len) {
-      buf         |= hex;
-      dst          = huffman_encode_append(dst, buf);
-      remain_bits  = 32;
-      buf          = 0;
-    } else {
-      buf         |= hex >> (bit_len - remain_bits);
-      dst          = huffman_encode_append(dst, buf);
-      remain_bits  = (32 - (bit_len - remain_bits));
-      buf          = hex << remain_bits;
+    const huffman_entry &code = huffman_table[src[i]];
+
+    buf    = (buf << code.bit_len) | code.code_as_hex;
+    nbits += code.bit_len;
+    if (nbits >= 32) {
+      nbits -= 32;
+      dst    = huffman_encode_append(dst, static_cast<uint32_t>(buf >> nbits));
     }
   }
 
-  dst = huffman_encode_append(dst, buf, remain_bits / 8);
-
   // NOTE: Add padding w/ EOS
-  uint32_t pad_len = remain_bits % 8;
-  if (pad_len) {
-    *(dst - 1) |= 0xff >> (8 - pad_len);
-  }
+  uint32_t pad_len = (8 - nbits % 8) % 8;
+
+  buf    = (buf << pad_len) | ((1 << pad_len) - 1);
+  nbits += pad_len;
+  dst    = huffman_encode_append(dst, static_cast<uint32_t>(buf << (32 - nbits)), (32 - nbits) / 8);
 
   return dst - dst_start;
 }
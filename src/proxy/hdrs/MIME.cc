@@ -29,6 +29,12 @@
 #include <cstring>
 #include <cctype>
 #include <algorithm>
+#include <bit>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 #include "proxy/hdrs/MIME.h"
 #include "proxy/hdrs/HdrHeap.h"
 #include "proxy/hdrs/HdrToken.h"
@@ -2341,6 +2347,101 @@ MIMEHdr::get_host_port_values(const char **host_ptr, ///< Pointer to host.
   return field;
 }
 
+/***********************************************************************
+ *                                                                     *
+ *                        S C A N N I N G                              *
+ *                                                                     *
+ ***********************************************************************/
+
+// Looking for line ends and checking characters is where most of the parse
+// time goes. These scans test a whole vector of characters at a time, 32 with
+// AVX2 or 16 with SSE2, and go one character at a time for the remainder or if
+// neither is available at compile time.
+
+namespace
+{
+#if defined(__AVX2__)
+constexpr ptrdiff_t MIME_SCAN_STRIDE = 32;
+
+inline uint32_t
+mime_scan_lf_or_nul_mask(const char *p)
+{
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(ParseRules::CHAR_LF)),
+                              _mm256_cmpeq_epi8(v, _mm256_setzero_si256()));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(m));
+}
+
+inline uint32_t
+mime_scan_control_mask(const char *p)
+{
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  // 0x00-0x1f is where min(v, 0x1f) == v, less HT, plus DEL.
+  __m256i low = _mm256_cmpeq_epi8(_mm256_min_epu8(v, _mm256_set1_epi8(0x1f)), v);
+  __m256i ht  = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(ParseRules::CHAR_HT));
+  __m256i del = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x7f));
+  return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(_mm256_andnot_si256(ht, low), del)));
+}
+#elif defined(__SSE2__)
+constexpr ptrdiff_t MIME_SCAN_STRIDE = 16;
+
+inline uint32_t
+mime_scan_lf_or_nul_mask(const char *p)
+{
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  __m128i m = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(ParseRules::CHAR_LF)), _mm_cmpeq_epi8(v, _mm_setzero_si128()));
+  return static_cast<uint32_t>(_mm_movemask_epi8(m));
+}
+
+inline uint32_t
+mime_scan_control_mask(const char *p)
+{
+  __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  // 0x00-0x1f is where min(v, 0x1f) == v, less HT, plus DEL.
+  __m128i low = _mm_cmpeq_epi8(_mm_min_epu8(v, _mm_set1_epi8(0x1f)), v);
+  __m128i ht  = _mm_cmpeq_epi8(v, _mm_set1_epi8(ParseRules::CHAR_HT));
+  __m128i del = _mm_cmpeq_epi8(v, _mm_set1_epi8(0x7f));
+  return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(_mm_andnot_si128(ht, low), del)));
+}
+#endif
+} // namespace
+
+const char *
+mime_scan_lf_or_nul(const char *s, const char *e)
+{
+#if defined(__AVX2__) || defined(__SSE2__)
+  for (; e - s >= MIME_SCAN_STRIDE; s += MIME_SCAN_STRIDE) {
+    if (uint32_t mask = mime_scan_lf_or_nul_mask(s); mask != 0) {
+      return s + std::countr_zero(mask);
+    }
+  }
+#endif
+  for (; s < e; ++s) {
+    if (*s == ParseRules::CHAR_LF || *s == '\0') {
+      return s;
+    }
+  }
+  return e;
+}
+
+const char *
+mime_scan_control(const char *s, const char *e)
+{
+#if defined(__AVX2__) || defined(__SSE2__)
+  for (; e - s >= MIME_SCAN_STRIDE; s += MIME_SCAN_STRIDE) {
+    if (uint32_t mask = mime_scan_control_mask(s); mask != 0) {
+      return s + std::countr_zero(mask);
+    }
+  }
+#endif
+  for (; s < e; ++s) {
+    if (ParseRules::is_control(*s)) {
+      return s;
+    }
+  }
+  return e;
+}
+
 /***********************************************************************
  *                                                                     *
  *                          P A R S E R                                *
@@ -2371,6 +2472,9 @@ MIMEScanner::get(TextView &input, TextView &output, bool &output_shares_input, b
   ParseResult zret = PARSE_RESULT_CONT;
   // Need this for handling dangling CR.
   static const char RAW_CR{ParseRules::CHAR_CR};
+  // Set if a null character is seen, which fails the parse. Only field text is
+  // consumed without looking at each character, so that's where this is set.
+  bool saw_nul = false;
 
   auto text = input;
   while (PARSE_RESULT_CONT == zret && !text.empty()) {
@@ -2407,9 +2511,14 @@ MIMEScanner::get(TextView &input, TextView &output, bool &output_shares_input, b
       }
       break;
     case MIME_PARSE_INSIDE: {
-      auto lf_off = text.find(ParseRules::CHAR_LF);
-      if (lf_off != TextView::npos) {
-        text.remove_prefix(lf_off + 1); // drop up to and including LF
+      // Find the end of the line, noting null characters on the way.
+      auto eol = mime_scan_lf_or_nul(text.data(), text.data_end());
+      while (eol != text.data_end() && *eol == '\0') {
+        saw_nul = true;
+        eol     = mime_scan_lf_or_nul(eol + 1, text.data_end());
+      }
+      if (eol != text.data_end()) {
+        text.remove_prefix(eol - text.data() + 1); // drop up to and including LF
         if (LINE == scan_type) {
           zret    = PARSE_RESULT_OK;
           m_state = MIME_PARSE_BEFORE;
@@ -2496,7 +2605,7 @@ MIMEScanner::get(TextView &input, TextView &output, bool &output_shares_input, b
   }
 
   // Make sure there are no null characters in the input scanned so far
-  if (zret != PARSE_RESULT_ERROR && TextView::npos != parsed_text.find('\0')) {
+  if (zret != PARSE_RESULT_ERROR && saw_nul) {
     zret = PARSE_RESULT_ERROR;
   }
 
@@ -2640,11 +2749,9 @@ mime_parser_parse(MIMEParser *parser, HdrHeap *heap, MIMEHdrImpl *mh, const char
     }
 
     // RFC 9110 Section 5.5. Field Values
-    for (char i : field_value) {
-      // FIXME: ParseRules::is_http_field_value() should be used but the implementation looks wrong
-      if (ParseRules::is_control(i)) {
-        return PARSE_RESULT_ERROR;
-      }
+    // FIXME: ParseRules::is_http_field_value() should be used but the implementation looks wrong
+    if (mime_scan_control(field_value.data(), field_value.data_end()) != field_value.data_end()) {
+      return PARSE_RESULT_ERROR;
     }
 
     ///////////////////////////////////////////
@@ -21,7 +21,10 @@
   limitations under the License.
  */
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <string_view>
 
 #include "catch.hpp"
 #include "tscore/ink_platform.h"
@@ -248,3 +251,36 @@ TEST_CASE("MimeParsers", "[proxy][mimeparsers]")
   std::printf("Date1: %" PRIdMAX "\n", d1);
   std::printf("Date2: %" PRIdMAX "\n", d2);
 }
+
+TEST_CASE("MimeScan", "[proxy][mimescan]")
+{
+  auto ref_lf_or_nul = [](const char *s, const char *e) -> const char * {
+    return std::find_if(s, e, [](char c) { return c == '\n' || c == '\0'; });
+  };
+  auto ref_control = [](const char *s, const char *e) -> const char * {
+    return std::find_if(s, e, [](char c) { return ParseRules::is_control(c) != 0; });
+  };
+
+  // Every byte value at every position of buffers around the vector widths,
+  // from unaligned starts, against the one character at a time definition.
+  char buf[80];
+  for (int len = 0; len <= 70; ++len) {
+    for (int offset = 0; offset < 3; ++offset) {
+      const char *s = buf + offset;
+      const char *e = s + len;
+      for (int pos = 0; pos < len; pos += 7) {
+        for (int c = 0; c < 256; ++c) {
+          memset(buf, 'a', sizeof(buf));
+          buf[offset + pos] = static_cast<char>(c);
+          REQUIRE(mime_scan_lf_or_nul(s, e) == ref_lf_or_nul(s, e));
+          REQUIRE(mime_scan_control(s, e) == ref_control(s, e));
+        }
+      }
+    }
+  }
+
+  std::string_view line{"Accept-Encoding: gzip, deflate, br, zstd, some-other-long-coding\r\nHost: x\r\n"};
+  CHECK(mime_scan_lf_or_nul(line.data(), line.data() + line.size()) == line.data() + line.find('\n'));
+  CHECK(mime_scan_control(line.data(), line.data() + line.size()) == line.data() + line.find('\r'));
+  CHECK(mime_scan_control(line.data(), line.data() + line.find('\r')) == line.data() + line.find('\r'));
+}
@@ -175,6 +175,7 @@ static const ConfigEnumPair<TSServerSessionSharingPoolType> SessionSharingPoolSt
   {TS_SERVER_SESSION_SHARING_POOL_THREAD,        "thread"       },
   {TS_SERVER_SESSION_SHARING_POOL_HYBRID,        "hybrid"       },
   {TS_SERVER_SESSION_SHARING_POOL_GLOBAL_LOCKED, "global_locked"},
+  {TS_SERVER_SESSION_SHARING_POOL_THREAD_STEAL,  "thread_steal" },
 };
 
 int              HttpConfig::m_id = 0;
@@ -452,6 +453,9 @@ register_stat_callbacks()
   http_rsb.server_first_connect_time         = Metrics::Counter::createPtr("proxy.process.http.milestone.server_first_connect");
   http_rsb.server_first_read_time            = Metrics::Counter::createPtr("proxy.process.http.milestone.server_first_read");
   http_rsb.server_read_header_done_time      = Metrics::Counter::createPtr("proxy.process.http.milestone.server_read_header_done");
+  http_rsb.server_session_pool_global_hits   = Metrics::Counter::createPtr("proxy.process.http.server_session_pool.global_hits");
+  http_rsb.server_session_pool_steal_hits    = Metrics::Counter::createPtr("proxy.process.http.server_session_pool.steal_hits");
+  http_rsb.server_session_pool_thread_hits   = Metrics::Counter::createPtr("proxy.process.http.server_session_pool.thread_hits");
   http_rsb.sm_finish_time                    = Metrics::Counter::createPtr("proxy.process.http.milestone.sm_finish");
   http_rsb.sm_start_time                     = Metrics::Counter::createPtr("proxy.process.http.milestone.sm_start");
   http_rsb.tcp_client_refresh_count          = Metrics::Counter::createPtr("proxy.process.http.tcp_client_refresh_count");
@@ -977,6 +981,7 @@ HttpConfig::startup()
 
   HttpEstablishStaticConfigByte(c.send_100_continue_response, "proxy.config.http.send_100_continue_response");
   HttpEstablishStaticConfigByte(c.disallow_post_100_continue, "proxy.config.http.disallow_post_100_continue");
+  HttpEstablishStaticConfigByte(c.tunnel_splice, "proxy.config.http.tunnel_splice");
 
   HttpEstablishStaticConfigByte(c.oride.cache_open_write_fail_action, "proxy.config.http.cache.open_write_fail_action");
 
@@ -1270,6 +1275,7 @@ HttpConfig::reconfigure()
 
   params->send_100_continue_response = INT_TO_BOOL(m_master.send_100_continue_response);
   params->disallow_post_100_continue = INT_TO_BOOL(m_master.disallow_post_100_continue);
+  params->tunnel_splice              = INT_TO_BOOL(m_master.tunnel_splice);
 
   params->oride.cache_open_write_fail_action = m_master.oride.cache_open_write_fail_action;
   if (params->oride.cache_open_write_fail_action == CACHE_WL_FAIL_ACTION_READ_RETRY) {
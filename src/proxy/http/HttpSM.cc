@@ -1649,6 +1649,7 @@ HttpSM::handle_api_return()
       HttpTunnelProducer *p = setup_server_transfer();
       perform_cache_write_action();
       tunnel.tunnel_run(p);
+      setup_tunnel_splice(p);
     }
     break;
   }
@@ -7367,6 +7368,11 @@ HttpSM::setup_blind_tunnel(bool send_response_hdr, IOBufferReader *initial)
 
   tunnel.tunnel_run();
 
+  if (this->transform_info.vc == nullptr && this->post_transform_info.vc == nullptr) {
+    setup_tunnel_splice(p_os);
+    setup_tunnel_splice(p_ua);
+  }
+
   // If we're half closed, we got a FIN from the client. Forward it on to the origin server
   // now that we have the tunnel operational.
   if (_ua.get_txn() && _ua.get_txn()->get_half_close_flag()) {
@@ -7374,6 +7380,39 @@ HttpSM::setup_blind_tunnel(bool send_response_hdr, IOBufferReader *initial)
   }
 }
 
+// Hand the rest of the transfer from producer @a p to its consumer over to the kernel if both ends are
+// plain sockets. This only applies when the data is passed through untouched to a single consumer, the
+// tunnel keeps running as before and sees the progress through the VIOs of the two connections.
+void
+HttpSM::setup_tunnel_splice(HttpTunnelProducer *p)
+{
+  if (!t_state.http_config_param->tunnel_splice || !p->alive || p->num_consumers != 1 || p->do_chunking || p->do_dechunking ||
+      p->do_chunked_passthru) {
+    return;
+  }
+
+  HttpTunnelConsumer *c = p->consumer_list.head;
+  if (!c->alive || p->read_vio == nullptr || c->write_vio == nullptr) {
+    return;
+  }
+
+  auto netvc_of = [this](VConnection *vc) -> NetVConnection * {
+    if (server_entry && vc == server_entry->vc && server_txn) {
+      return server_txn->get_netvc();
+    }
+    if (_ua.get_entry() && vc == _ua.get_entry()->vc && _ua.get_txn()) {
+      return _ua.get_txn()->get_netvc();
+    }
+    return nullptr;
+  };
+
+  NetVConnection *from = netvc_of(p->vc);
+  NetVConnection *to   = netvc_of(c->vc);
+  if (from != nullptr && to != nullptr && from->splice_to(p->read_vio, to, c->write_vio)) {
+    SMDbg(dbg_ctl_http_tunnel, "splicing %s to %s", p->name, c->name);
+  }
+}
+
 void
 HttpSM::setup_client_response_plugin_agents(HttpTunnelProducer *p, int num_header_bytes)
 {
@@ -68,6 +68,10 @@ ServerSessionPool::purge()
   m_ip_pool.apply([](PoolableSession *ssn) -> void { ssn->do_io_close(); });
   m_ip_pool.clear();
   m_fqdn_pool.clear();
+  for (int i = 0; i < PROBE_BUCKETS; ++i) {
+    m_ip_probe[i].store(0, std::memory_order_relaxed);
+    m_fqdn_probe[i].store(0, std::memory_order_relaxed);
+  }
 }
 
 bool
@@ -84,6 +88,17 @@ ServerSessionPool::match(PoolableSession *ss, sockaddr const *addr, CryptoHash c
   return retval;
 }
 
+bool
+ServerSessionPool::may_match(sockaddr const *addr, CryptoHash const &host_hash, TSServerSessionSharingMatchMask match_style) const
+{
+  if ((TS_SERVER_SESSION_SHARING_MATCH_MASK_HOSTONLY & match_style) && !(TS_SERVER_SESSION_SHARING_MATCH_MASK_IP & match_style)) {
+    return m_fqdn_probe[PoolableSession::FQDNLinkage::hash_of(host_hash) % PROBE_BUCKETS].load(std::memory_order_relaxed) > 0;
+  } else if (TS_SERVER_SESSION_SHARING_MATCH_MASK_IP & match_style) {
+    return m_ip_probe[PoolableSession::IPLinkage::hash_of(addr) % PROBE_BUCKETS].load(std::memory_order_relaxed) > 0;
+  }
+  return false;
+}
+
 bool
 ServerSessionPool::validate_host_sni(HttpSM *sm, NetVConnection *netvc)
 {
@@ -395,7 +410,8 @@ HttpSessionManager::acquire_session(HttpSM *sm, sockaddr const *ip, const char *
 
   // Otherwise, check the thread pool first
   if (this->get_pool_type() == TS_SERVER_SESSION_SHARING_POOL_THREAD ||
-      this->get_pool_type() == TS_SERVER_SESSION_SHARING_POOL_HYBRID) {
+      this->get_pool_type() == TS_SERVER_SESSION_SHARING_POOL_HYBRID ||
+      this->get_pool_type() == TS_SERVER_SESSION_SHARING_POOL_THREAD_STEAL) {
     retval = _acquire_session(ip, hostname_hash, sm, match_style, TS_SERVER_SESSION_SHARING_POOL_THREAD);
   }
 
@@ -404,8 +420,11 @@ HttpSessionManager::acquire_session(HttpSM *sm, sockaddr const *ip, const char *
     if (TS_SERVER_SESSION_SHARING_POOL_GLOBAL == this->get_pool_type() ||
         TS_SERVER_SESSION_SHARING_POOL_HYBRID == this->get_pool_type()) {
       retval = _acquire_session(ip, hostname_hash, sm, match_style, TS_SERVER_SESSION_SHARING_POOL_GLOBAL);
-    } else if (TS_SERVER_SESSION_SHARING_POOL_GLOBAL_LOCKED == this->get_pool_type())
+    } else if (TS_SERVER_SESSION_SHARING_POOL_GLOBAL_LOCKED == this->get_pool_type()) {
       retval = _acquire_session(ip, hostname_hash, sm, match_style, TS_SERVER_SESSION_SHARING_POOL_GLOBAL_LOCKED);
+    } else if (TS_SERVER_SESSION_SHARING_POOL_THREAD_STEAL == this->get_pool_type()) {
+      retval = _steal_session(ip, hostname_hash, sm, match_style);
+    }
   }
 
   return retval;
@@ -468,31 +487,9 @@ HttpSessionManager::_acquire_session(sockaddr const *ip, CryptoHash const &hostn
         // At this point to_return has been removed from the pool. Do we need to move it
         // to the same thread?
         if (to_return) {
-          UnixNetVConnection *server_vc = dynamic_cast<UnixNetVConnection *>(to_return->get_netvc());
-          if (server_vc) {
-            // Disable i/o on this vc now, but, hold onto the g_pool cont
-            // and the mutex to stop any stray events from getting in
-            server_vc->do_io_read(m_g_pool, 0, nullptr);
-            server_vc->do_io_write(m_g_pool, 0, nullptr);
-            UnixNetVConnection *new_vc = server_vc->migrateToCurrentThread(sm, ethread);
-            // The VC moved, free up the original one
-            if (new_vc != server_vc) {
-              ink_assert(new_vc == nullptr || new_vc->nh != nullptr);
-              if (!new_vc) {
-                // Close out to_return, we were't able to get a connection
-                Metrics::Counter::increment(http_rsb.origin_shutdown_migration_failure);
-                to_return->do_io_close();
-                to_return = nullptr;
-                retval    = HSM_NOT_FOUND;
-              } else {
-                // Keep things from timing out on us
-                new_vc->set_inactivity_timeout(new_vc->get_inactivity_timeout());
-                to_return->set_netvc(new_vc);
-              }
-            } else {
-              // Keep things from timing out on us
-              server_vc->set_inactivity_timeout(server_vc->get_inactivity_timeout());
-            }
+          to_return = _migrate_session(to_return, m_g_pool, sm, ethread);
+          if (!to_return) {
+            retval = HSM_NOT_FOUND;
           }
         }
       }
@@ -505,6 +502,8 @@ HttpSessionManager::_acquire_session(sockaddr const *ip, CryptoHash const &hostn
         Dbg(dbg_ctl_http_ss, "[%" PRId64 "] [acquire session] return session from shared pool", to_return->connection_id());
         to_return->state = PoolableSession::SSN_IN_USE;
         retval           = HSM_DONE;
+        Metrics::Counter::increment(TS_SERVER_SESSION_SHARING_POOL_THREAD == pool_type ? http_rsb.server_session_pool_thread_hits :
+                                                                                         http_rsb.server_session_pool_global_hits);
       } else {
         Dbg(dbg_ctl_http_ss, "[%" PRId64 "] [acquire session] failed to get transaction on session from shared pool",
             to_return->connection_id());
@@ -524,13 +523,103 @@ HttpSessionManager::_acquire_session(sockaddr const *ip, CryptoHash const &hostn
   return retval;
 }
 
+// Take a session from the pool of another thread and move it to this thread. The pools are probed
+// without their locks first, and a pool that is busy is skipped rather than waited for.
+HSMresult_t
+HttpSessionManager::_steal_session(sockaddr const *ip, CryptoHash const &hostname_hash, HttpSM *sm,
+                                   TSServerSessionSharingMatchMask match_style)
+{
+  EThread *ethread = this_ethread();
+  auto     threads = eventProcessor.active_group_threads(ET_NET);
+  int      n       = threads.end() - threads.begin();
+
+  // Start after this thread so the threads do not all probe the same pool first.
+  for (int i = 1; i <= n; ++i) {
+    EThread           *t    = threads.begin()[(ethread->id + i) % n];
+    ServerSessionPool *pool = t->server_session_pool;
+    if (t == ethread || pool == nullptr || !pool->may_match(ip, hostname_hash, match_style)) {
+      continue;
+    }
+
+    MUTEX_TRY_LOCK(lock, pool->mutex, ethread);
+    if (!lock.is_locked()) {
+      continue;
+    }
+
+    PoolableSession *to_return = nullptr;
+    if (pool->acquireSession(ip, hostname_hash, match_style, sm, to_return) != HSM_DONE) {
+      continue;
+    }
+    // A multiplexed session stays in its pool and is shared on its own thread.
+    if (to_return->is_multiplexing()) {
+      continue;
+    }
+    Metrics::Gauge::decrement(http_rsb.pooled_server_connections);
+    Dbg(dbg_ctl_http_ss, "[%" PRId64 "] [acquire session] taking session from the pool of thread %d", to_return->connection_id(),
+        t->id);
+
+    to_return = _migrate_session(to_return, pool, sm, ethread);
+    if (!to_return) {
+      continue;
+    }
+    if (sm->create_server_txn(to_return)) {
+      to_return->state = PoolableSession::SSN_IN_USE;
+      Metrics::Counter::increment(http_rsb.server_session_pool_steal_hits);
+      return HSM_DONE;
+    }
+    Dbg(dbg_ctl_http_ss, "[%" PRId64 "] [acquire session] failed to get transaction on session from thread pool",
+        to_return->connection_id());
+    to_return->do_io_close();
+    return HSM_RETRY;
+  }
+
+  return HSM_NOT_FOUND;
+}
+
+// Move a session taken from the global pool or the pool of another thread to this thread.
+// Returns @c nullptr if the connection could not be moved, the session is closed then.
+PoolableSession *
+HttpSessionManager::_migrate_session(PoolableSession *ssn, ServerSessionPool *pool, HttpSM *sm, EThread *ethread)
+{
+  UnixNetVConnection *server_vc = dynamic_cast<UnixNetVConnection *>(ssn->get_netvc());
+  if (server_vc) {
+    // Disable i/o on this vc now, but, hold onto the pool cont
+    // and the mutex to stop any stray events from getting in
+    server_vc->do_io_read(pool, 0, nullptr);
+    server_vc->do_io_write(pool, 0, nullptr);
+    UnixNetVConnection *new_vc = server_vc->migrateToCurrentThread(sm, ethread);
+    // The VC moved, free up the original one
+    if (new_vc != server_vc) {
+      ink_assert(new_vc == nullptr || new_vc->nh != nullptr);
+      if (!new_vc) {
+        // Close out the session, we were't able to get a connection
+        Metrics::Counter::increment(http_rsb.origin_shutdown_migration_failure);
+        ssn->do_io_close();
+        return nullptr;
+      }
+      // Keep things from timing out on us
+      new_vc->set_inactivity_timeout(new_vc->get_inactivity_timeout());
+      ssn->set_netvc(new_vc);
+    } else {
+      // Keep things from timing out on us
+      server_vc->set_inactivity_timeout(server_vc->get_inactivity_timeout());
+    }
+  }
+  return ssn;
+}
+
 HSMresult_t
 HttpSessionManager::release_session(PoolableSession *to_release)
 {
-  EThread           *ethread = this_ethread();
-  ServerSessionPool *pool =
-    TS_SERVER_SESSION_SHARING_POOL_THREAD == to_release->sharing_pool ? ethread->server_session_pool : m_g_pool;
-  bool released_p = true;
+  EThread           *ethread    = this_ethread();
+  ServerSessionPool *pool       = m_g_pool;
+  bool               released_p = true;
+
+  // A thread steal pool releases to the thread pool, other threads take its sessions from there.
+  if (TS_SERVER_SESSION_SHARING_POOL_THREAD == to_release->sharing_pool ||
+      TS_SERVER_SESSION_SHARING_POOL_THREAD_STEAL == to_release->sharing_pool) {
+    pool = ethread->server_session_pool;
+  }
 
   // The per thread lock looks like it should not be needed but if it's not locked the close checking I/O op will crash.
 
@@ -572,6 +661,9 @@ ServerSessionPool::removeSession(PoolableSession *to_remove)
   }
   m_fqdn_pool.erase(to_remove);
   m_ip_pool.erase(to_remove);
+  m_ip_probe[PoolableSession::IPLinkage::hash_of(to_remove->get_remote_addr()) % PROBE_BUCKETS].fetch_sub(1, std::memory_order_relaxed);
+  m_fqdn_probe[PoolableSession::FQDNLinkage::hash_of(to_remove->hostname_hash) % PROBE_BUCKETS].fetch_sub(1,
+                                                                                                          std::memory_order_relaxed);
   if (dbg_ctl_http_ss.on()) {
     Dbg(dbg_ctl_http_ss, "After Remove session %p m_fqdn_pool size=%zu m_ip_pool_size=%zu", to_remove, m_fqdn_pool.count(),
         m_ip_pool.count());
@@ -586,6 +678,8 @@ ServerSessionPool::addSession(PoolableSession *ss)
   // put it in the pools.
   m_ip_pool.insert(ss);
   m_fqdn_pool.insert(ss);
+  m_ip_probe[PoolableSession::IPLinkage::hash_of(ss->get_remote_addr()) % PROBE_BUCKETS].fetch_add(1, std::memory_order_relaxed);
+  m_fqdn_probe[PoolableSession::FQDNLinkage::hash_of(ss->hostname_hash) % PROBE_BUCKETS].fetch_add(1, std::memory_order_relaxed);
 
   if (dbg_ctl_http_ss.on()) {
     char peer_ip[INET6_ADDRPORTSTRLEN];
@@ -41,6 +41,10 @@ constexpr std::string_view hash_url_request = "request";
 constexpr std::string_view hash_url_cache   = "cache";
 constexpr std::string_view hash_url_parent  = "parent";
 
+// hash_algorithm strings
+constexpr std::string_view hash_algorithm_ring   = "ring";
+constexpr std::string_view hash_algorithm_maglev = "maglev";
+
 static bool
 isWrapped(std::vector<bool> &wrap_around, uint32_t groups)
 {
@@ -140,9 +144,26 @@ NextHopConsistentHash::NextHopConsistentHash(const std::string_view name, const
                                 "', this strategy will be ignored.");
   }
 
+  try {
+    if (n["hash_algorithm"]) {
+      auto hash_algorithm_val = n["hash_algorithm"].Scalar();
+      if (hash_algorithm_val == hash_algorithm_ring) {
+        hash_algorithm = ATSConsistentHash::Algorithm::RING;
+      } else if (hash_algorithm_val == hash_algorithm_maglev) {
+        hash_algorithm = ATSConsistentHash::Algorithm::MAGLEV;
+      } else {
+        NH_Note("Invalid 'hash_algorithm' value, '%s', for the strategy named '%s', using default '%s'.",
+                hash_algorithm_val.c_str(), strategy_name.c_str(), hash_algorithm_ring.data());
+      }
+    }
+  } catch (std::exception &ex) {
+    throw std::invalid_argument("Error parsing the strategy named '" + strategy_name + "' due to '" + ex.what() +
+                                "', this strategy will be ignored.");
+  }
+
   // load up the hash rings.
   for (uint32_t i = 0; i < groups; i++) {
-    std::shared_ptr<ATSConsistentHash> hash_ring = std::make_shared<ATSConsistentHash>();
+    std::shared_ptr<ATSConsistentHash> hash_ring = std::make_shared<ATSConsistentHash>(1024, nullptr, hash_algorithm);
     for (uint32_t j = 0; j < host_groups[i].size(); j++) {
       // ATSConsistentHash needs the raw pointer.
       HostRecord *p = host_groups[i][j].get();
@@ -853,9 +853,42 @@ UrlRewrite::BuildTable(const char *path)
     forward_mappings_with_recv_port.hash_lookup.reset(nullptr);
   }
 
+  _buildRegexIndex(forward_mappings);
+  _buildRegexIndex(reverse_mappings);
+  _buildRegexIndex(permanent_redirects);
+  _buildRegexIndex(temporary_redirects);
+  _buildRegexIndex(forward_mappings_with_recv_port);
+
   return TS_SUCCESS;
 }
 
+/**
+  Builds the literal prefilter of the regex mappings of @a store, so a
+  lookup only evaluates the host regexes that can possibly match.  The
+  patterns were compiled from the lower cased host of fromURL.
+*/
+void
+UrlRewrite::_buildRegexIndex(MappingsStore &store)
+{
+  store.regex_index = RegexSet();
+  store.regex_by_index.clear();
+
+  forl_LL(RegexMapping, list_iter, store.regex_list)
+  {
+    int         host_len;
+    const char *host = list_iter->url_map->fromURL.host_get(&host_len);
+
+    store.regex_index.add_prefilter(std::string_view(host, host_len));
+    store.regex_by_index.push_back(list_iter);
+  }
+  store.regex_index.finalize();
+
+  if (!store.regex_by_index.empty()) {
+    Dbg(dbg_ctl_url_rewrite_regex, "Indexed %zu regex mappings, %d with a required literal", store.regex_by_index.size(),
+        store.regex_index.literal_count());
+  }
+}
+
 /**
   Inserts arg mapping in h_table with key src_host chaining the mapping
   of existing entries bound to src_host if necessary.
@@ -927,7 +960,7 @@ UrlRewrite::_mappingLookup(MappingsStore &mappings, URL *request_url, int reques
     mapping_container.set(mapping);
     retval = true;
   }
-  if (_regexMappingLookup(mappings.regex_list, request_url, request_port, request_host_lower, request_host_len, rank_ceiling,
+  if (_regexMappingLookup(mappings, request_url, request_port, request_host_lower, request_host_len, rank_ceiling,
                           mapping_container)) {
     Dbg(dbg_ctl_url_rewrite, "Using regex mapping with rank %d", (mapping_container.getMapping())->getRank());
     retval = true;
@@ -987,7 +1020,7 @@ lOverFlow:
 }
 
 bool
-UrlRewrite::_regexMappingLookup(RegexMappingList &regex_mappings, URL *request_url, int request_port, const char *request_host,
+UrlRewrite::_regexMappingLookup(MappingsStore &mappings, URL *request_url, int request_port, const char *request_host,
                                 int request_host_len, int rank_ceiling, UrlMappingContainer &mapping_container)
 {
   bool         retval = false;
@@ -1013,19 +1046,19 @@ UrlRewrite::_regexMappingLookup(RegexMappingList &regex_mappings, URL *request_u
     request_scheme_len = hdrtoken_wks_to_length(request_scheme);
   }
 
-  // Loop over the entire linked list, or until we're satisfied
-  forl_LL(RegexMapping, list_iter, regex_mappings)
-  {
-    int reg_map_rank = list_iter->url_map->getRank();
+  // Walk the candidates of the literal prefilter in rank order, until we're satisfied
+  mappings.regex_index.candidates(std::string_view(request_host, request_host_len), [&](int32_t idx) {
+    RegexMapping *list_iter    = mappings.regex_by_index[idx];
+    int           reg_map_rank = list_iter->url_map->getRank();
 
     if (reg_map_rank > rank_ceiling) {
-      break;
+      return true;
     }
 
     reg_map_scheme = list_iter->url_map->fromURL.scheme_get(&reg_map_scheme_len);
     if ((request_scheme_len != reg_map_scheme_len) || strncmp(request_scheme, reg_map_scheme, request_scheme_len)) {
       Dbg(dbg_ctl_url_rewrite_regex, "Skipping regex with rank %d as scheme does not match request scheme", reg_map_rank);
-      continue;
+      return false;
     }
 
     if (list_iter->url_map->fromURL.port_get() != request_port) {
@@ -1033,14 +1066,14 @@ UrlRewrite::_regexMappingLookup(RegexMappingList &regex_mappings, URL *request_u
           "Skipping regex with rank %d as regex map port does not match request port. "
           "regex map port: %d, request port %d",
           reg_map_rank, list_iter->url_map->fromURL.port_get(), request_port);
-      continue;
+      return false;
     }
 
     reg_map_path = list_iter->url_map->fromURL.path_get(&reg_map_path_len);
     if ((request_path_len < reg_map_path_len) ||
         strncmp(reg_map_path, request_path, reg_map_path_len)) { // use the shorter path length here
       Dbg(dbg_ctl_url_rewrite_regex, "Skipping regex with rank %d as path does not cover request path", reg_map_rank);
-      continue;
+      return false;
     }
 
     int match_result = list_iter->regular_expression.exec(std::string_view(request_host, request_host_len), matches);
@@ -1065,12 +1098,13 @@ UrlRewrite::_regexMappingLookup(RegexMappingList &regex_mappings, URL *request_u
 
       Dbg(dbg_ctl_url_rewrite_regex, "Expanded toURL to [%.*s]", expanded_url->length_get(), expanded_url->string_get_ref());
       retval = true;
-      break;
+      return true;
     } else {
       Dbg(dbg_ctl_url_rewrite_regex, "Request URL host [%.*s] did NOT match regex in mapping of rank %d", request_host_len,
           request_host, reg_map_rank);
     }
-  }
+    return false;
+  });
 
   return retval;
 }
@@ -50,7 +50,7 @@ static VersionConverter hvc;
 // Statistics
 Http2StatsBlock http2_rsb;
 
-Metrics::Counter::AtomicType *http2_frame_metrics_in[HTTP2_FRAME_TYPE_MAX + 1];
+Metrics::ShardedCounter::AtomicType *http2_frame_metrics_in[HTTP2_FRAME_TYPE_MAX + 1];
 
 union byte_pointer {
   byte_pointer(void *p) : ptr(p) {}
@@ -502,6 +502,7 @@ uint32_t Http2::write_buffer_block_size            = 262144;
 int64_t  Http2::write_buffer_block_size_index      = BUFFER_SIZE_INDEX_256K;
 float    Http2::write_size_threshold               = 0.5;
 uint32_t Http2::write_time_threshold               = 100;
+uint32_t Http2::write_reference_threshold          = 0;
 uint32_t Http2::buffer_water_mark                  = 0;
 
 void
@@ -560,6 +561,7 @@ Http2::init()
   REC_EstablishStaticConfigInt32U(write_buffer_block_size, "proxy.config.http2.write_buffer_block_size");
   REC_EstablishStaticConfigFloat(write_size_threshold, "proxy.config.http2.write_size_threshold");
   REC_EstablishStaticConfigInt32U(write_time_threshold, "proxy.config.http2.write_time_threshold");
+  REC_EstablishStaticConfigInt32U(write_reference_threshold, "proxy.config.http2.write_reference_threshold");
   REC_EstablishStaticConfigInt32U(buffer_water_mark, "proxy.config.http2.default_buffer_water_mark");
 
   write_buffer_block_size_index = iobuffer_size_to_index(Http2::write_buffer_block_size, MAX_BUFFER_SIZE_INDEX);
@@ -616,17 +618,17 @@ Http2::init()
     Metrics::Counter::createPtr("proxy.process.http2.max_concurrent_streams_exceeded_in");
   http2_rsb.max_concurrent_streams_exceeded_out =
     Metrics::Counter::createPtr("proxy.process.http2.max_concurrent_streams_exceeded_out");
-  http2_rsb.data_frames_in          = Metrics::Counter::createPtr("proxy.process.http2.data_frames_in"),
-  http2_rsb.headers_frames_in       = Metrics::Counter::createPtr("proxy.process.http2.headers_frames_in"),
-  http2_rsb.priority_frames_in      = Metrics::Counter::createPtr("proxy.process.http2.priority_frames_in"),
-  http2_rsb.rst_stream_frames_in    = Metrics::Counter::createPtr("proxy.process.http2.rst_stream_frames_in"),
-  http2_rsb.settings_frames_in      = Metrics::Counter::createPtr("proxy.process.http2.settings_frames_in"),
-  http2_rsb.push_promise_frames_in  = Metrics::Counter::createPtr("proxy.process.http2.push_promise_frames_in"),
-  http2_rsb.ping_frames_in          = Metrics::Counter::createPtr("proxy.process.http2.ping_frames_in"),
-  http2_rsb.goaway_frames_in        = Metrics::Counter::createPtr("proxy.process.http2.goaway_frames_in"),
-  http2_rsb.window_update_frames_in = Metrics::Counter::createPtr("proxy.process.http2.window_update_frames_in"),
-  http2_rsb.continuation_frames_in  = Metrics::Counter::createPtr("proxy.process.http2.continuation_frames_in"),
-  http2_rsb.unknown_frames_in       = Metrics::Counter::createPtr("proxy.process.http2.unknown_frames_in"),
+  http2_rsb.data_frames_in          = Metrics::ShardedCounter::createPtr("proxy.process.http2.data_frames_in"),
+  http2_rsb.headers_frames_in       = Metrics::ShardedCounter::createPtr("proxy.process.http2.headers_frames_in"),
+  http2_rsb.priority_frames_in      = Metrics::ShardedCounter::createPtr("proxy.process.http2.priority_frames_in"),
+  http2_rsb.rst_stream_frames_in    = Metrics::ShardedCounter::createPtr("proxy.process.http2.rst_stream_frames_in"),
+  http2_rsb.settings_frames_in      = Metrics::ShardedCounter::createPtr("proxy.process.http2.settings_frames_in"),
+  http2_rsb.push_promise_frames_in  = Metrics::ShardedCounter::createPtr("proxy.process.http2.push_promise_frames_in"),
+  http2_rsb.ping_frames_in          = Metrics::ShardedCounter::createPtr("proxy.process.http2.ping_frames_in"),
+  http2_rsb.goaway_frames_in        = Metrics::ShardedCounter::createPtr("proxy.process.http2.goaway_frames_in"),
+  http2_rsb.window_update_frames_in = Metrics::ShardedCounter::createPtr("proxy.process.http2.window_update_frames_in"),
+  http2_rsb.continuation_frames_in  = Metrics::ShardedCounter::createPtr("proxy.process.http2.continuation_frames_in"),
+  http2_rsb.unknown_frames_in       = Metrics::ShardedCounter::createPtr("proxy.process.http2.unknown_frames_in"),
 
   http2_frame_metrics_in[0]  = http2_rsb.data_frames_in;
   http2_frame_metrics_in[1]  = http2_rsb.headers_frames_in;
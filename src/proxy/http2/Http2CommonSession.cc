@@ -181,6 +181,10 @@ Http2CommonSession::xmit(const Http2TxFrame &frame, bool flush)
 void
 Http2CommonSession::flush()
 {
+  if (this->_write_batch_depth > 0) {
+    this->_write_batch_flush = true;
+    return;
+  }
   this->connection_state.cancel_retransmit();
   if (this->_pending_sending_data_size > 0) {
     this->_pending_sending_data_size = 0;
@@ -189,6 +193,24 @@ Http2CommonSession::flush()
   }
 }
 
+Http2CommonSession::WriteBatch::WriteBatch(Http2CommonSession *ssn) : _ssn(ssn)
+{
+  if (_ssn) {
+    ++_ssn->_write_batch_depth;
+  }
+}
+
+Http2CommonSession::WriteBatch::~WriteBatch()
+{
+  if (_ssn && --_ssn->_write_batch_depth == 0 && _ssn->_write_batch_flush) {
+    _ssn->_write_batch_flush = false;
+    // The connection may have been closed by the frames of the batch.
+    if (_ssn->get_netvc() != nullptr) {
+      _ssn->flush();
+    }
+  }
+}
+
 int
 Http2CommonSession::state_read_connection_preface(int event, void *edata)
 {
@@ -356,6 +378,9 @@ Http2CommonSession::do_process_frame_read(int /* event ATS_UNUSED */, VIO *vio,
 {
   Http2SsnDebug("do_process_frame_read %" PRId64 " bytes ready", this->_read_buffer_reader->read_avail());
 
+  // Acks and responses to the frames read here go out together
+  WriteBatch batch(this);
+
   if (inside_frame) {
     do_complete_frame_read();
   }
@@ -492,7 +517,7 @@ Http2CommonSession::_count_received_frames(uint32_t type)
     type = HTTP2_FRAME_TYPE_MAX;
   }
   // Global counter
-  Metrics::Counter::increment(http2_frame_metrics_in[type]);
+  Metrics::ShardedCounter::increment(http2_frame_metrics_in[type]);
   // Local counter
   this->_frame_counts_in[type]++;
 }
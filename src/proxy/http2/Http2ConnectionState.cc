@@ -417,7 +417,7 @@ Http2ConnectionState::rcv_headers_frame(const Http2Frame &frame)
     header_block_fragment_length -= HTTP2_PRIORITY_LEN;
   }
 
-  if (new_stream && Http2::stream_priority_enabled) {
+  if (new_stream && Http2::stream_priority_enabled == HTTP2_STREAM_PRIORITY_RFC7540) {
     Http2DependencyTree::Node *node = this->dependency_tree->find(stream_id);
     if (node != nullptr) {
       stream->priority_node = node;
@@ -503,6 +503,9 @@ Http2ConnectionState::rcv_headers_frame(const Http2Frame &frame)
 
     // Set up the State Machine
     if (!stream->is_outbound_connection() && !stream->trailing_header_is_possible()) {
+      if (Http2::stream_priority_enabled == HTTP2_STREAM_PRIORITY_RFC9218) {
+        stream->set_priority_from_headers();
+      }
       SCOPED_MUTEX_LOCK(stream_lock, stream->mutex, this_ethread());
       stream->mark_milestone(Http2StreamMilestone::START_TXN);
       stream->cancel_active_timeout();
@@ -577,7 +580,8 @@ Http2ConnectionState::rcv_priority_frame(const Http2Frame &frame)
                       "PRIORITY frame depends on itself");
   }
 
-  if (!Http2::stream_priority_enabled) {
+  // PRIORITY frames are ignored unless the dependency tree is used.
+  if (Http2::stream_priority_enabled != HTTP2_STREAM_PRIORITY_RFC7540) {
     return Http2Error(Http2ErrorClass::HTTP2_ERROR_CLASS_NONE);
   }
 
@@ -1114,6 +1118,9 @@ Http2ConnectionState::rcv_continuation_frame(const Http2Frame &frame)
     }
 
     // Set up the State Machine
+    if (Http2::stream_priority_enabled == HTTP2_STREAM_PRIORITY_RFC9218 && !stream->is_outbound_connection()) {
+      stream->set_priority_from_headers();
+    }
     SCOPED_MUTEX_LOCK(stream_lock, stream->mutex, this_ethread());
     stream->mark_milestone(Http2StreamMilestone::START_TXN);
     // This should be fine, need to verify whether we need to replace this with the
@@ -1288,7 +1295,7 @@ Http2ConnectionState::init(Http2CommonSession *ssn)
 
   local_hpack_handle = new HpackHandle(HTTP2_HEADER_TABLE_SIZE);
   peer_hpack_handle  = new HpackHandle(HTTP2_HEADER_TABLE_SIZE);
-  if (Http2::stream_priority_enabled) {
+  if (Http2::stream_priority_enabled == HTTP2_STREAM_PRIORITY_RFC7540) {
     dependency_tree = new DependencyTree(this->_get_configured_max_concurrent_streams());
   }
 
@@ -1532,7 +1539,12 @@ Http2ConnectionState::main_event_handler(int event, void *edata)
   case HTTP2_SESSION_EVENT_PRIO: {
     REMEMBER(event, this->recursion);
     SCOPED_MUTEX_LOCK(lock, this->mutex, this_ethread());
-    send_data_frames_depends_on_priority();
+    Http2CommonSession::WriteBatch batch(this->session);
+    if (Http2::stream_priority_enabled == HTTP2_STREAM_PRIORITY_RFC9218) {
+      send_data_frames_depends_on_urgency();
+    } else {
+      send_data_frames_depends_on_priority();
+    }
   } break;
 
   case HTTP2_SESSION_EVENT_DATA: {
@@ -1899,6 +1911,7 @@ Http2ConnectionState::restart_streams()
 {
   Http2Stream *s = stream_list.head;
   if (s) {
+    Http2CommonSession::WriteBatch batch(this->session);
     Http2Stream *end = s;
 
     // This is a static variable, so it is shared in Http2ConnectionState instances and will get incremented in subsequent calls.
@@ -2024,7 +2037,8 @@ Http2ConnectionState::delete_stream(Http2Stream *stream)
   Http2StreamDebug(session, stream->get_id(), "Delete stream");
   REMEMBER(NO_EVENT, this->recursion);
 
-  if (Http2::stream_priority_enabled) {
+  priority_scheduler.deactivate(&stream->scheduler_node);
+  if (Http2::stream_priority_enabled == HTTP2_STREAM_PRIORITY_RFC7540) {
     Http2DependencyTree::Node *node       = stream->priority_node;
     Http2DependencyTree::Node *node_by_id = this->dependency_tree->find(stream->get_id());
     ink_assert(node == node_by_id);
@@ -2153,11 +2167,16 @@ Http2ConnectionState::schedule_stream_to_send_priority_frames(Http2Stream *strea
 {
   Http2StreamDebug(session, stream->get_id(), "Scheduling sending priority frames");
 
-  Http2DependencyTree::Node *node = stream->priority_node;
-  ink_release_assert(node != nullptr);
+  if (Http2::stream_priority_enabled == HTTP2_STREAM_PRIORITY_RFC9218) {
+    SCOPED_MUTEX_LOCK(lock, this->mutex, this_ethread());
+    priority_scheduler.activate(&stream->scheduler_node);
+  } else {
+    Http2DependencyTree::Node *node = stream->priority_node;
+    ink_release_assert(node != nullptr);
 
-  SCOPED_MUTEX_LOCK(lock, this->mutex, this_ethread());
-  dependency_tree->activate(node);
+    SCOPED_MUTEX_LOCK(lock, this->mutex, this_ethread());
+    dependency_tree->activate(node);
+  }
 
   if (_priority_event == nullptr) {
     SET_HANDLER(&Http2ConnectionState::main_event_handler);
@@ -2256,6 +2275,61 @@ Http2ConnectionState::send_data_frames_depends_on_priority()
   return;
 }
 
+/**
+ * Send DATA frames of the active streams in the order of [RFC 9218]
+ * priorities. Unlike the dependency tree, several frames go out per event.
+ */
+void
+Http2ConnectionState::send_data_frames_depends_on_urgency()
+{
+  for (int i = 0; i < MAX_DATA_FRAMES_PER_EVENT; ++i) {
+    Http2PriorityScheduler::Node *node = priority_scheduler.top();
+
+    // No stream to send or no connection level window left. A WINDOW_UPDATE
+    // frame restarts the streams.
+    if (node == nullptr || _peer_rwnd <= 0) {
+      return;
+    }
+
+    Http2Stream *stream = static_cast<Http2Stream *>(node->t);
+    ink_release_assert(stream != nullptr);
+    Http2StreamDebug(session, stream->get_id(), "top node, urgency=%u", node->urgency);
+
+    size_t                   len    = 0;
+    Http2SendDataFrameResult result = send_a_data_frame(stream, len);
+
+    switch (result) {
+    case Http2SendDataFrameResult::NO_ERROR: {
+      // No response body to send
+      if (len == 0 && !stream->is_write_vio_done()) {
+        priority_scheduler.deactivate(node);
+      } else {
+        priority_scheduler.update(node);
+        SCOPED_MUTEX_LOCK(stream_lock, stream->mutex, this_ethread());
+        stream->signal_write_event(stream->is_write_vio_done() ? VC_EVENT_WRITE_COMPLETE : VC_EVENT_WRITE_READY);
+      }
+      break;
+    }
+    case Http2SendDataFrameResult::DONE: {
+      priority_scheduler.deactivate(node);
+      stream->initiating_close();
+      break;
+    }
+    case Http2SendDataFrameResult::NOT_WRITE_AVAIL:
+      // The session restarts the streams once the write buffer drains.
+      return;
+    default:
+      // When no stream level window left, deactivate node once and wait window_update frame
+      priority_scheduler.deactivate(node);
+      break;
+    }
+  }
+
+  if (_priority_event == nullptr && priority_scheduler.top() != nullptr) {
+    _priority_event = this_ethread()->schedule_imm_local(static_cast<Continuation *>(this), HTTP2_SESSION_EVENT_PRIO);
+  }
+}
+
 Http2SendDataFrameResult
 Http2ConnectionState::send_a_data_frame(Http2Stream *stream, size_t &payload_length)
 {
@@ -2600,7 +2674,7 @@ Http2ConnectionState::send_push_promise_frame(Http2Stream *stream, URL &url, con
   }
 
   SCOPED_MUTEX_LOCK(stream_lock, stream->mutex, this_ethread());
-  if (Http2::stream_priority_enabled) {
+  if (Http2::stream_priority_enabled == HTTP2_STREAM_PRIORITY_RFC7540) {
     Http2DependencyTree::Node *node = this->dependency_tree->find(id);
     if (node != nullptr) {
       stream->priority_node = node;
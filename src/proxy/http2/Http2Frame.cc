@@ -59,16 +59,20 @@ Http2DataFrame::write_to(MIOBuffer *iobuffer) const
   // Write frame payload
   if (this->_reader && this->_payload_len > 0) {
     int64_t written = 0;
-    // Fill current IOBufferBlock as much as possible to reduce SSL_write() calls
     while (written < this->_payload_len) {
       int64_t read_len = std::min(this->_payload_len - written, this->_reader->block_read_avail());
 
-      if (iobuffer->block_write_avail() < read_len) {
-        // This block size is the buffer size that we pass to SSLWriteBuffer
-        iobuffer->append_block(Http2::write_buffer_block_size_index);
+      if (Http2::write_reference_threshold > 0 && read_len >= Http2::write_reference_threshold) {
+        // Share the block instead of copying it, see proxy.config.http2.write_reference_threshold
+        written += iobuffer->write(this->_reader, read_len);
+      } else {
+        // Fill current IOBufferBlock as much as possible to reduce SSL_write() calls
+        if (iobuffer->block_write_avail() < read_len) {
+          // This block size is the buffer size that we pass to SSLWriteBuffer
+          iobuffer->append_block(Http2::write_buffer_block_size_index);
+        }
+        written += iobuffer->write(this->_reader->start(), read_len);
       }
-
-      written += iobuffer->write(this->_reader->start(), read_len);
       this->_reader->consume(read_len);
     }
     len += written;
@@ -1209,6 +1209,23 @@ Http2Stream::read_vio_read_avail()
   return 0;
 }
 
+/**
+ * Take the urgency and incremental parameters of the stream from the priority
+ * header field of the request ([RFC 9218] 5).
+ */
+void
+Http2Stream::set_priority_from_headers()
+{
+  uint8_t urgency     = Http2PriorityScheduler::DEFAULT_URGENCY;
+  bool    incremental = false;
+
+  if (const MIMEField *field = _receive_header.field_find("priority", 8); field != nullptr) {
+    Http2PriorityScheduler::parse_priority_field(field->value_get(), urgency, incremental);
+  }
+  Http2StreamDebug("priority u=%u i=%d", urgency, incremental);
+  get_connection_state().priority_scheduler.reprioritize(&scheduler_node, urgency, incremental);
+}
+
 bool
 Http2Stream::has_request_body(int64_t /* content_length ATS_UNUSED */, bool /* is_chunked_set ATS_UNUSED */) const
 {
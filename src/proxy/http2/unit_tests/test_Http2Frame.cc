@@ -61,6 +61,78 @@ TEST_CASE("Http2Frame", "[http2][Http2Frame]")
     CHECK(memcmp(buf, expected, written) == 0);
   }
 
+  SECTION("DATA")
+  {
+    MIOBuffer      *body   = new_MIOBuffer(BUFFER_SIZE_INDEX_32K);
+    IOBufferReader *body_r = body->alloc_reader();
+    int64_t const   large  = 16384;
+    uint32_t const  saved  = Http2::write_reference_threshold;
+
+    auto data_blocks = [](IOBufferReader *reader) {
+      int n = 0;
+      for (IOBufferBlock *b = reader->get_current_block(); b; b = b->next.get()) {
+        n += b->read_avail() > 0;
+      }
+      return n;
+    };
+
+    // Two frames in a row, each with a payload block of its own
+    IOBufferData *payload_data[2];
+    for (auto &data : payload_data) {
+      body->append_block(BUFFER_SIZE_INDEX_32K);
+      body->fill(large);
+      data = body->first_write_block()->data.get();
+    }
+
+    SECTION("is copied by default")
+    {
+      CHECK(Http2::write_reference_threshold == 0);
+
+      for (int i = 0; i < 2; i++) {
+        Http2DataFrame frame(1, 0, body_r, large);
+        CHECK(frame.write_to(miob) == static_cast<int64_t>(HTTP2_FRAME_HEADER_LEN) + large);
+      }
+      CHECK(miob_r->read_avail() == 2 * (static_cast<int64_t>(HTTP2_FRAME_HEADER_LEN) + large));
+      CHECK(body_r->read_avail() == 0);
+
+      // Headers and payloads are packed together, not one block per piece
+      CHECK(data_blocks(miob_r) <= 2);
+    }
+
+    SECTION("shares large payload blocks when enabled")
+    {
+      Http2::write_reference_threshold = large;
+
+      char small[100];
+      memset(small, 'a', sizeof(small));
+      body->write(small, sizeof(small));
+
+      for (int64_t payload : {large, large, static_cast<int64_t>(sizeof(small))}) {
+        Http2DataFrame frame(1, 0, body_r, payload);
+        CHECK(frame.write_to(miob) == static_cast<int64_t>(HTTP2_FRAME_HEADER_LEN) + payload);
+      }
+      CHECK(body_r->read_avail() == 0);
+
+      // A shared block has no room to write into, so each frame header after
+      // it starts a new block: header, payload, header, payload, header + small.
+      CHECK(data_blocks(miob_r) == 5);
+
+      IOBufferBlock *b = miob_r->get_current_block();
+      for (IOBufferData *data : payload_data) {
+        CHECK(b->read_avail() == static_cast<int64_t>(HTTP2_FRAME_HEADER_LEN));
+        b = b->next.get();
+        CHECK(b->data.get() == data);
+        CHECK(b->read_avail() == large);
+        b = b->next.get();
+      }
+      CHECK(b->read_avail() == static_cast<int64_t>(HTTP2_FRAME_HEADER_LEN + sizeof(small)));
+
+      Http2::write_reference_threshold = saved;
+    }
+
+    free_MIOBuffer(body);
+  }
+
   free_MIOBuffer(miob);
 }
 
@@ -0,0 +1,130 @@
+/** @file
+
+    Unit tests for Http2PriorityScheduler
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include <string>
+
+#include "proxy/http2/Http2PriorityScheduler.h"
+
+using Scheduler = Http2PriorityScheduler::Scheduler;
+using Node      = Http2PriorityScheduler::Node;
+
+TEST_CASE("Http2PriorityScheduler_urgency", "[http2][Http2PriorityScheduler]")
+{
+  Scheduler   scheduler;
+  std::string a("A"), b("B"), c("C");
+  Node        node_a(&a), node_b(&b), node_c(&c);
+
+  REQUIRE(scheduler.top() == nullptr);
+
+  scheduler.reprioritize(&node_a, 5, false);
+  scheduler.reprioritize(&node_b, 1, false);
+  scheduler.activate(&node_a);
+  scheduler.activate(&node_b);
+  scheduler.activate(&node_c);
+  REQUIRE(scheduler.size() == 3);
+
+  // Lower urgency value goes first
+  REQUIRE(scheduler.top() == &node_b);
+  scheduler.deactivate(&node_b);
+  REQUIRE(scheduler.top() == &node_c);
+  scheduler.deactivate(&node_c);
+  REQUIRE(scheduler.top() == &node_a);
+
+  // Reprioritizing an active node moves it
+  scheduler.activate(&node_c);
+  scheduler.reprioritize(&node_a, 0, false);
+  REQUIRE(scheduler.top() == &node_a);
+  REQUIRE(node_a.active);
+
+  scheduler.deactivate(&node_a);
+  scheduler.deactivate(&node_c);
+  REQUIRE(scheduler.top() == nullptr);
+  REQUIRE(scheduler.size() == 0);
+}
+
+TEST_CASE("Http2PriorityScheduler_incremental", "[http2][Http2PriorityScheduler]")
+{
+  Scheduler   scheduler;
+  std::string a("A"), b("B"), c("C");
+  Node        node_a(&a), node_b(&b), node_c(&c);
+
+  // A non-incremental node keeps the head of its level
+  scheduler.activate(&node_a);
+  scheduler.activate(&node_b);
+  scheduler.update(&node_a);
+  REQUIRE(scheduler.top() == &node_a);
+  scheduler.deactivate(&node_a);
+  scheduler.deactivate(&node_b);
+
+  // Incremental nodes take turns
+  scheduler.reprioritize(&node_a, 3, true);
+  scheduler.reprioritize(&node_b, 3, true);
+  scheduler.reprioritize(&node_c, 3, true);
+  scheduler.activate(&node_a);
+  scheduler.activate(&node_b);
+  scheduler.activate(&node_c);
+
+  Node *order[] = {&node_a, &node_b, &node_c, &node_a, &node_b, &node_c};
+  for (Node *expected : order) {
+    Node *node = scheduler.top();
+    REQUIRE(node == expected);
+    scheduler.update(node);
+  }
+
+  // Activating an active node does nothing
+  scheduler.activate(&node_a);
+  REQUIRE(scheduler.size() == 3);
+}
+
+TEST_CASE("Http2PriorityScheduler_parse_priority_field", "[http2][Http2PriorityScheduler]")
+{
+  struct {
+    const char *value;
+    uint8_t     urgency;
+    bool        incremental;
+  } const tests[] = {
+    {"",                3, false},
+    {"u=0",             0, false},
+    {"u=7, i",          7, true },
+    {"i",               3, true },
+    {"i=?1",            3, true },
+    {"i=?0",            3, false},
+    {" u = 1 ,i=?1 ",   1, true },
+    {"u=8",             3, false},
+    {"u=12",            3, false},
+    {"u=x, i=1",        3, false},
+    {"u=2;foo=bar, i",  2, true },
+    {"foo=1, u=4, bar", 4, false},
+  };
+
+  for (auto const &t : tests) {
+    uint8_t urgency     = Http2PriorityScheduler::DEFAULT_URGENCY;
+    bool    incremental = false;
+    Http2PriorityScheduler::parse_priority_field(t.value, urgency, incremental);
+    CAPTURE(t.value);
+    CHECK(urgency == t.urgency);
+    CHECK(incremental == t.incremental);
+  }
+}
@@ -570,6 +570,7 @@ RecLookupMatchingRecords(unsigned rec_type, const char *match, void (*callback)(
     tmp.rec_type  = RECT_PROCESS;
     tmp.data_type = RECD_INT;
 
+    ts::Metrics::ShardedCounter::sync();
     for (auto &&[name, val] : ts::Metrics::instance()) {
       if (regex.match(name.data()) >= 0) {
         tmp.name         = name.data();
@@ -904,6 +905,7 @@ RecDumpRecords(RecT rec_type, RecDumpEntryCb callback, void *edata)
   // Dump all new metrics as well (no "type" for them)
   RecData datum;
 
+  ts::Metrics::ShardedCounter::sync();
   for (auto &&[name, val] : ts::Metrics::instance()) {
     datum.rec_int = val;
     callback(RECT_PLUGIN, edata, true, name.data(), TS_RECORDDATATYPE_INT, &datum);
@@ -1772,18 +1772,21 @@ configure_io_uring()
   RecInt aio_io_uring_attach_wq     = cfg.attach_wq;
   RecInt aio_io_uring_wq_bounded    = cfg.wq_bounded;
   RecInt aio_io_uring_wq_unbounded  = cfg.wq_unbounded;
+  RecInt aio_io_uring_net_io        = cfg.net_io;
 
   REC_ReadConfigInteger(aio_io_uring_queue_entries, "proxy.config.io_uring.entries");
   REC_ReadConfigInteger(aio_io_uring_sq_poll_ms, "proxy.config.io_uring.sq_poll_ms");
   REC_ReadConfigInteger(aio_io_uring_attach_wq, "proxy.config.io_uring.attach_wq");
   REC_ReadConfigInteger(aio_io_uring_wq_bounded, "proxy.config.io_uring.wq_workers_bounded");
   REC_ReadConfigInteger(aio_io_uring_wq_unbounded, "proxy.config.io_uring.wq_workers_unbounded");
+  REC_ReadConfigInteger(aio_io_uring_net_io, "proxy.config.io_uring.net_io");
 
   cfg.queue_entries = aio_io_uring_queue_entries;
   cfg.sq_poll_ms    = aio_io_uring_sq_poll_ms;
   cfg.attach_wq     = aio_io_uring_attach_wq;
   cfg.wq_bounded    = aio_io_uring_wq_bounded;
   cfg.wq_unbounded  = aio_io_uring_wq_unbounded;
+  cfg.net_io        = aio_io_uring_net_io;
 
   IOUringContext::set_config(cfg);
 }
@@ -2193,8 +2196,11 @@ main(int /* argc ATS_UNUSED */, const char **argv)
   } else {
     // "Task" processor, possibly with its own set of task threads.
     // We don't need task threads in the "command_flag" case.
+    int task_work_stealing = 0;
+    REC_ReadConfigInteger(task_work_stealing, "proxy.config.task_threads.work_stealing");
     tasksProcessor.register_event_type();
     eventProcessor.thread_group[ET_TASK]._afterStartCallback = task_threads_started_callback;
+    eventProcessor.thread_group[ET_TASK]._work_stealing      = task_work_stealing != 0;
     tasksProcessor.start(num_task_threads, stacksize);
 
     RecProcessStart();
@@ -20,6 +20,7 @@
  */
 
 #include "tscore/ConsistentHash.h"
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <sstream>
@@ -27,13 +28,63 @@
 #include <climits>
 #include <cstdio>
 
+namespace
+{
+// Maglev table slots per replica.  The table size must not depend on the number of nodes, or every
+// insert would move most of the keys.  1024 replicas give 65537 slots, enough for a few hundred
+// nodes to be balanced within a percent or two.
+constexpr size_t MAGLEV_SLOTS_PER_REPLICA = 64;
+
+bool
+is_prime(size_t n)
+{
+  if (n < 2) {
+    return false;
+  }
+  for (size_t d = 2; d * d <= n; ++d) {
+    if (n % d == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+uint64_t
+hash_string(ATSHash64 *thash, const char *prefix, std::string const &s)
+{
+  thash->update(prefix, strlen(prefix));
+  thash->update(s.c_str(), s.size());
+  thash->final();
+  uint64_t zret = thash->get();
+  thash->clear();
+  return zret;
+}
+
+// Index of the first element of [first, first + n) not less than @a key, without data dependent branches.
+size_t
+branchless_lower_bound(const uint64_t *first, size_t n, uint64_t key)
+{
+  if (n == 0) {
+    return 0;
+  }
+  const uint64_t *base = first;
+  while (n > 1) {
+    size_t half  = n / 2;
+    base        += (base[half - 1] < key) * half;
+    n           -= half;
+  }
+  return (base - first) + (*base < key);
+}
+
+} // namespace
+
 std::ostream &
 operator<<(std::ostream &os, ATSConsistentHashNode &thing)
 {
   return os << thing.name;
 }
 
-ATSConsistentHash::ATSConsistentHash(int r, ATSHash64 *h) : replicas(r), hash(h) {}
+ATSConsistentHash::ATSConsistentHash(int r, ATSHash64 *h, Algorithm a) : replicas(r), hash(h), algorithm(a) {}
 
 void
 ATSConsistentHash::insert(ATSConsistentHashNode *node, float weight, ATSHash64 *h)
@@ -55,21 +106,126 @@ ATSConsistentHash::insert(ATSConsistentHashNode *node, float weight, ATSHash64 *
   string_stream << *node;
   std_string = string_stream.str();
 
+  if (algorithm == Algorithm::MAGLEV) {
+    if (weight > 0) {
+      maglev_members.push_back({node, weight, hash_string(thash, "offset-", std_string), hash_string(thash, "skip-", std_string)});
+      maglev_ready = false;
+    }
+    return;
+  }
+
+  std::vector<std::pair<uint64_t, ATSConsistentHashNode *>> points;
   for (i = 0; i < static_cast<int>(roundf(replicas * weight)); i++) {
     snprintf(numstr, 256, "%d-", i);
-    thash->update(numstr, strlen(numstr));
-    thash->update(std_string.c_str(), strlen(std_string.c_str()));
-    thash->final();
-    NodeMap.insert(std::pair<uint64_t, ATSConsistentHashNode *>(thash->get(), node));
-    thash->clear();
+    points.emplace_back(hash_string(thash, numstr, std_string), node);
+  }
+  // Merge the new points into the ring.  As with a map insert, a point whose hash value is already
+  // in the ring does not replace it.
+  std::stable_sort(points.begin(), points.end(), [](auto const &lhs, auto const &rhs) { return lhs.first < rhs.first; });
+
+  std::vector<uint64_t>                hashes;
+  std::vector<ATSConsistentHashNode *> nodes;
+  hashes.reserve(ring_hashes.size() + points.size());
+  nodes.reserve(ring_nodes.size() + points.size());
+
+  size_t x = 0;
+  size_t y = 0;
+  while (x < ring_hashes.size() || y < points.size()) {
+    if (y == points.size() || (x < ring_hashes.size() && ring_hashes[x] <= points[y].first)) {
+      if (!hashes.empty() && hashes.back() == ring_hashes[x]) {
+        ++x;
+        continue;
+      }
+      hashes.push_back(ring_hashes[x]);
+      nodes.push_back(ring_nodes[x]);
+      ++x;
+    } else {
+      if (!hashes.empty() && hashes.back() == points[y].first) {
+        ++y;
+        continue;
+      }
+      hashes.push_back(points[y].first);
+      nodes.push_back(points[y].second);
+      ++y;
+    }
+  }
+  ring_hashes = std::move(hashes);
+  ring_nodes  = std::move(nodes);
+}
+
+//
+// Fill the Maglev lookup table.  Each node takes its turn to claim the next free slot of its own
+// permutation of the table, and a node with half the weight of the heaviest node takes every
+// other turn.
+//
+void
+ATSConsistentHash::build_maglev_table()
+{
+  std::lock_guard<std::mutex> lock(maglev_mutex);
+
+  if (maglev_ready) {
+    return;
+  }
+
+  size_t n    = maglev_members.size();
+  size_t size = static_cast<size_t>(std::max(replicas, 1)) * MAGLEV_SLOTS_PER_REPLICA;
+  while (!is_prime(size)) {
+    ++size;
   }
+
+  std::vector<ATSConsistentHashNode *> table(n > 0 ? size : 0, nullptr);
+  std::vector<uint64_t>                offset(n);
+  std::vector<uint64_t>                skip(n);
+  std::vector<uint64_t>                next(n, 0);
+  std::vector<float>                   credit(n, 0);
+  float                                max_weight = 0;
+
+  for (size_t i = 0; i < n; ++i) {
+    offset[i]  = maglev_members[i].offset_hash % size;
+    skip[i]    = maglev_members[i].skip_hash % (size - 1) + 1;
+    max_weight = std::max(max_weight, maglev_members[i].weight);
+  }
+
+  for (size_t filled = 0; filled < table.size();) {
+    for (size_t i = 0; i < n && filled < table.size(); ++i) {
+      credit[i] += maglev_members[i].weight / max_weight;
+      if (credit[i] < 1) {
+        continue;
+      }
+      credit[i] -= 1;
+
+      uint64_t slot = (offset[i] + next[i] * skip[i]) % size;
+      while (table[slot] != nullptr) {
+        ++next[i];
+        slot = (offset[i] + next[i] * skip[i]) % size;
+      }
+      table[slot] = maglev_members[i].node;
+      ++next[i];
+      ++filled;
+    }
+  }
+
+  maglev_table = std::move(table);
+  maglev_ready.store(true, std::memory_order_release);
+}
+
+size_t
+ATSConsistentHash::start_index(uint64_t hashval)
+{
+  if (algorithm == Algorithm::MAGLEV) {
+    if (!maglev_ready.load(std::memory_order_acquire)) {
+      build_maglev_table();
+    }
+    return maglev_table.empty() ? 0 : hashval % maglev_table.size();
+  }
+  return branchless_lower_bound(ring_hashes.data(), ring_hashes.size(), hashval);
 }
 
 ATSConsistentHashNode *
 ATSConsistentHash::lookup(const char *url, ATSConsistentHashIter *i, bool *w, ATSHash64 *h)
 {
   uint64_t              url_hash;
-  ATSConsistentHashIter NodeMapIterUp, *iter;
+  ATSConsistentHashIter NodeMapIterUp = 0, *iter;
   ATSHash64            *thash;
   bool                 *wptr, wrapped = false;
 
@@ -99,33 +255,35 @@ ATSConsistentHash::lookup(const char *url, ATSConsistentHashIter *i, bool *w, AT
     url_hash = thash->get();
     thash->clear();
 
-    *iter = NodeMap.lower_bound(url_hash);
+    *iter = start_index(url_hash);
 
-    if (*iter == NodeMap.end()) {
+    if (*iter == slots().size()) {
       *wptr = true;
-      *iter = NodeMap.begin();
+      *iter = 0;
     }
   } else {
     (*iter)++;
   }
 
-  if (!(*wptr) && *iter == NodeMap.end()) {
+  auto &NodeMap = slots();
+
+  if (!(*wptr) && *iter >= NodeMap.size()) {
     *wptr = true;
-    *iter = NodeMap.begin();
+    *iter = 0;
   }
 
-  if (*wptr && *iter == NodeMap.end()) {
+  if (*iter >= NodeMap.size()) {
     return nullptr;
   }
 
-  return (*iter)->second;
+  return NodeMap[*iter];
 }
 
 ATSConsistentHashNode *
 ATSConsistentHash::lookup_available(const char *url, ATSConsistentHashIter *i, bool *w, ATSHash64 *h)
 {
   uint64_t              url_hash;
-  ATSConsistentHashIter NodeMapIterUp, *iter;
+  ATSConsistentHashIter NodeMapIterUp = 0, *iter;
   ATSHash64            *thash;
   bool                 *wptr, wrapped = false;
 
@@ -155,32 +313,38 @@ ATSConsistentHash::lookup_available(const char *url, ATSConsistentHashIter *i, b
     url_hash = thash->get();
     thash->clear();
 
-    *iter = NodeMap.lower_bound(url_hash);
+    *iter = start_index(url_hash);
   }
 
-  if (*iter == NodeMap.end()) {
+  auto &NodeMap = slots();
+
+  if (NodeMap.empty()) {
+    return nullptr;
+  }
+
+  if (*iter >= NodeMap.size()) {
     *wptr = true;
-    *iter = NodeMap.begin();
+    *iter = 0;
   }
 
-  while (!(*iter)->second->available) {
+  while (!NodeMap[*iter]->available) {
     (*iter)++;
 
-    if (!(*wptr) && *iter == NodeMap.end()) {
+    if (!(*wptr) && *iter == NodeMap.size()) {
       *wptr = true;
-      *iter = NodeMap.begin();
-    } else if (*wptr && *iter == NodeMap.end()) {
+      *iter = 0;
+    } else if (*wptr && *iter == NodeMap.size()) {
       return nullptr;
     }
   }
 
-  return (*iter)->second;
+  return NodeMap[*iter];
 }
 
 ATSConsistentHashNode *
 ATSConsistentHash::lookup_by_hashval(uint64_t hashval, ATSConsistentHashIter *i, bool *w)
 {
-  ATSConsistentHashIter NodeMapIterUp, *iter;
+  ATSConsistentHashIter NodeMapIterUp = 0, *iter;
   bool                 *wptr, wrapped = false;
 
   if (w) {
@@ -195,14 +359,20 @@ ATSConsistentHash::lookup_by_hashval(uint64_t hashval, ATSConsistentHashIter *i,
     iter = &NodeMapIterUp;
   }
 
-  *iter = NodeMap.lower_bound(hashval);
+  *iter = start_index(hashval);
+
+  auto &NodeMap = slots();
+
+  if (NodeMap.empty()) {
+    return nullptr;
+  }
 
-  if (*iter == NodeMap.end()) {
+  if (*iter == NodeMap.size()) {
     *wptr = true;
-    *iter = NodeMap.begin();
+    *iter = 0;
   }
 
-  return (*iter)->second;
+  return NodeMap[*iter];
 }
 
 ATSConsistentHash::~ATSConsistentHash()
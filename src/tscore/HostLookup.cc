@@ -29,9 +29,9 @@
  ****************************************************************************/
 
 #include <algorithm>
+#include <map>
 #include <string_view>
-#include <array>
-#include <memory>
+#include <unordered_map>
 
 #include "swoc/TextView.h"
 #include "swoc/bwf_ip.h"
@@ -180,417 +180,41 @@ static const unsigned char asciiToTable[256] = {
   255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
   255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255};
 
-// Number of legal characters in the asciiToTable array
-static const int numLegalChars = 38;
-
-// struct CharIndexBlock
-//
-//   Used by class CharIndex.  Forms a single level in CharIndex tree
-//
-struct CharIndexBlock {
-  struct Item {
-    HostBranch                     *branch{nullptr};
-    std::unique_ptr<CharIndexBlock> block;
-  };
-  std::array<Item, numLegalChars> array;
-};
-
-// class CharIndex - A constant time string matcher intended for
-//    short strings in a sparsely populated DNS partition
-//
-//    Creates a look up table for character in data string
-//
-//    Mapping from character to table index is done by
-//      asciiToTable[]
-//
-//    The illegalKey hash table is side structure for any
-//     entries that contain illegal hostname characters that
-//     we can not index into the normal table
-//
-//    Example: com
-//      c maps to 13, o maps to 25, m maps to 23
-//
-//                             CharIndexBlock         CharIndexBlock
-//                             -----------         ------------
-//                           0 |    |    |         |    |     |
-//                           . |    |    |         |    |     |
-//    CharIndexBlock         . |    |    |         |    |     |
-//    ----------             . |    |    |         |    |     |
-//  0 |   |    |             . |    |    |   |-->23| ptr|  0  |  (ptr is to the
-//  . |   |    |   |-------->25| 0  |   -----|     |    |     |   hostBranch for
-//  . |   |    |   |         . |    |    |         |    |     |   domain com)
-// 13 | 0 |  --|---|         . |    |    |         |    |     |
-//  . |   |    |             . |    |    |         |    |     |
-//  . |   |    |               |    |    |         |    |     |
-//  . |   |    |               |    |    |         |    |     |
-//    |   |    |               -----------         -----------|
-//    |   |    |
-//    |   |    |
-//    |   |    |
-//    |--------|
-//
-//
-//
-class CharIndex
-{
-public:
-  struct iterator {
-    using iterator_category = std::forward_iterator_tag;
-    using value_type        = HostBranch;
-    using difference_type   = int;
-
-    using self_type = iterator;
-
-    struct State {
-      int             index{-1};
-      CharIndexBlock *block{nullptr};
-    };
-
-    iterator() { q.reserve(HOST_TABLE_DEPTH * 2); } // was 6, guessing that was twice the table depth.
-
-    value_type *operator->();
-    value_type &operator*();
-    bool        operator==(self_type const &that) const;
-    bool        operator!=(self_type const &that) const;
-    self_type  &operator++();
-
-    // Current level.
-    int cur_level{-1};
-
-    // Where we got the last element from
-    State state;
-
-    //  Queue of the above levels
-    std::vector<State> q;
-
-    // internal methods
-    self_type &advance();
-  };
-
-  ~CharIndex();
-  void        Insert(string_view match_data, HostBranch *toInsert);
-  HostBranch *Lookup(string_view match_data);
-
-  iterator begin();
-  iterator end();
-
-private:
-  CharIndexBlock root;
-  using Table = std::unordered_map<string_view, HostBranch *>;
-  std::unique_ptr<Table> illegalKey;
-};
-
-CharIndex::~CharIndex()
+namespace
 {
-  // clean up the illegal key table.
-  if (illegalKey) {
-    for (auto &item : *illegalKey) {
-      delete item.second;
-    }
-  }
-}
-
-// void CharIndex::Insert(const char* match_data, HostBranch* toInsert)
-//
-//   Places a binding for match_data to toInsert into the index
-//
-void
-CharIndex::Insert(string_view match_data, HostBranch *toInsert)
+// True if @a label has only legal hostname characters, see asciiToTable[].
+bool
+is_legal(string_view label)
 {
-  unsigned char   index;
-  CharIndexBlock *cur = &root;
-
-  ink_assert(!match_data.empty());
-
-  if (std::any_of(match_data.begin(), match_data.end(), [](unsigned char c) { return asciiToTable[c] == 255; })) {
-    // Insert into illegals hash table
-    if (illegalKey == nullptr) {
-      illegalKey.reset(new Table);
-    }
-    toInsert->key = match_data;
-    illegalKey->emplace(toInsert->key, toInsert);
-  } else {
-    while (true) {
-      index = asciiToTable[static_cast<unsigned char>(match_data.front())];
-
-      // Check to see if are at the level we supposed be at
-      if (match_data.size() == 1) {
-        // The slot should always be empty, no duplicate keys are allowed
-        ink_assert(cur->array[index].branch == nullptr);
-        cur->array[index].branch = toInsert;
-        break;
-      } else {
-        // We need to find the next level in the table
-
-        CharIndexBlock *next = cur->array[index].block.get();
-
-        // Check to see if we need to expand the table
-        if (next == nullptr) {
-          next = new CharIndexBlock;
-          cur->array[index].block.reset(next);
-        }
-        cur = next;
-      }
-      match_data.remove_prefix(1);
-    }
-  }
+  return std::none_of(label.begin(), label.end(), [](unsigned char c) { return asciiToTable[c] == 255; });
 }
 
-// HostBranch* CharIndex::Lookup(const char* match_data)
-//
-//  Searches the CharIndex on key match_data
-//    If there is a binding for match_data, returns a pointer to it
-//    otherwise a nullptr pointer is returned
-//
-HostBranch *
-CharIndex::Lookup(string_view match_data)
+// Compare @a key with @a label as if @a label was lower case, @a key is already.
+int
+fold_compare(string_view key, string_view label)
 {
-  if (match_data.empty()) {
-    return nullptr;
-  }
-
-  if (std::any_of(match_data.begin(), match_data.end(), [](unsigned char c) { return asciiToTable[c] == 255; })) {
-    if (illegalKey) {
-      auto spot = illegalKey->find(match_data);
-      if (spot != illegalKey->end()) {
-        return spot->second;
-      }
-    }
-    return nullptr;
-  }
-
-  // Invariant: No invalid characters.
-  CharIndexBlock *cur = &root;
-  while (cur) {
-    unsigned char index = asciiToTable[static_cast<unsigned char>(match_data.front())];
-
-    // Check to see if we are looking for the next level or
-    //    a HostBranch
-    if (match_data.size() == 1) {
-      return cur->array[index].branch;
-    } else {
-      cur = cur->array[index].block.get();
+  size_t n = std::min(key.size(), label.size());
+  for (size_t i = 0; i < n; ++i) {
+    unsigned char k = key[i];
+    unsigned char l = tolower(static_cast<unsigned char>(label[i]));
+    if (k != l) {
+      return k < l ? -1 : 1;
     }
-    match_data.remove_prefix(1);
-  }
-  return nullptr;
-}
-
-auto
-CharIndex::begin() -> iterator
-{
-  iterator zret;
-  zret.state.block = &root;
-  zret.state.index = 0;
-  zret.cur_level   = 0;
-  if (root.array[0].branch == nullptr) {
-    zret.advance();
   }
-  return zret;
-}
-
-auto
-CharIndex::end() -> iterator
-{
-  return {};
-}
-
-auto
-CharIndex::iterator::operator->() -> value_type *
-{
-  ink_assert(state.block != nullptr); // clang!
-  return state.block->array[state.index].branch;
-}
-
-auto
-CharIndex::iterator::operator*() -> value_type &
-{
-  ink_assert(state.block != nullptr); // clang!
-  return *(state.block->array[state.index].branch);
-}
-
-//
-// HostBranch* CharIndex::iter_next(CharIndexIterState* s)
-//
-//    Finds the next element in the char index and returns
-//      a pointer to it.  If there are no more elements, nullptr
-//      is returned
-//
-auto
-CharIndex::iterator::advance() -> self_type &
-{
-  bool check_branch_p{false}; // skip local branch on the first loop.
-  do {
-    // Check to see if we need to go back up a level
-    if (state.index >= numLegalChars) {
-      if (cur_level <= 0) {    // No more levels so bail out
-        state.block = nullptr; // carefully make this @c equal to the end iterator.
-        state.index = -1;
-        break;
-      } else { // Go back up to a stored level
-        state = q[--cur_level];
-        ++state.index; // did that one before descending.
-      }
-    } else if (check_branch_p && state.block->array[state.index].branch != nullptr) {
-      //  Note: we check for a branch on this level before a descending a level so that when we come back up
-      //  this level will be done with this index.
-      break;
-    } else if (state.block->array[state.index].block != nullptr) {
-      // There is a lower level block to iterate over, store our current state and descend
-      if (static_cast<int>(q.size()) <= cur_level) {
-        q.push_back(state);
-      } else {
-        q[cur_level] = state;
-      }
-      cur_level++;
-      state.block = state.block->array[state.index].block.get();
-      state.index = 0;
-    } else {
-      ++state.index;
-    }
-    check_branch_p = true;
-  } while (true);
-  return *this;
-}
-
-auto
-CharIndex::iterator::operator++() -> self_type &
-{
-  return this->advance();
+  return key.size() < label.size() ? -1 : key.size() > label.size() ? 1 : 0;
 }
 
-bool
-CharIndex::iterator::operator==(const self_type &that) const
-{
-  return this->state.block == that.state.block && this->state.index == that.state.index;
-}
-
-bool
-CharIndex::iterator::operator!=(const self_type &that) const
-{
-  return !(*this == that);
-}
-
-// class HostArray
-//
-//   Is a fixed size array for holding HostBranch*
-//   Allows only sequential access to data
-//
-
-class HostArray
-{
-  /// Element of the @c HostArray.
-  struct Item {
-    HostBranch *branch{nullptr}; ///< Next branch.
-    std::string match_data;      ///< Match data for that branch.
-  };
-  using Array = std::array<Item, HOST_ARRAY_MAX>;
-
-public:
-  bool        Insert(string_view match_data_in, HostBranch *toInsert);
-  HostBranch *Lookup(string_view match_data_in, bool bNotProcess);
-
-  Array::iterator
-  begin()
-  {
-    return array.begin();
-  }
-  Array::iterator
-  end()
-  {
-    return array.begin() + _size;
-  }
-
-private:
-  int   _size{0}; // number of elements currently in the array
-  Array array;
+// Node of the trie while it is built by HostLookup::Finalize.
+struct BuildNode {
+  std::map<std::string, int> children; // label -> node
+  std::vector<int>           leaves;   // HostLeaf indices
 };
 
-// bool HostArray::Insert(const char* match_data_in, HostBranch* toInsert)
-//
-//    Places toInsert into the array with key match_data if there
-//     is adequate space, in which case true is returned
-//    If space is inadequate, false is returned and nothing is inserted
-//
-bool
-HostArray::Insert(string_view match_data, HostBranch *toInsert)
-{
-  if (_size < static_cast<int>(array.size())) {
-    array[_size].branch     = toInsert;
-    array[_size].match_data = match_data;
-    ++_size;
-    return true;
-  }
-  return false;
-}
-
-// HostBranch* HostArray::Lookup(const char* match_data_in)
-//
-//   Looks for key match_data_in.  If a binding is found,
-//     returns HostBranch* found to the key, otherwise
-//     nullptr is returned
-//
-HostBranch *
-HostArray::Lookup(string_view match_data_in, bool bNotProcess)
-{
-  HostBranch *r = nullptr;
-  string_view pMD;
-
-  for (int i = 0; i < _size; i++) {
-    pMD = array[i].match_data;
-
-    if (bNotProcess && '!' == pMD.front()) {
-      pMD.remove_prefix(1);
-      if (pMD.empty()) {
-        continue;
-      }
-
-      if (pMD == match_data_in) {
-        r = array[i].branch;
-      }
-    } else if (pMD == match_data_in) {
-      r = array[i].branch;
-      break;
-    }
-  }
-  return r;
-}
+} // namespace
 
 // maps enum LeafType to strings
 const char *LeafTypeStr[] = {"Leaf Invalid", "Host (Partial)", "Host (Full)", "Domain (Full)", "Domain (Partial)"};
 
-// HostBranch::~HostBranch()
-//
-//   Recursive delete all host branches below us
-//
-HostBranch::~HostBranch()
-{
-  switch (type) {
-  case HOST_TERMINAL:
-    break;
-  case HOST_HASH: {
-    HostTable *ht = next_level._table;
-    for (auto &item : *ht) {
-      delete item.second;
-    }
-    delete ht;
-  } break;
-  case HOST_INDEX: {
-    CharIndex *ci = next_level._index;
-    for (auto &branch : *ci) {
-      delete &branch;
-    }
-    delete ci;
-  } break;
-  case HOST_ARRAY:
-    for (auto &item : *next_level._array) {
-      delete item.branch;
-    }
-    delete next_level._array;
-    break;
-  }
-}
-
 HostLookup::HostLookup(string_view name) : matcher_name(name) {}
 
 void
@@ -602,225 +226,169 @@ HostLookup::Print() const
 void
 HostLookup::Print(PrintFunc const &f) const
 {
-  PrintHostBranch(&root, f);
+  if (!nodes.empty()) {
+    PrintNode(0, f);
+  }
 }
 
 //
-// void HostLookup::PrintHostBranch(HostBranch* hb, HostLookupPrintFunc f)
+// void HostLookup::PrintNode(int node, HostLookupPrintFunc f)
 //
-//   Recursively traverse the matching tree rooted at arg hb
+//   Recursively traverse the matching trie rooted at arg node
 //     and print out each element
 //
 void
-HostLookup::PrintHostBranch(const HostBranch *hb, PrintFunc const &f) const
+HostLookup::PrintNode(int node, PrintFunc const &f) const
 {
-  for (auto curIndex : hb->leaf_indices) {
-    auto &leaf{leaf_array[curIndex]};
+  Node const &n = nodes[node];
+
+  for (uint32_t i = n.leaf_begin; i < n.leaf_begin + n.leaf_count; ++i) {
+    auto &leaf{leaf_array[leaf_indices[i]]};
     printf("\t\t%s for %.*s\n", LeafTypeStr[leaf.type], static_cast<int>(leaf.match.size()), leaf.match.data());
-    f(leaf_array[curIndex].opaque_data);
+    f(leaf.opaque_data);
   }
 
-  switch (hb->type) {
-  case HostBranch::HOST_TERMINAL:
-    ink_assert(hb->next_level._ptr == nullptr);
-    break;
-  case HostBranch::HOST_HASH:
-    for (auto &branch : *(hb->next_level._table)) {
-      PrintHostBranch(branch.second, f);
-    }
-    break;
-  case HostBranch::HOST_INDEX:
-    for (auto &branch : *(hb->next_level._index)) {
-      PrintHostBranch(&branch, f);
-    }
-    break;
-  case HostBranch::HOST_ARRAY:
-    for (auto &item : *(hb->next_level._array)) {
-      PrintHostBranch(item.branch, f);
-    }
-    break;
+  for (uint32_t i = n.edge_begin; i < n.edge_begin + n.edge_count; ++i) {
+    PrintNode(edges[i].node, f);
   }
 }
 
 //
-// HostBranch* HostLookup::TableNewLevel(HostBranch* from, const char* level_data)
+// void HostLookup::Finalize()
 //
-//    Creates the next level structure in arg from
-//       Creates a HostBranch for level_data, inserts it in to the
-//         the next_level structure and returns a pointer to the new
-//         HostBranch
-//
-HostBranch *
-HostLookup::TableNewLevel(HostBranch *from, string_view level_data)
-{
-  ink_assert(from->type == HostBranch::HOST_TERMINAL);
-
-  // Use the CharIndex for high speed matching at the first level of
-  //   the table.  The first level is short strings, ie: com, edu, jp, fr
-  if (from->level_idx == 0) {
-    from->type              = HostBranch::HOST_INDEX;
-    from->next_level._index = new CharIndex;
-  } else {
-    from->type              = HostBranch::HOST_ARRAY;
-    from->next_level._array = new HostArray;
-  }
-
-  return InsertBranch(from, level_data);
-}
-
+//   Builds the search trie out of the leaf array.  Each node is a
+//     run of edges sorted by label and a run of leaf indices, with
+//     the nodes laid out level by level.  The edge semantics are
+//     those of the structures the trie replaced:
 //
-// HostBranch* HostLookup::InsertBranch(HostBranch* insert_to, const char* level_data)
+//     The root matches the legal hostname characters (see
+//       asciiToTable[]) case insensitively, other labels exactly
 //
+//     A node with at most HOST_ARRAY_MAX children matches "!label"
+//       when looking up "label", unless there also is "label"
 //
-//    Abstraction to place a new node for level_data below node
-//      insert to.  Inserts into any of the data types used by
-//      by class HostMatcher
+//     A node with more children matches labels exactly
 //
-HostBranch *
-HostLookup::InsertBranch(HostBranch *insert_in, string_view level_data)
+void
+HostLookup::Finalize()
 {
-  HostBranch *new_branch = new HostBranch;
-  new_branch->key        = level_data;
-  new_branch->type       = HostBranch::HOST_TERMINAL;
-  new_branch->level_idx  = insert_in->level_idx + 1;
-
-  switch (insert_in->type) {
-  case HostBranch::HOST_TERMINAL:
-    // Should not happen
-    ink_release_assert(0);
-    break;
-  case HostBranch::HOST_HASH:
-    insert_in->next_level._table->emplace(new_branch->key, new_branch);
-    break;
-  case HostBranch::HOST_INDEX:
-    insert_in->next_level._index->Insert(new_branch->key, new_branch);
-    break;
-  case HostBranch::HOST_ARRAY: {
-    auto array = insert_in->next_level._array;
-    if (array->Insert(level_data, new_branch) == false) {
-      // The array is out of space, time to move to a hash table
-      auto ha = insert_in->next_level._array;
-      auto ht = new HostTable;
-      ht->emplace(new_branch->key, new_branch);
-      for (auto &item : *array) {
-        ht->emplace(item.branch->key, item.branch);
+  std::vector<BuildNode> tree(1);
+
+  for (int index = 0; index < static_cast<int>(leaf_array.size()); ++index) {
+    auto       &leaf = leaf_array[index];
+    std::string name = leaf.isNot ? "!" + leaf.match : leaf.match;
+    TextView    match{name};
+    int         cur = 0;
+
+    for (int i = 0; !match.rtrim('.').empty() && i < HOST_TABLE_DEPTH; ++i) {
+      std::string label{match.take_suffix_at('.')};
+      if (cur == 0 && is_legal(label)) {
+        std::transform(label.begin(), label.end(), label.begin(), [](unsigned char c) { return tolower(c); });
+      }
+
+      auto spot = tree[cur].children.find(label);
+      if (spot == tree[cur].children.end()) {
+        int next = tree.size();
+        tree[cur].children.emplace(std::move(label), next);
+        tree.emplace_back();
+        cur = next;
+      } else {
+        cur = spot->second;
       }
-      // Ring out the old, ring in the new
-      delete ha;
-      insert_in->next_level._table = ht;
-      insert_in->type              = HostBranch::HOST_HASH;
     }
-  } break;
+    tree[cur].leaves.push_back(index);
   }
 
-  return new_branch;
-}
+  // Number the nodes level by level, so the nodes near the root are close together.
+  std::vector<int> order{0};
+  std::vector<int> flat(tree.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    flat[order[i]] = i;
+    for (auto const &[label, child] : tree[order[i]].children) {
+      order.push_back(child);
+    }
+  }
 
-// HostBranch* HostLookup::FindNextLevel(HostBranch* from,
-//                                       const char* level_data)
-//
-//   Searches in the branch for  the next level down in the search
-//     structure bound to level data
-//   If found returns a pointer to the next level HostBranch,
-//    otherwise returns nullptr
-//
-HostBranch *
-HostLookup::FindNextLevel(HostBranch *from, string_view level_data, bool bNotProcess)
-{
-  HostBranch *r = nullptr;
-
-  switch (from->type) {
-  case HostBranch::HOST_TERMINAL:
-    // Should not happen
-    ink_assert(0);
-    break;
-  case HostBranch::HOST_HASH: {
-    auto table = from->next_level._table;
-    auto spot  = table->find(level_data);
-    r          = spot == table->end() ? nullptr : spot->second;
-  } break;
-  case HostBranch::HOST_INDEX:
-    r = from->next_level._index->Lookup(level_data);
-    break;
-  case HostBranch::HOST_ARRAY:
-    r = from->next_level._array->Lookup(level_data, bNotProcess);
-    break;
+  // Labels such as "www" are repeated under many nodes, keep one copy of each.
+  std::unordered_map<std::string, uint32_t> interned;
+
+  auto intern = [&](string_view label) -> uint32_t {
+    auto [spot, added] = interned.try_emplace(std::string{label}, keys.size());
+    if (added) {
+      keys.append(label);
+    }
+    return spot->second;
+  };
+
+  nodes.assign(tree.size(), Node{});
+  edges.clear();
+  leaf_indices.clear();
+  keys.clear();
+
+  for (size_t i = 0; i < order.size(); ++i) {
+    BuildNode const &b = tree[order[i]];
+    Node            &n = nodes[i];
+    bool             negation{i != 0 && b.children.size() <= HOST_ARRAY_MAX};
+
+    n.edge_begin = edges.size();
+    n.edge_count = b.children.size();
+    for (auto const &[label, child] : b.children) {
+      string_view key{label};
+      bool        negated{negation && !key.empty() && key.front() == '!'};
+      if (negated) {
+        key.remove_prefix(1);
+      }
+      edges.push_back(Edge{intern(key), static_cast<uint32_t>(key.size()), static_cast<uint32_t>(flat[child]), negated});
+    }
+    // A plain label sorts before its negation, so it is found first.
+    std::sort(edges.begin() + n.edge_begin, edges.end(), [this](Edge const &lhs, Edge const &rhs) {
+      int r = EdgeKey(lhs).compare(EdgeKey(rhs));
+      return r < 0 || (r == 0 && !lhs.negated && rhs.negated);
+    });
+
+    n.leaf_begin = leaf_indices.size();
+    n.leaf_count = b.leaves.size();
+    leaf_indices.insert(leaf_indices.end(), b.leaves.begin(), b.leaves.end());
   }
-  return r;
+
+  nodes.shrink_to_fit();
+  edges.shrink_to_fit();
+  leaf_indices.shrink_to_fit();
+  keys.shrink_to_fit();
 }
 
-// void HostLookup::TableInsert(const char* match_data, int index)
+// int HostLookup::FindNextLevel(int from, const char* level_data)
 //
-//   Insert the match data, index pair into domain/search table
+//   Searches the edges of node from for the next level down in the
+//     search trie bound to level data
+//   If found returns the index of the next level node,
+//    otherwise returns -1
 //
-//   arg index is the index into both Data and HostLeaf array for
-//    the elements corresponding to match_data
-//
-void
-HostLookup::TableInsert(string_view match_data, int index, bool domain_record)
+int
+HostLookup::FindNextLevel(int from, string_view level_data) const
 {
-  HostBranch *cur = &root;
-  HostBranch *next;
-  TextView    match{match_data};
+  Node const &n = nodes[from];
 
-  // Traverse down the search structure until we either
-  //       Get beyond the fixed number depth of the host table
-  //  OR   We reach the level where the match stops
-  //
-  for (int i = 0; !match.rtrim('.').empty() && i < HOST_TABLE_DEPTH; ++i) {
-    TextView token{match.take_suffix_at('.')};
-
-    if (cur->next_level._ptr == nullptr) {
-      cur = TableNewLevel(cur, token);
-    } else {
-      next = FindNextLevel(cur, token);
-      if (next == nullptr) {
-        cur = InsertBranch(cur, token);
-      } else {
-        cur = next;
-      }
-    }
+  if (level_data.empty() || n.edge_count == 0) {
+    return -1;
   }
 
-  // Update the leaf type.  There are three types:
-  //     HOST_PARTIAL - Indicates that part of the hostname name
-  //         was not matched by traversin the search structure since
-  //         it had too elements.  A comparison must be done at the
-  //         leaf node to make sure we have a match
-  //     HOST_COMPLETE - Indicates that the entire domain name
-  //         in the match_data was matched by traversing the search
-  //         structure, no further comparison is necessary
-  //
-  //     DOMAIN_COMPLETE - Indicates that the entire domain name
-  //         in the match_data was matched by traversing the search
-  //         structure, no further comparison is necessary
-  //     DOMAIN_PARTIAL - Indicates that part of the domain name
-  //         was not matched by traversin the search structure since
-  //         it had too elements.  A comparison must be done at the
-  //         leaf node to make sure we have a match
-  if (domain_record == false) {
-    if (match.empty()) {
-      leaf_array[index].type = HostLeaf::HOST_COMPLETE;
-    } else {
-      leaf_array[index].type = HostLeaf::HOST_PARTIAL;
-    }
-  } else {
-    if (match.empty()) {
-      leaf_array[index].type = HostLeaf::DOMAIN_COMPLETE;
-    } else {
-      leaf_array[index].type = HostLeaf::DOMAIN_PARTIAL;
-    }
+  auto first = edges.begin() + n.edge_begin;
+  auto last  = first + n.edge_count;
+
+  if (from == 0 && is_legal(level_data)) {
+    auto spot = std::lower_bound(first, last, level_data,
+                                 [this](Edge const &e, string_view label) { return fold_compare(EdgeKey(e), label) < 0; });
+    return spot != last && fold_compare(EdgeKey(*spot), level_data) == 0 ? static_cast<int>(spot->node) : -1;
   }
 
-  // Place the index in to leaf array into the match list for this
-  //   HOST_BRANCH
-  cur->leaf_indices.push_back(index);
+  auto spot = std::lower_bound(first, last, level_data, [this](Edge const &e, string_view label) { return EdgeKey(e) < label; });
+  return spot != last && EdgeKey(*spot) == level_data ? static_cast<int>(spot->node) : -1;
 }
 
-// bool HostLookup::MatchArray(HostLookupState* s, void**opaque_ptr, vector<int>& array,
-//                             bool host_done)
+// bool HostLookup::MatchArray(HostLookupState* s, void**opaque_ptr, bool host_done)
 //
-//  Helper function to iterate through arg array and update Result for each element in arg array
+//  Helper function to iterate through the leaves of the current node and update Result for each of them
 //
 //  host_done should be passed as true if this call represents the all fields in the matched against hostname being
 //  consumed.  Example: for www.example.com this would be true for the call matching against the "www", but neither of
@@ -828,12 +396,13 @@ HostLookup::TableInsert(string_view match_data, int index, bool domain_record)
 //
 
 bool
-HostLookup::MatchArray(HostLookupState *s, void **opaque_ptr, LeafIndices &array, bool host_done)
+HostLookup::MatchArray(HostLookupState *s, void **opaque_ptr, bool host_done) const
 {
-  size_t i;
+  Node const &n = nodes[s->node];
+  uint32_t    i;
 
-  for (i = s->array_index + 1; i < array.size(); ++i) {
-    auto &leaf{leaf_array[array[i]]};
+  for (i = s->array_index + 1; i < n.leaf_count; ++i) {
+    auto &leaf{leaf_array[leaf_indices[n.leaf_begin + i]]};
 
     switch (leaf.type) {
     case HostLeaf::HOST_PARTIAL:
@@ -878,9 +447,9 @@ HostLookup::MatchArray(HostLookupState *s, void **opaque_ptr, LeafIndices &array
 //
 //
 bool
-HostLookup::MatchFirst(string_view host, HostLookupState *s, void **opaque_ptr)
+HostLookup::MatchFirst(string_view host, HostLookupState *s, void **opaque_ptr) const
 {
-  s->cur           = &root;
+  s->node          = 0;
   s->table_level   = 0;
   s->array_index   = -1;
   s->hostname      = host;
@@ -891,21 +460,23 @@ HostLookup::MatchFirst(string_view host, HostLookupState *s, void **opaque_ptr)
 
 // bool HostLookup::MatchNext(HostLookupState* s, void** opaque_ptr)
 //
-//  Searches our tree and updates argresult for each element matching
+//  Searches our trie and updates argresult for each element matching
 //    arg hostname
 //
 bool
-HostLookup::MatchNext(HostLookupState *s, void **opaque_ptr)
+HostLookup::MatchNext(HostLookupState *s, void **opaque_ptr) const
 {
-  HostBranch *cur = s->cur;
-
   // Check to see if there is any work to be done
   if (leaf_array.size() <= 0) {
     return false;
   }
+  ink_assert(!nodes.empty()); // Finalize() was not called
+  if (nodes.empty()) {
+    return false;
+  }
 
   while (s->table_level <= HOST_TABLE_DEPTH) {
-    if (MatchArray(s, opaque_ptr, cur->leaf_indices, s->hostname_stub.empty())) {
+    if (MatchArray(s, opaque_ptr, s->hostname_stub.empty())) {
       return true;
     }
     // Check to see if we run out of tokens in the hostname
@@ -913,19 +484,19 @@ HostLookup::MatchNext(HostLookupState *s, void **opaque_ptr)
       break;
     }
     // Check to see if there are any lower levels
-    if (cur->type == HostBranch::HOST_TERMINAL) {
+    if (nodes[s->node].edge_count == 0) {
       break;
     }
 
     TextView name{s->hostname_stub};
     auto     token   = name.take_suffix_at('.');
     s->hostname_stub = name;
-    cur              = FindNextLevel(cur, token, true);
+    int next         = FindNextLevel(s->node, token);
 
-    if (cur == nullptr) {
+    if (next < 0) {
       break;
     } else {
-      s->cur         = cur;
+      s->node        = next;
       s->array_index = -1;
       ++(s->table_level);
     }
@@ -946,11 +517,52 @@ HostLookup::AllocateSpace(int num_entries)
 
 // void HostLookup::NewEntry(const char* match_data, bool domain_record, void* opaque_data_in)
 //
-//   Insert a new element in to the table
+//   Insert a new element in to the table, the trie must be rebuilt with
+//     Finalize() before it is matched.
 //
 void
 HostLookup::NewEntry(string_view match_data, bool domain_record, void *opaque_data_in)
 {
+  TextView match{match_data};
+
   leaf_array.emplace_back(match_data, opaque_data_in);
-  TableInsert(match_data, leaf_array.size() - 1, domain_record);
+  nodes.clear();
+
+  // Find how far down the trie the match data goes, it stops at the
+  //   fixed depth of the host table
+  //
+  for (int i = 0; !match.rtrim('.').empty() && i < HOST_TABLE_DEPTH; ++i) {
+    match.take_suffix_at('.');
+  }
+
+  // Update the leaf type.  There are three types:
+  //     HOST_PARTIAL - Indicates that part of the hostname name
+  //         was not matched by traversin the search structure since
+  //         it had too elements.  A comparison must be done at the
+  //         leaf node to make sure we have a match
+  //     HOST_COMPLETE - Indicates that the entire domain name
+  //         in the match_data was matched by traversing the search
+  //         structure, no further comparison is necessary
+  //
+  //     DOMAIN_COMPLETE - Indicates that the entire domain name
+  //         in the match_data was matched by traversing the search
+  //         structure, no further comparison is necessary
+  //     DOMAIN_PARTIAL - Indicates that part of the domain name
+  //         was not matched by traversin the search structure since
+  //         it had too elements.  A comparison must be done at the
+  //         leaf node to make sure we have a match
+  HostLeaf &leaf = leaf_array.back();
+  if (domain_record == false) {
+    if (match.empty()) {
+      leaf.type = HostLeaf::HOST_COMPLETE;
+    } else {
+      leaf.type = HostLeaf::HOST_PARTIAL;
+    }
+  } else {
+    if (match.empty()) {
+      leaf.type = HostLeaf::DOMAIN_COMPLETE;
+    } else {
+      leaf.type = HostLeaf::DOMAIN_PARTIAL;
+    }
+  }
 }
@@ -23,6 +23,13 @@
 #include "tscore/ink_platform.h"
 #include "tsutil/DbgCtl.h"
 
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <sys/sysmacros.h>
+#endif
+
 static DbgCtl dbg_ctl_threads{"threads"};
 
 #if TS_USE_HWLOC
@@ -80,3 +87,45 @@ ink_number_of_processors()
 
   return number_of_processors;
 }
+
+int
+ink_fd_numa_node(int fd)
+{
+#if defined(__linux__)
+  struct stat st;
+
+  if (fstat(fd, &st) != 0) {
+    return -1;
+  }
+
+  // A raw device is looked up by itself, a file by the device of its file system.
+  dev_t dev = S_ISBLK(st.st_mode) ? st.st_rdev : st.st_dev;
+  char  link[64];
+  snprintf(link, sizeof(link), "/sys/dev/block/%u:%u", major(dev), minor(dev));
+
+  char *real = realpath(link, nullptr);
+  if (real == nullptr) {
+    return -1;
+  }
+
+  // The block device (or partition) itself has no NUMA node, the PCI device it hangs off does.
+  std::string path = real;
+  free(real);
+  while (path.size() > sizeof("/sys/devices")) {
+    if (FILE *f = fopen((path + "/numa_node").c_str(), "r"); f != nullptr) {
+      int node = -1;
+      if (fscanf(f, "%d", &node) != 1) {
+        node = -1;
+      }
+      fclose(f);
+      Dbg(dbg_ctl_threads, "NUMA node of %s is %d", path.c_str(), node);
+      return node;
+    }
+    path.erase(path.rfind('/'));
+  }
+#else
+  (void)fd;
+#endif
+
+  return -1;
+}
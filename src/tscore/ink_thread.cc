@@ -39,6 +39,20 @@ ink_mutex ink_mutex_initializer = INK_MUTEX_INIT;
 static int64_t ink_semaphore_count = 0;
 #endif
 
+static thread_local int ink_thread_numa_node = -1;
+
+int
+ink_numa_node()
+{
+  return ink_thread_numa_node;
+}
+
+void
+ink_set_numa_node(int node)
+{
+  ink_thread_numa_node = node;
+}
+
 void
 ink_sem_init(ink_semaphore *sp, unsigned int count)
 {
@@ -0,0 +1,181 @@
+/** @file
+
+  Unit tests for the Maglev algorithm of ATSConsistentHash
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+
+      http://www.apache.org/licenses/LICENSE-2.0
+
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#include "catch.hpp"
+
+#include "tscore/ConsistentHash.h"
+#include "tscore/HashSip.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr int REPLICAS = 16;
+constexpr int NKEYS    = 20000;
+
+struct TestNode : ATSConsistentHashNode {
+  explicit TestNode(std::string const &n) : label(n) { name = label.data(); }
+
+  std::string label;
+};
+
+std::vector<std::unique_ptr<TestNode>>
+make_nodes(int n)
+{
+  std::vector<std::unique_ptr<TestNode>> nodes;
+  for (int i = 0; i < n; ++i) {
+    nodes.push_back(std::make_unique<TestNode>("parent" + std::to_string(i) + ".example.com"));
+  }
+  return nodes;
+}
+
+std::unique_ptr<ATSConsistentHash>
+make_maglev()
+{
+  return std::make_unique<ATSConsistentHash>(REPLICAS, new ATSHash64Sip24, ATSConsistentHash::Algorithm::MAGLEV);
+}
+
+// Walk the table from its first slot and count the slots of each node.
+std::map<ATSConsistentHashNode *, size_t>
+slot_counts(ATSConsistentHash &hash, size_t &size)
+{
+  std::map<ATSConsistentHashNode *, size_t> counts;
+  ATSConsistentHashIter                     iter    = 0;
+  bool                                      wrapped = false;
+
+  size = 0;
+  for (auto *node = hash.lookup_by_hashval(0, &iter, &wrapped); !wrapped; node = hash.lookup(nullptr, &iter, &wrapped)) {
+    ++counts[node];
+    ++size;
+  }
+  return counts;
+}
+
+std::vector<ATSConsistentHashNode *>
+lookup_keys(ATSConsistentHash &hash)
+{
+  std::vector<ATSConsistentHashNode *> result;
+  for (int i = 0; i < NKEYS; ++i) {
+    std::string url = "http://www.example.com/object/" + std::to_string(i);
+    result.push_back(hash.lookup(url.c_str()));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("ConsistentHash Maglev table fill", "[libts][ConsistentHash]")
+{
+  auto nodes = make_nodes(5);
+  auto hash  = make_maglev();
+
+  REQUIRE(hash->lookup_by_hashval(0) == nullptr);
+
+  for (auto &n : nodes) {
+    hash->insert(n.get());
+  }
+
+  size_t size   = 0;
+  auto   counts = slot_counts(*hash, size);
+
+  // The smallest prime of at least 64 slots per replica, every slot taken by an inserted node.
+  CHECK(size == 1031);
+  CHECK(counts.count(nullptr) == 0);
+  REQUIRE(counts.size() == nodes.size());
+  for (auto &n : nodes) {
+    CHECK(counts[n.get()] >= size / nodes.size() - 1);
+    CHECK(counts[n.get()] <= size / nodes.size() + 1);
+  }
+}
+
+TEST_CASE("ConsistentHash Maglev weights", "[libts][ConsistentHash]")
+{
+  auto nodes = make_nodes(4);
+  auto hash  = make_maglev();
+
+  hash->insert(nodes[0].get(), 1.0);
+  hash->insert(nodes[1].get(), 2.0);
+  hash->insert(nodes[2].get(), 0.5);
+  // A node without weight gets no slot.
+  hash->insert(nodes[3].get(), 0.0);
+
+  size_t size   = 0;
+  auto   counts = slot_counts(*hash, size);
+
+  REQUIRE(size > 0);
+  CHECK(counts.count(nodes[3].get()) == 0);
+  CHECK(counts[nodes[0].get()] + counts[nodes[1].get()] + counts[nodes[2].get()] == size);
+
+  // Shares of 1 : 2 : 0.5 of the table.
+  double const total = 3.5;
+  CHECK(counts[nodes[0].get()] == Approx(size * 1.0 / total).epsilon(0.02));
+  CHECK(counts[nodes[1].get()] == Approx(size * 2.0 / total).epsilon(0.02));
+  CHECK(counts[nodes[2].get()] == Approx(size * 0.5 / total).epsilon(0.02));
+}
+
+TEST_CASE("ConsistentHash Maglev stability", "[libts][ConsistentHash]")
+{
+  auto nodes = make_nodes(11);
+
+  // The same nodes give the same table, whatever the instance.
+  auto a = make_maglev();
+  auto b = make_maglev();
+  for (int i = 0; i < 10; ++i) {
+    a->insert(nodes[i].get());
+    b->insert(nodes[i].get());
+  }
+  auto before = lookup_keys(*a);
+  CHECK(lookup_keys(*b) == before);
+
+  // An insert after lookups rebuilds the table, and mostly moves keys to the new node.
+  a->insert(nodes[10].get());
+  auto after = lookup_keys(*a);
+
+  int to_new = 0, between_old = 0;
+  for (int i = 0; i < NKEYS; ++i) {
+    if (after[i] == nodes[10].get()) {
+      ++to_new;
+    } else if (after[i] != before[i]) {
+      ++between_old;
+    }
+  }
+  // Maglev does not promise minimal disruption, a few percent of the keys may move between the
+  // old nodes with this small a table.
+  CHECK(to_new == Approx(NKEYS / 11.0).epsilon(0.1));
+  CHECK(between_old < NKEYS / 20);
+
+  // An unavailable node is skipped, only its own keys go elsewhere.
+  nodes[10]->available = false;
+  for (int i = 0; i < NKEYS; i += 97) {
+    std::string            url  = "http://www.example.com/object/" + std::to_string(i);
+    ATSConsistentHashNode *node = a->lookup_available(url.c_str());
+    REQUIRE(node != nullptr);
+    CHECK(node != nodes[10].get());
+    if (after[i] != nodes[10].get()) {
+      CHECK(node == after[i]);
+    }
+  }
+}
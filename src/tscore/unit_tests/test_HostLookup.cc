@@ -0,0 +1,107 @@
+/** @file
+
+    HostLookup tests.
+
+    @section license License
+
+    Licensed to the Apache Software Foundation (ASF) under one
+    or more contributor license agreements.  See the NOTICE file
+    distributed with this work for additional information
+    regarding copyright ownership.  The ASF licenses this file
+    to you under the Apache License, Version 2.0 (the
+    "License"); you may not use this file except in compliance
+    with the License.  You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "tscore/HostLookup.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <catch.hpp>
+
+namespace
+{
+// Entries are numbered from 1 in the order they are added.
+std::vector<intptr_t>
+match_all(HostLookup const &hl, std::string_view host)
+{
+  std::vector<intptr_t> result;
+  HostLookupState       s;
+  void                 *opaque;
+
+  for (bool r = hl.MatchFirst(host, &s, &opaque); r; r = hl.MatchNext(&s, &opaque)) {
+    result.push_back(reinterpret_cast<intptr_t>(opaque));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST_CASE("HostLookup", "[libts][HostLookup]")
+{
+  HostLookup hl("test");
+  intptr_t   n = 0;
+
+  hl.NewEntry("example.com", true, reinterpret_cast<void *>(++n));          // 1
+  hl.NewEntry("www.example.com", false, reinterpret_cast<void *>(++n));     // 2
+  hl.NewEntry("a.b.www.example.com", false, reinterpret_cast<void *>(++n)); // 3
+  hl.NewEntry("deep.a.b.example.com", true, reinterpret_cast<void *>(++n)); // 4
+  hl.NewEntry("!img.example.net", false, reinterpret_cast<void *>(++n));    // 5
+  hl.NewEntry("Example.ORG.", true, reinterpret_cast<void *>(++n));         // 6
+  hl.Finalize();
+
+  // Domains match the name and everything below it, hosts only the name.
+  CHECK(match_all(hl, "example.com") == std::vector<intptr_t>{1});
+  CHECK(match_all(hl, "www.example.com") == std::vector<intptr_t>{1, 2});
+  CHECK(match_all(hl, "mail.www.example.com") == std::vector<intptr_t>{1});
+  CHECK(match_all(hl, "notexample.com").empty());
+
+  // Names deeper than the trie are compared at the leaf.
+  CHECK(match_all(hl, "a.b.www.example.com") == std::vector<intptr_t>{1, 3});
+  CHECK(match_all(hl, "c.b.www.example.com") == std::vector<intptr_t>{1});
+  CHECK(match_all(hl, "x.deep.a.b.example.com") == std::vector<intptr_t>{1, 4});
+
+  // The top level label is case insensitive, the trailing dot of an entry is optional.
+  CHECK(match_all(hl, "www.example.COM") == std::vector<intptr_t>{1, 2});
+  CHECK(match_all(hl, "Example.org") == std::vector<intptr_t>{6});
+
+  // A negated label matches the plain label.
+  CHECK(match_all(hl, "img.example.net") == std::vector<intptr_t>{5});
+  CHECK(hl.get_leaf_array()->at(4).isNot == true);
+
+  CHECK(match_all(hl, "").empty());
+  CHECK(match_all(hl, "com").empty());
+}
+
+TEST_CASE("HostLookup wide", "[libts][HostLookup]")
+{
+  HostLookup hl("test");
+
+  // More than HOST_ARRAY_MAX children below one node.
+  for (intptr_t i = 1; i <= 3 * HOST_ARRAY_MAX; ++i) {
+    std::string name = "h" + std::to_string(i) + ".example.com";
+    hl.NewEntry(name, false, reinterpret_cast<void *>(i));
+  }
+  hl.Finalize();
+
+  for (intptr_t i = 1; i <= 3 * HOST_ARRAY_MAX; ++i) {
+    std::string name = "h" + std::to_string(i) + ".example.com";
+    CHECK(match_all(hl, name) == std::vector<intptr_t>{i});
+  }
+  CHECK(match_all(hl, "h0.example.com").empty());
+
+  // Entries added after Finalize need another Finalize, shallower entries match first.
+  hl.NewEntry("example.com", true, reinterpret_cast<void *>(100));
+  hl.Finalize();
+  CHECK(match_all(hl, "h1.example.com") == std::vector<intptr_t>{100, 1});
+}
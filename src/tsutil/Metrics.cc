@@ -22,6 +22,7 @@
  */
 
 #include "tsutil/Assert.h"
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <variant>
@@ -246,8 +247,80 @@ namespace details
     }
   };
 
+  struct ShardedCounters {
+    using Counter = Metrics::ShardedCounter::AtomicType;
+
+    // One row of slots per thread, for SHARD_WIDTH counters. A thread only ever writes into its own row.
+    struct alignas(64) Row {
+      std::array<std::atomic<int64_t>, Metrics::ShardedCounter::SHARD_WIDTH> slots;
+    };
+    static_assert(sizeof(Row) == Metrics::ShardedCounter::SHARD_WIDTH * sizeof(std::atomic<int64_t>));
+
+    std::vector<std::unique_ptr<Row[]>>            chunks;
+    std::deque<Counter>                            counters;
+    std::unordered_map<Metrics::IdType, Counter *> ids;
+    size_t                                         rows = DenseThreadId::num_possible_values();
+    std::mutex                                     counters_lock;
+
+    static ShardedCounters &
+    instance()
+    {
+      static ShardedCounters theShardedCounters;
+      return theShardedCounters;
+    }
+  };
+
 } // namespace details
 
+Metrics::ShardedCounter::AtomicType *
+Metrics::ShardedCounter::lookup(const IdType id)
+{
+  auto           &sharded = details::ShardedCounters::instance();
+  std::lock_guard l(sharded.counters_lock);
+  auto            it = sharded.ids.find(id);
+
+  return (it != sharded.ids.end() ? it->second : nullptr);
+}
+
+Metrics::IdType
+Metrics::ShardedCounter::create(const std::string_view name)
+{
+  auto           &instance = Metrics::instance();
+  auto           &sharded  = details::ShardedCounters::instance();
+  Metrics::IdType id       = instance._create(name);
+  std::lock_guard l(sharded.counters_lock);
+
+  if (sharded.ids.find(id) != sharded.ids.end()) {
+    return id;
+  }
+
+  size_t ix = sharded.counters.size() % SHARD_WIDTH;
+
+  if (0 == ix) {
+    sharded.chunks.emplace_back(new details::ShardedCounters::Row[sharded.rows]());
+  }
+
+  auto &counter = sharded.counters.emplace_back();
+
+  counter._base      = &sharded.chunks.back()[0].slots[ix];
+  counter._rows      = sharded.rows;
+  counter._published = instance.lookup(id);
+  sharded.ids.emplace(id, &counter);
+
+  return id;
+}
+
+void
+Metrics::ShardedCounter::sync()
+{
+  auto           &sharded = details::ShardedCounters::instance();
+  std::lock_guard l(sharded.counters_lock);
+
+  for (auto &c : sharded.counters) {
+    c._published->store(c.load());
+  }
+}
+
 void
 Metrics::Derived::derive(const std::initializer_list<Metrics::Derived::DerivedMetricSpec> &metrics)
 {
@@ -28,6 +28,8 @@
 #include <pcre2.h>
 
 #include <array>
+#include <cctype>
+#include <cstring>
 #include <vector>
 #include <mutex>
 
@@ -383,3 +385,352 @@ DFA::match(std::string_view str) const
 
   return -1;
 }
+
+//----------------------------------------------------------------------------
+namespace
+{
+/** Find the longest literal that every match of @a pattern must contain.
+ *
+ * Only the top level of the pattern is considered, groups and character classes end a literal. A pattern with a top
+ * level alternative, an option setting or a construct not handled here has no literal.
+ *
+ * @param pure Set if the pattern is nothing but the literal.
+ * @return The literal, empty if there is none.
+ */
+std::string
+required_literal(std::string_view pattern, bool &pure)
+{
+  std::string best;
+  std::string cur;
+  size_t      i = 0;
+  size_t      n = pattern.size();
+
+  pure = true;
+
+  auto end_run = [&]() {
+    if (cur.size() > best.size()) {
+      best = cur;
+    }
+    cur.clear();
+  };
+  auto is_digit = [](char c) { return '0' <= c && c <= '9'; };
+  // Length of the counted quantifier at @a j, 0 if the brace is a literal.
+  auto brace_len = [&](size_t j) -> size_t {
+    size_t k = j + 1;
+    while (k < n && (is_digit(pattern[k]) || pattern[k] == ',')) {
+      ++k;
+    }
+    return (k < n && pattern[k] == '}' && k > j + 1) ? k - j + 1 : 0;
+  };
+  // Skip a character class starting at @a j, returns the index after it or @a n if it is not closed.
+  auto skip_class = [&](size_t j) -> size_t {
+    ++j;
+    if (j < n && pattern[j] == '^') {
+      ++j;
+    }
+    if (j < n && pattern[j] == ']') {
+      ++j;
+    }
+    while (j < n && pattern[j] != ']') {
+      if (pattern[j] == '\\') {
+        j += 2;
+      } else if (pattern[j] == '[' && j + 1 < n && pattern[j + 1] == ':') {
+        size_t close = pattern.find(":]", j + 2);
+        j            = close == std::string_view::npos ? n : close + 2;
+      } else {
+        ++j;
+      }
+    }
+    return j < n ? j + 1 : n;
+  };
+
+  while (i < n) {
+    char c = pattern[i];
+    bool literal;
+
+    switch (c) {
+    case '\\': {
+      if (i + 1 >= n) {
+        return {};
+      }
+      char d = pattern[i + 1];
+      if (isalnum(static_cast<unsigned char>(d))) {
+        // Character type escapes end the literal, anything else (\Q, \x, back references ...) is not handled.
+        if (strchr("dDwWsSbBhHvVRAzZG", d) == nullptr) {
+          return {};
+        }
+        literal = false;
+      } else {
+        c       = d;
+        literal = true;
+      }
+      i += 2;
+      break;
+    }
+    case '[':
+      i       = skip_class(i);
+      literal = false;
+      break;
+    case '(': {
+      // Options, assertions and verbs may change how the rest of the pattern matches.
+      if (i + 1 < n && (pattern[i + 1] == '?' || pattern[i + 1] == '*')) {
+        return {};
+      }
+      int depth = 0;
+      while (i < n) {
+        if (pattern[i] == '\\') {
+          i += 2;
+          continue;
+        } else if (pattern[i] == '[') {
+          i = skip_class(i);
+          continue;
+        } else if (pattern[i] == '(') {
+          ++depth;
+        } else if (pattern[i] == ')' && --depth == 0) {
+          break;
+        }
+        ++i;
+      }
+      if (i >= n) {
+        return {};
+      }
+      ++i;
+      literal = false;
+      break;
+    }
+    case '|':
+    case ')':
+      return {};
+    case '.':
+    case '^':
+    case '$':
+    case '*':
+    case '+':
+    case '?':
+      ++i;
+      literal = false;
+      break;
+    case '{':
+      if (size_t len = brace_len(i); len > 0) {
+        i       += len;
+        literal  = false;
+      } else {
+        ++i;
+        literal = true;
+      }
+      break;
+    default:
+      ++i;
+      literal = true;
+      break;
+    }
+
+    if (!literal) {
+      pure = false;
+      end_run();
+      continue;
+    }
+
+    // A quantifier applies to the last character only.
+    size_t qlen = 0;
+    bool   keep = true;
+    if (i < n) {
+      if (pattern[i] == '*' || pattern[i] == '?') {
+        qlen = 1;
+        keep = false;
+      } else if (pattern[i] == '+') {
+        qlen = 1;
+      } else if (pattern[i] == '{') {
+        qlen = brace_len(i);
+        keep = qlen == 0 || (is_digit(pattern[i + 1]) && pattern[i + 1] != '0');
+      }
+    }
+    if (keep) {
+      cur += c;
+    }
+    if (qlen > 0) {
+      pure = false;
+      end_run();
+      i += qlen;
+      // Lazy or possessive modifier.
+      if (i < n && (pattern[i] == '?' || pattern[i] == '+')) {
+        ++i;
+      }
+    }
+  }
+  end_run();
+
+  if (best.empty()) {
+    pure = false;
+  }
+  return best;
+}
+
+// Shorter literals occur in most subjects and are not worth checking, unless they are the whole pattern.
+constexpr size_t MIN_PREFILTER_LITERAL = 3;
+
+} // namespace
+
+//----------------------------------------------------------------------------
+bool
+RegexSet::add(std::string_view pattern, std::string &error, int &erroffset, unsigned flags)
+{
+  Pattern p;
+
+  if (!p._re.compile(pattern, error, erroffset, flags)) {
+    return false;
+  }
+  _set_literal(p, pattern, flags);
+  _patterns.emplace_back(std::move(p));
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void
+RegexSet::add_prefilter(std::string_view pattern, unsigned flags)
+{
+  Pattern p;
+
+  _set_literal(p, pattern, flags);
+  _patterns.emplace_back(std::move(p));
+}
+
+//----------------------------------------------------------------------------
+void
+RegexSet::pop_back()
+{
+  _patterns.pop_back();
+}
+
+//----------------------------------------------------------------------------
+void
+RegexSet::_set_literal(Pattern &p, std::string_view pattern, unsigned flags)
+{
+  if (!(flags & (RE_CASE_INSENSITIVE | RE_ANCHORED))) {
+    p._literal = required_literal(pattern, p._pure);
+    if (!p._pure && p._literal.size() < MIN_PREFILTER_LITERAL) {
+      p._literal.clear();
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+void
+RegexSet::finalize()
+{
+  _next.clear();
+  _output.clear();
+  _suffix.clear();
+  _outputs.clear();
+  std::fill(std::begin(_byte_class), std::end(_byte_class), 0);
+  _nclasses = 1;
+
+  for (auto const &p : _patterns) {
+    for (char c : p._literal) {
+      auto &cls = _byte_class[static_cast<uint8_t>(c)];
+      if (cls == 0) {
+        cls = _nclasses++;
+      }
+    }
+  }
+
+  // Trie of the literals, with the patterns ending at each node.
+  std::vector<std::vector<int32_t>> ends(1);
+  _next.assign(_nclasses, -1);
+  for (int32_t idx = 0, n = _patterns.size(); idx < n; ++idx) {
+    auto const &lit = _patterns[idx]._literal;
+    if (lit.empty()) {
+      continue;
+    }
+    int32_t node = 0;
+    for (char c : lit) {
+      int32_t &next = _next[node * _nclasses + _byte_class[static_cast<uint8_t>(c)]];
+      if (next < 0) {
+        next = ends.size();
+        ends.emplace_back();
+        _next.resize(_next.size() + _nclasses, -1);
+      }
+      node = _next[node * _nclasses + _byte_class[static_cast<uint8_t>(c)]];
+    }
+    ends[node].push_back(idx);
+  }
+
+  // Breadth first, turn the trie into a complete transition table and link each node to its output suffix.
+  int32_t              nnodes = ends.size();
+  std::vector<int32_t> fail(nnodes, 0);
+  std::vector<int32_t> queue;
+  _suffix.assign(nnodes, -1);
+  queue.reserve(nnodes);
+  for (int32_t cls = 0; cls < _nclasses; ++cls) {
+    int32_t &next = _next[cls];
+    if (next < 0) {
+      next = 0;
+    } else {
+      queue.push_back(next);
+    }
+  }
+  for (size_t q = 0; q < queue.size(); ++q) {
+    int32_t node = queue[q];
+    int32_t f    = fail[node];
+    _suffix[node] = ends[f].empty() ? _suffix[f] : f;
+    for (int32_t cls = 0; cls < _nclasses; ++cls) {
+      int32_t &next = _next[node * _nclasses + cls];
+      if (next < 0) {
+        next = _next[f * _nclasses + cls];
+      } else {
+        fail[next] = _next[f * _nclasses + cls];
+        queue.push_back(next);
+      }
+    }
+  }
+
+  _output.assign(nnodes, -1);
+  for (int32_t node = 0; node < nnodes; ++node) {
+    if (!ends[node].empty()) {
+      _output[node] = _outputs.size();
+      _outputs.insert(_outputs.end(), ends[node].begin(), ends[node].end());
+      _outputs.push_back(-1);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+int32_t
+RegexSet::literal_count() const
+{
+  return std::count_if(_patterns.begin(), _patterns.end(), [](Pattern const &p) { return !p._literal.empty(); });
+}
+
+//----------------------------------------------------------------------------
+void
+RegexSet::_scan(std::string_view subject, uint64_t *hits) const
+{
+  if (_output.empty()) {
+    return;
+  }
+
+  int32_t node = 0;
+  for (char c : subject) {
+    node = _next[node * _nclasses + _byte_class[static_cast<uint8_t>(c)]];
+    for (int32_t out = _output[node] >= 0 ? node : _suffix[node]; out >= 0; out = _suffix[out]) {
+      for (int32_t const *idx = &_outputs[_output[out]]; *idx >= 0; ++idx) {
+        hits[*idx / 64] |= uint64_t{1} << (*idx % 64);
+      }
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+bool
+RegexSet::_matches(int32_t idx, std::string_view subject, const uint64_t *hits) const
+{
+  Pattern const &p = _patterns[idx];
+
+  if (p._literal.empty()) {
+    return p._re.exec(subject);
+  }
+  if (!(hits[idx / 64] & (uint64_t{1} << (idx % 64)))) {
+    return false;
+  }
+  return p._pure || p._re.exec(subject);
+}
@@ -24,6 +24,10 @@
 #include "catch.hpp"
 
 #include "tsutil/Metrics.h"
+
+#include <thread>
+#include <vector>
+
 using ts::Metrics;
 
 TEST_CASE("Metrics", "[libtsapi][Metrics]")
@@ -132,4 +136,33 @@ TEST_CASE("Metrics", "[libtsapi][Metrics]")
     REQUIRE(m[derivedcd].load() == 5);
     REQUIRE(m[derivedce].load() == 10);
   }
+
+  SECTION("sharded")
+  {
+    auto shid = Metrics::ShardedCounter::create("sharded");
+    auto sh   = Metrics::ShardedCounter::lookup(shid);
+
+    REQUIRE(sh != nullptr);
+    REQUIRE(Metrics::ShardedCounter::create("sharded") == shid);
+    REQUIRE(Metrics::ShardedCounter::lookup(m.lookup("foo-new")) == nullptr);
+
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 4; ++i) {
+      threads.emplace_back([sh]() {
+        for (int j = 0; j < 1000; ++j) {
+          Metrics::ShardedCounter::increment(sh);
+        }
+      });
+    }
+    for (auto &t : threads) {
+      t.join();
+    }
+
+    REQUIRE(Metrics::ShardedCounter::load(sh) == 4000);
+    REQUIRE(m[shid].load() == 0); // Not published yet
+
+    Metrics::ShardedCounter::sync();
+    REQUIRE(m[shid].load() == 4000);
+  }
 }
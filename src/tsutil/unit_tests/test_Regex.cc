@@ -20,6 +20,7 @@
   limitations under the License.
 */
 
+#include <algorithm>
 #include <string_view>
 #include <vector>
 
@@ -190,3 +191,104 @@ TEST_CASE("Regex", "[libts][Regex]")
   }
 #endif
 }
+
+TEST_CASE("RegexSet", "[libts][Regex]")
+{
+  // Literal, prefiltered, and unfiltered patterns, the set must agree with matching each one alone.
+  std::vector<std::string_view> patterns{
+    R"(example\.com)",
+    R"(^http://www\.example\.com/)",
+    R"(\.jpe?g$)",
+    R"(/images/.*\.png)",
+    R"(^https?://[^/]+/api/v[0-9]+/)",
+    R"(ab+cde)",
+    R"(colou?r)",
+    R"(x{2,}yzw)",
+    R"(a{0}bcd)",
+    R"(foo|bar)",
+    R"((?i)EXAMPLE)",
+    R"(tracking(_id)?=)",
+    R"(\d{3}-\d{4})",
+    R"(static)",
+    R"([.]cdn[.])",
+    R"(.)",
+  };
+  std::vector<std::string_view> subjects{
+    "http://www.example.com/index.html",
+    "https://img.example.net/images/logo.png",
+    "https://api.example.org/api/v2/items",
+    "http://static.cdn.example/photo.jpeg",
+    "http://example.org/?tracking=1&color=red",
+    "abbbcde xxyzw bcd 555-1234",
+    "acde xyzw",
+    "http://foo.test/colour",
+    "",
+    "a",
+  };
+
+  RegexSet    set;
+  std::string error;
+  int         erroffset;
+  for (auto p : patterns) {
+    REQUIRE(set.add(p, error, erroffset) == true);
+  }
+  REQUIRE(set.add(R"((\d+)", error, erroffset) == false);
+  // A pattern taken back does not take part in matching.
+  REQUIRE(set.add("example", error, erroffset) == true);
+  set.pop_back();
+  set.finalize();
+  REQUIRE(set.size() == static_cast<int32_t>(patterns.size()));
+  // foo|bar, (?i)EXAMPLE, \d{3}-\d{4} and . have no literal.
+  REQUIRE(set.literal_count() == static_cast<int32_t>(patterns.size()) - 4);
+
+  for (auto subject : subjects) {
+    std::vector<int32_t> expected;
+    for (size_t i = 0; i < patterns.size(); ++i) {
+      Regex r;
+      REQUIRE(r.compile(patterns[i]) == true);
+      if (r.exec(subject)) {
+        expected.push_back(i);
+      }
+    }
+
+    std::vector<int32_t> matched;
+    set.match(subject, [&](int32_t idx) { matched.push_back(idx); });
+    CHECK(matched == expected);
+
+    // Every match is a candidate, and candidates stop at the first match.
+    std::vector<int32_t> candidates;
+    int32_t              first = set.candidates(subject, [&](int32_t idx) {
+      candidates.push_back(idx);
+      return false;
+    });
+    CHECK(first == -1);
+    CHECK(std::includes(candidates.begin(), candidates.end(), expected.begin(), expected.end()));
+    first = set.candidates(subject, [&](int32_t idx) {
+      Regex r;
+      REQUIRE(r.compile(patterns[idx]) == true);
+      return r.exec(subject);
+    });
+    CHECK(first == (expected.empty() ? -1 : expected.front()));
+  }
+
+  // A prefilter only set gives the same candidates without compiling the patterns.
+  RegexSet prefilter;
+  for (auto p : patterns) {
+    prefilter.add_prefilter(p);
+  }
+  prefilter.finalize();
+  REQUIRE(prefilter.literal_count() == set.literal_count());
+  for (auto subject : subjects) {
+    std::vector<int32_t> expected;
+    std::vector<int32_t> candidates;
+    set.candidates(subject, [&](int32_t idx) {
+      expected.push_back(idx);
+      return false;
+    });
+    prefilter.candidates(subject, [&](int32_t idx) {
+      candidates.push_back(idx);
+      return false;
+    });
+    CHECK(candidates == expected);
+  }
+}
@@ -0,0 +1,80 @@
+'''
+Verify that spliced tunnels deliver the whole body
+'''
+#  Licensed to the Apache Software Foundation (ASF) under one
+#  or more contributor license agreements.  See the NOTICE file
+#  distributed with this work for additional information
+#  regarding copyright ownership.  The ASF licenses this file
+#  to you under the Apache License, Version 2.0 (the
+#  "License"); you may not use this file except in compliance
+#  with the License.  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+
+import re
+import sys
+
+Test.Summary = '''
+Verify that spliced tunnels deliver the whole body when the origin finishes
+while the pipe still holds data for a slow client.
+'''
+
+# Large enough that the origin is done long before the rate limited client.
+body_size = 2 * 1024 * 1024
+
+Test.GetTcpPort("origin_port")
+
+origin = Test.Processes.Process(
+    "origin", f'{sys.executable} {Test.TestDirectory}/splice_origin.py --port {Test.Variables.origin_port} --size {body_size}')
+origin.Ready = When.PortOpenv4(Test.Variables.origin_port)
+
+ts = Test.MakeATSProcess("ts", enable_cache=False)
+ts.Disk.remap_config.AddLine(f'map / http://127.0.0.1:{Test.Variables.origin_port}/')
+ts.Disk.records_config.update(
+    {
+        'proxy.config.diags.debug.enabled': 1,
+        'proxy.config.diags.debug.tags': 'http_tunnel|iocore_net',
+        'proxy.config.http.tunnel_splice': 1,
+        'proxy.config.http.connect_ports': f'{Test.Variables.origin_port}',
+    })
+
+curl_args = f"-s -w '%{{size_download}}\\n' --limit-rate 1M"
+
+# The server session goes back to the pool after READ_COMPLETE, the second
+# request reuses it while the body of the first may still be in the pipe.
+tr = Test.AddTestRun("Content-Length response on a keep-alive origin connection")
+tr.Processes.Default.StartBefore(origin)
+tr.Processes.Default.StartBefore(ts)
+tr.MakeCurlCommand(
+    f"{curl_args} -o /dev/null http://127.0.0.1:{ts.Variables.port}/keepalive "
+    f"-o /dev/null http://127.0.0.1:{ts.Variables.port}/keepalive")
+tr.Processes.Default.ReturnCode = 0
+tr.Processes.Default.Streams.stdout = Testers.ContainsExpression(
+    f"^{body_size}\n{body_size}$", "Both responses are complete", reflags=re.MULTILINE)
+tr.StillRunningAfter = origin
+tr.StillRunningAfter = ts
+
+# The origin closes after the body, so the server connection is closed while
+# the pipe holds data.
+tr = Test.AddTestRun("Content-Length response with Connection: close")
+tr.MakeCurlCommand(f"{curl_args} -o /dev/null http://127.0.0.1:{ts.Variables.port}/close")
+tr.Processes.Default.ReturnCode = 0
+tr.Processes.Default.Streams.stdout = Testers.ContainsExpression(f"^{body_size}$", "The response is complete", reflags=re.MULTILINE)
+tr.StillRunningAfter = origin
+tr.StillRunningAfter = ts
+
+# A blind tunnel sees EOS from the origin and closes it.
+tr = Test.AddTestRun("Blind tunnel closed by the origin")
+tr.MakeCurlCommand(
+    f"{curl_args} -o /dev/null --proxytunnel -x http://127.0.0.1:{ts.Variables.port} "
+    f"http://127.0.0.1:{Test.Variables.origin_port}/close")
+tr.Processes.Default.ReturnCode = 0
+tr.Processes.Default.Streams.stdout = Testers.ContainsExpression(f"^{body_size}$", "The response is complete", reflags=re.MULTILINE)
+tr.StillRunningAfter = origin
+tr.StillRunningAfter = ts
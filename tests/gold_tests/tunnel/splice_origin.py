@@ -0,0 +1,77 @@
+'''
+An origin that answers every request with a large Content-Length body, sent
+as fast as the socket takes it.  A request for /close gets Connection: close
+and the connection is closed after the body.
+'''
+#  Licensed to the Apache Software Foundation (ASF) under one
+#  or more contributor license agreements.  See the NOTICE file
+#  distributed with this work for additional information
+#  regarding copyright ownership.  The ASF licenses this file
+#  to you under the Apache License, Version 2.0 (the
+#  "License"); you may not use this file except in compliance
+#  with the License.  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+
+import argparse
+import socket
+import threading
+
+
+def parse_args() -> argparse.Namespace:
+    """Parse command line arguments."""
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--port', type=int, required=True, help='Port to listen on.')
+    parser.add_argument('--size', type=int, required=True, help='Size of each response body.')
+    return parser.parse_args()
+
+
+def read_request(conn: socket.socket, pending: bytes) -> tuple:
+    """Read one request header, return its path and any bytes that follow it."""
+    while b'\r\n\r\n' not in pending:
+        data = conn.recv(4096)
+        if not data:
+            return None, b''
+        pending += data
+    header, _, rest = pending.partition(b'\r\n\r\n')
+    path = header.split(b'\r\n')[0].split(b' ')[1].decode()
+    return path, rest
+
+
+def serve(conn: socket.socket, body: bytes) -> None:
+    """Answer the requests of one connection."""
+    pending = b''
+    with conn:
+        while True:
+            path, pending = read_request(conn, pending)
+            if path is None:
+                return
+            close = path.endswith('/close')
+            header = f'HTTP/1.1 200 OK\r\nContent-Length: {len(body)}\r\nCache-Control: no-store\r\n'
+            header += 'Connection: close\r\n\r\n' if close else '\r\n'
+            conn.sendall(header.encode() + body)
+            if close:
+                return
+
+
+def main() -> None:
+    args = parse_args()
+    body = bytes(i % 251 for i in range(args.size))
+
+    with socket.socket(socket.AF_INET, socket.SOCK_STREAM) as sock:
+        sock.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+        sock.bind(('127.0.0.1', args.port))
+        sock.listen()
+        while True:
+            conn, _ = sock.accept()
+            threading.Thread(target=serve, args=(conn, body), daemon=True).start()
+
+
+if __name__ == '__main__':
+    main()
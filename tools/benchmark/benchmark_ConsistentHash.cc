@@ -0,0 +1,176 @@
+/** @file
+
+  Micro Benchmark tool for ATSConsistentHash lookups - requires Catch2 v2.9.0+
+
+  - e.g. example of 64 nodes with the remap fraction measured over 1M keys
+  ```
+  $ ./benchmark_ConsistentHash --ts-nodes 64 --ts-keys 1000000
+  ```
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+      http://www.apache.org/licenses/LICENSE-2.0
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+
+#include "tscore/ConsistentHash.h"
+#include "tscore/HashSip.h"
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+// Args
+struct Conf {
+  int nodes = 32;
+  int keys  = 100000;
+};
+
+Conf conf;
+
+struct Nodes {
+  std::vector<std::string>           names;
+  std::vector<ATSConsistentHashNode> nodes;
+
+  explicit Nodes(int n) : names(n), nodes(n)
+  {
+    for (int i = 0; i < n; ++i) {
+      names[i]      = "parent" + std::to_string(i) + ".example.com";
+      nodes[i].name = names[i].data();
+    }
+  }
+};
+
+std::unique_ptr<ATSConsistentHash>
+make_hash(Nodes &nodes, ATSConsistentHash::Algorithm algorithm, int skip = -1)
+{
+  auto hash = std::make_unique<ATSConsistentHash>(1024, new ATSHash64Sip24, algorithm);
+
+  for (int i = 0; i < static_cast<int>(nodes.nodes.size()); ++i) {
+    if (i != skip) {
+      hash->insert(&nodes.nodes[i], 1.0);
+    }
+  }
+  return hash;
+}
+
+std::vector<uint64_t>
+make_keys()
+{
+  std::mt19937_64       rng(42);
+  std::vector<uint64_t> keys(conf.keys);
+
+  for (auto &k : keys) {
+    k = rng();
+  }
+  return keys;
+}
+
+uint64_t
+run_lookup(ATSConsistentHash &hash, const std::vector<uint64_t> &keys)
+{
+  uint64_t sum = 0;
+
+  for (auto k : keys) {
+    ATSConsistentHashIter iter = 0;
+    bool                  wrap = false;
+    sum                        += reinterpret_cast<uintptr_t>(hash.lookup_by_hashval(k, &iter, &wrap));
+  }
+  return sum;
+}
+
+// Fraction of @a keys that map to a different node once the last node is removed from the set.
+double
+remapped(Nodes &nodes, ATSConsistentHash::Algorithm algorithm, const std::vector<uint64_t> &keys)
+{
+  auto   full    = make_hash(nodes, algorithm);
+  auto   reduced = make_hash(nodes, algorithm, nodes.nodes.size() - 1);
+  size_t moved   = 0;
+
+  for (auto k : keys) {
+    ATSConsistentHashIter i1 = 0, i2 = 0;
+    bool                  w1 = false, w2 = false;
+    if (full->lookup_by_hashval(k, &i1, &w1) != reduced->lookup_by_hashval(k, &i2, &w2)) {
+      ++moved;
+    }
+  }
+  return static_cast<double>(moved) / keys.size();
+}
+
+} // namespace
+
+TEST_CASE("Micro benchmark of consistent hash lookups", "")
+{
+  Nodes nodes(conf.nodes);
+  auto  keys = make_keys();
+
+  SECTION("ring")
+  {
+    auto hash = make_hash(nodes, ATSConsistentHash::Algorithm::RING);
+
+    BENCHMARK("lookup_by_hashval ring")
+    {
+      return run_lookup(*hash, keys);
+    };
+
+    std::cout << "ring: " << remapped(nodes, ATSConsistentHash::Algorithm::RING, keys) * 100
+              << "% of keys remapped on removal of a node, ideal " << 100.0 / conf.nodes << "%" << std::endl;
+  }
+
+  SECTION("maglev")
+  {
+    auto hash = make_hash(nodes, ATSConsistentHash::Algorithm::MAGLEV);
+
+    BENCHMARK("lookup_by_hashval maglev")
+    {
+      return run_lookup(*hash, keys);
+    };
+
+    std::cout << "maglev: " << remapped(nodes, ATSConsistentHash::Algorithm::MAGLEV, keys) * 100
+              << "% of keys remapped on removal of a node, ideal " << 100.0 / conf.nodes << "%" << std::endl;
+  }
+}
+
+int
+main(int argc, char *argv[])
+{
+  Catch::Session session;
+
+  using namespace Catch::clara;
+
+  // clang-format off
+  auto cli = session.cli() |
+    Opt(conf.nodes, "")["--ts-nodes"]("number of nodes in the hash (default: 32)") |
+    Opt(conf.keys, "")["--ts-keys"]("number of keys looked up per pass (default: 100000)");
+  // clang-format on
+
+  session.cli(cli);
+
+  int returnCode = session.applyCommandLine(argc, argv);
+  if (returnCode != 0) {
+    return returnCode;
+  }
+
+  return session.run();
+}
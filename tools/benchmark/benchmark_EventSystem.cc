@@ -33,11 +33,19 @@
 #include "tscore/Layout.h"
 #include "tscore/TSSystemState.h"
 
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <vector>
+
 namespace
 {
 // Args
-int nevents  = 1;
-int nthreads = 1;
+int  nevents  = 1;
+int  nthreads = 1;
+int  njobs    = 1000;
+int  work_us  = 100;
+bool steal    = false;
 
 std::atomic<int> counter = 0;
 
@@ -56,8 +64,75 @@ struct Task : public Continuation {
     return 0;
   }
 };
+
+// Skewed load: one thread queues all of the jobs, so without work stealing they all run on that thread.
+std::vector<ink_hrtime> job_latency;
+std::atomic<int>        jobs_done = 0;
+
+struct Job : public Continuation {
+  explicit Job(int idx) : Continuation(new_ProxyMutex()), _idx(idx) { SET_HANDLER(&Job::event_handler); }
+
+  int
+  event_handler(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+  {
+    ink_hrtime now    = ink_get_hrtime();
+    job_latency[_idx] = now - queued;
+    // One job in 16 is an order of magnitude longer, like a config reload among small tasks.
+    ink_hrtime until = now + HRTIME_USECONDS(_idx % 16 == 0 ? 10 * work_us : work_us);
+    while (ink_get_hrtime() < until) {
+      ;
+    }
+    ++jobs_done;
+    return 0;
+  }
+
+  ink_hrtime queued = 0;
+  int        _idx;
+};
+
+struct Seeder : public Continuation {
+  explicit Seeder(std::vector<std::unique_ptr<Job>> &jobs) : Continuation(new_ProxyMutex()), _jobs(jobs)
+  {
+    SET_HANDLER(&Seeder::event_handler);
+  }
+
+  int
+  event_handler(int /* event ATS_UNUSED */, Event * /* e ATS_UNUSED */)
+  {
+    for (auto &job : _jobs) {
+      job->queued = ink_get_hrtime();
+      eventProcessor.schedule_imm(job.get(), ET_CALL);
+    }
+    return 0;
+  }
+
+  std::vector<std::unique_ptr<Job>> &_jobs;
+};
 } // namespace
 
+TEST_CASE("skewed load latency", "")
+{
+  REQUIRE(!TSSystemState::is_initializing());
+
+  std::vector<std::unique_ptr<Job>> jobs;
+  for (int i = 0; i < njobs; ++i) {
+    jobs.emplace_back(std::make_unique<Job>(i));
+  }
+  job_latency.assign(njobs, 0);
+  jobs_done = 0;
+
+  Seeder seeder(jobs);
+  eventProcessor.schedule_imm(&seeder, ET_CALL);
+  while (jobs_done < njobs) {
+    usleep(1000);
+  }
+
+  std::sort(job_latency.begin(), job_latency.end());
+  auto pct = [](double p) { return job_latency[static_cast<size_t>(p * (job_latency.size() - 1))] / HRTIME_USECOND; };
+  std::cout << "njobs = " << njobs << " nthreads = " << nthreads << " work = " << work_us << "us steal = " << steal
+            << ": queue latency p50 " << pct(0.5) << "us p99 " << pct(0.99) << "us max " << pct(1.0) << "us" << std::endl;
+}
+
 TEST_CASE("event process benchmark", "")
 {
   char name[64];
@@ -89,6 +164,7 @@ struct EventProcessorListener : Catch::TestEventListenerBase {
     RecProcessInit();
 
     ink_event_system_init(EVENT_SYSTEM_MODULE_PUBLIC_VERSION);
+    eventProcessor.thread_group[ET_CALL]._work_stealing = steal;
     eventProcessor.start(nthreads, 1048576); // Hardcoded stacksize at 1MB
 
     EThread *main_thread = new EThread;
@@ -108,7 +184,10 @@ main(int argc, char *argv[])
   using namespace Catch::clara;
 
   auto cli = session.cli() | Opt(nevents, "n")["--ts-nevents"]("number of events (default: 1)\n") |
-             Opt(nthreads, "n")["--ts-nthreads"]("number of ethreads (default: 1)\n");
+             Opt(nthreads, "n")["--ts-nthreads"]("number of ethreads (default: 1)\n") |
+             Opt(njobs, "n")["--ts-njobs"]("number of jobs queued by one thread in the skewed load test (default: 1000)\n") |
+             Opt(work_us, "us")["--ts-work-us"]("busy time of a job in microseconds (default: 100)\n") |
+             Opt(steal)["--ts-steal"]("let idle ethreads steal events from busy ones\n");
 
   session.cli(cli);
 
@@ -24,6 +24,7 @@
 
 #include "catch.hpp"
 
+#include "tscore/Allocator.h"
 #include "tscore/ink_hw.h"
 #include "tscore/ink_thread.h"
 #include "tscore/ink_memory.h"
@@ -164,6 +165,77 @@ setup_test_case_1(const int64_t n)
   }
 }
 
+// Blocks are allocated one at a time and freed in bulk, as a thread local free list does when the
+// blocks it allocates are freed on another thread.
+constexpr int BULK = 480;
+
+void *
+test_case_2(void *d)
+{
+  int   id = (intptr_t)d;
+  void *head;
+  void *tail;
+
+  for (int i = 0; i < nloop / BULK; ++i) {
+    head = tail = ink_freelist_new(flist);
+    for (int j = 1; j < BULK; ++j) {
+      void *m1                  = ink_freelist_new(flist);
+      *static_cast<void **>(m1) = head;
+      head                      = m1;
+    }
+    memset(head, id, 64);
+
+    ink_freelist_free_bulk(flist, head, tail, BULK);
+  }
+
+  return nullptr;
+}
+
+FreelistAllocator *magazine_allocator = nullptr;
+
+// The same with whole magazines handed over through the allocator depot.
+void *
+test_case_3(void *d)
+{
+  int   id = (intptr_t)d;
+  void *head;
+  void *tail;
+
+  for (int i = 0; i < nloop / BULK; ++i) {
+    size_t n = magazine_allocator->alloc_void_bulk(&head);
+    if (n == 0) {
+      head = tail = magazine_allocator->alloc_void();
+      for (n = 1; n < BULK; ++n) {
+        void *m1                  = magazine_allocator->alloc_void();
+        *static_cast<void **>(m1) = head;
+        head                      = m1;
+      }
+    } else {
+      for (tail = head; *static_cast<void **>(tail) != nullptr;) {
+        tail = *static_cast<void **>(tail);
+      }
+    }
+    memset(head, id, 64);
+
+    magazine_allocator->free_void_bulk(head, tail, n);
+  }
+
+  return nullptr;
+}
+
+void
+run_threads(void *(*f)(void *), const int64_t n)
+{
+  ink_thread list[n];
+
+  for (int i = 0; i < n; i++) {
+    ink_thread_create(&list[i], f, (void *)((intptr_t)i), 0, 0, nullptr);
+  }
+  for (int i = 0; i < n; i++) {
+    ink_thread_join(list[i]);
+  }
+}
+
 TEST_CASE("simple new and free", "")
 {
   flist = ink_freelist_create("woof", 64, 256, 8);
@@ -176,6 +248,25 @@ TEST_CASE("simple new and free", "")
     return setup_test_case_1(nthreads);
   };
 }
+
+TEST_CASE("new and bulk free", "")
+{
+  flist              = ink_freelist_create("bulk", 64, 256, 8);
+  magazine_allocator = new FreelistAllocator("magazine", 64, 256, 8);
+
+  char name[32];
+  snprintf(name, sizeof(name), "freelist nthreads = %d", nthreads);
+  BENCHMARK(name)
+  {
+    return run_threads(test_case_2, nthreads);
+  };
+
+  snprintf(name, sizeof(name), "magazine nthreads = %d", nthreads);
+  BENCHMARK(name)
+  {
+    return run_threads(test_case_3, nthreads);
+  };
+}
 } // namespace
 
 int
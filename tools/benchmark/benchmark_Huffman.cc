@@ -0,0 +1,186 @@
+/** @file
+
+  Micro Benchmark tool for the HPACK/QPACK Huffman codec - requires Catch2 v2.9.0+
+
+  - e.g. example of running the codec over 10000 copies of the sample header values
+  ```
+  $ ./benchmark_Huffman --ts-nloop 10000
+  ```
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+      http://www.apache.org/licenses/LICENSE-2.0
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+
+#include "proxy/hdrs/HuffmanCodec.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+// Args
+struct Conf {
+  int nloop = 1000;
+};
+
+Conf conf;
+
+// A mix of typical request and response header values
+const std::string_view samples[] = {
+  "www.example.com",
+  "/assets/js/vendor.min.js?v=20240101",
+  "Mozilla/5.0 (X11; Linux x86_64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36",
+  "text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8",
+  "gzip, deflate, br",
+  "en-US,en;q=0.9",
+  "max-age=31536000, public, immutable",
+  "Mon, 21 Oct 2013 20:13:21 GMT",
+  "\"5f3e1a2b-1c4d\"",
+  "session=0123456789abcdef0123456789abcdef; Path=/; Secure; HttpOnly",
+  "application/json; charset=utf-8",
+  "private",
+  "302",
+};
+
+struct Corpus {
+  std::vector<std::vector<uint8_t>> plain;
+  std::vector<std::vector<uint8_t>> encoded;
+  size_t                            plain_bytes   = 0;
+  size_t                            encoded_bytes = 0;
+};
+
+Corpus
+make_corpus()
+{
+  Corpus corpus;
+
+  for (auto s : samples) {
+    std::vector<uint8_t> plain(s.begin(), s.end());
+    std::vector<uint8_t> encoded(s.size() * 4 + 4);
+
+    encoded.resize(huffman_encode(encoded.data(), plain.data(), plain.size()));
+    corpus.plain_bytes   += plain.size();
+    corpus.encoded_bytes += encoded.size();
+    corpus.plain.push_back(std::move(plain));
+    corpus.encoded.push_back(std::move(encoded));
+  }
+
+  return corpus;
+}
+
+int64_t
+run_decode(const Corpus &corpus)
+{
+  char    dst[1024];
+  int64_t total = 0;
+
+  for (int i = 0; i < conf.nloop; ++i) {
+    for (auto &e : corpus.encoded) {
+      total += huffman_decode(dst, e.data(), e.size());
+    }
+  }
+
+  return total;
+}
+
+int64_t
+run_encode(const Corpus &corpus)
+{
+  uint8_t dst[1024];
+  int64_t total = 0;
+
+  for (int i = 0; i < conf.nloop; ++i) {
+    for (auto &p : corpus.plain) {
+      total += huffman_encode(dst, p.data(), p.size());
+    }
+  }
+
+  return total;
+}
+
+template <typename F>
+void
+report(const char *name, size_t bytes, F &&f)
+{
+  auto start = std::chrono::steady_clock::now();
+  f();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  std::cout << name << ": " << (bytes * conf.nloop) / elapsed.count() / (1024 * 1024) << " MiB/s" << std::endl;
+}
+
+} // namespace
+
+TEST_CASE("Micro benchmark of Huffman codec", "")
+{
+  hpack_huffman_init();
+
+  Corpus corpus = make_corpus();
+
+  SECTION("huffman_decode")
+  {
+    BENCHMARK("huffman_decode")
+    {
+      return run_decode(corpus);
+    };
+
+    // Throughput is measured on the encoded (wire) bytes
+    report("huffman_decode", corpus.encoded_bytes, [&corpus]() { return run_decode(corpus); });
+  }
+
+  SECTION("huffman_encode")
+  {
+    BENCHMARK("huffman_encode")
+    {
+      return run_encode(corpus);
+    };
+
+    // Throughput is measured on the plain bytes
+    report("huffman_encode", corpus.plain_bytes, [&corpus]() { return run_encode(corpus); });
+  }
+
+  hpack_huffman_fin();
+}
+
+int
+main(int argc, char *argv[])
+{
+  Catch::Session session;
+
+  using namespace Catch::clara;
+
+  // clang-format off
+  auto cli = session.cli() |
+    Opt(conf.nloop, "")["--ts-nloop"]("number of passes over the sample header values (default: 1000)");
+  // clang-format on
+
+  session.cli(cli);
+
+  int returnCode = session.applyCommandLine(argc, argv);
+  if (returnCode != 0) {
+    return returnCode;
+  }
+
+  return session.run();
+}
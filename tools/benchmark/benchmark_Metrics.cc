@@ -0,0 +1,128 @@
+/** @file
+
+  Micro Benchmark tool for ts::Metrics counters - requires Catch2 v2.9.0+
+
+  - e.g. example of running 64 threads, each incrementing the counter 100000 times
+  ```
+  $ taskset -c 0-63 ./benchmark_Metrics --ts-nthreads 64 --ts-nloop 100000
+  ```
+
+  @section license License
+
+  Licensed to the Apache Software Foundation (ASF) under one
+  or more contributor license agreements.  See the NOTICE file
+  distributed with this work for additional information
+  regarding copyright ownership.  The ASF licenses this file
+  to you under the Apache License, Version 2.0 (the
+  "License"); you may not use this file except in compliance
+  with the License.  You may obtain a copy of the License at
+      http://www.apache.org/licenses/LICENSE-2.0
+  Unless required by applicable law or agreed to in writing, software
+  distributed under the License is distributed on an "AS IS" BASIS,
+  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+  See the License for the specific language governing permissions and
+  limitations under the License.
+ */
+
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#define CATCH_CONFIG_RUNNER
+
+#include "catch.hpp"
+
+#include "tsutil/Metrics.h"
+
+#include <thread>
+#include <vector>
+
+using ts::Metrics;
+
+namespace
+{
+// Args
+struct Conf {
+  int nloop    = 1;
+  int nthreads = 1;
+};
+
+Conf conf;
+
+template <typename M, typename T>
+int64_t
+run(T *metric)
+{
+  std::vector<std::thread> list;
+
+  for (int i = 0; i < conf.nthreads; i++) {
+    list.emplace_back([metric]() {
+      for (int j = 0; j < conf.nloop; ++j) {
+        M::increment(metric);
+      }
+    });
+  }
+
+  for (auto &t : list) {
+    t.join();
+  }
+
+  return M::load(metric);
+}
+
+} // namespace
+
+TEST_CASE("Micro benchmark of Metrics counters", "")
+{
+  SECTION("Metrics::Counter")
+  {
+    auto metric = Metrics::Counter::createPtr("benchmark.counter");
+
+    BENCHMARK("Metrics::Counter")
+    {
+      return run<Metrics::Counter>(metric);
+    };
+  }
+
+  SECTION("Metrics::ShardedCounter")
+  {
+    auto metric = Metrics::ShardedCounter::createPtr("benchmark.sharded_counter");
+
+    BENCHMARK("Metrics::ShardedCounter")
+    {
+      return run<Metrics::ShardedCounter>(metric);
+    };
+  }
+
+  SECTION("Metrics::ShardedCounter::sync")
+  {
+    for (int i = 0; i < 1024; ++i) {
+      Metrics::ShardedCounter::createPtr("benchmark.sharded_counter.", std::to_string(i));
+    }
+
+    BENCHMARK("Metrics::ShardedCounter::sync (1024 counters)")
+    {
+      return Metrics::ShardedCounter::sync();
+    };
+  }
+}
+
+int
+main(int argc, char *argv[])
+{
+  Catch::Session session;
+
+  using namespace Catch::clara;
+
+  // clang-format off
+  auto cli = session.cli() |
+    Opt(conf.nthreads, "")["--ts-nthreads"]("number of threads (default: 1)") |
+    Opt(conf.nloop, "")["--ts-nloop"]("number of increments per thread (default: 1)");
+  // clang-format on
+
+  session.cli(cli);
+
+  int returnCode = session.applyCommandLine(argc, argv);
+  if (returnCode != 0) {
+    return returnCode;
+  }
+
+  return session.run();
+}
@@ -109,3 +109,33 @@ TEST_CASE("ProxyAllocator", "[iocore]")
 
   delete bench_thread;
 }
+
+TEST_CASE("ProxyAllocator cross thread", "[iocore]")
+{
+  // Blocks are allocated from the free list of one thread and freed to another, like IOBufferBlocks
+  // created by a net thread and released by a cache or task thread.
+  Thread *alloc_thread = new BThread();
+  Thread *free_thread  = new BThread();
+  alloc_thread->set_specific();
+  int count = 10000;
+
+  thread_freelist_high_watermark = 512;
+  thread_freelist_low_watermark  = 32;
+
+  BENCHMARK("thread_alloc on one thread, thread_free on another")
+  {
+    auto items = std::vector<BItem *>();
+    items.reserve(count);
+    for (int i = 0; i < count; i++) {
+      items.push_back(THREAD_ALLOC(ioAllocator, alloc_thread));
+    }
+
+    for (auto item : items) {
+      THREAD_FREE(item, ioAllocator, free_thread);
+    }
+    return free_thread->ioAllocator.allocated;
+  };
+
+  delete free_thread;
+  delete alloc_thread;
+}